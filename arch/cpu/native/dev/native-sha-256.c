@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup native_platform
+ * @{
+ *
+ * \file
+ *       SHA-256 driver of the native platform.
+ */
+
+#include "dev/native-sha-256.h"
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define WITH_SHA_NI 1
+#else /* defined(__x86_64__) || defined(__i386__) */
+#define WITH_SHA_NI 0
+#endif /* defined(__x86_64__) || defined(__i386__) */
+
+static sha_256_transform_t transform;
+
+#if WITH_SHA_NI
+static const uint32_t K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/*---------------------------------------------------------------------------*/
+static bool
+has_sha_ni(void)
+{
+  unsigned int eax, ebx, ecx, edx;
+
+  return __get_cpuid(1, &eax, &ebx, &ecx, &edx)
+         && (ecx & bit_SSE4_1)
+         && __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)
+         && (ebx & bit_SHA);
+}
+/*---------------------------------------------------------------------------*/
+__attribute__((target("sha,sse4.1")))
+static void
+transform_with_sha_ni(const uint8_t *blocks, size_t count)
+{
+  const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+                                           0x0405060700010203ULL);
+  __m128i abef;
+  __m128i cdgh;
+  __m128i tmp;
+  __m128i w[4];
+
+  /* the instructions expect the state as ABEF and CDGH */
+  tmp = _mm_shuffle_epi32(
+      _mm_loadu_si128((const __m128i *)&sha_256_checkpoint.state[0]), 0xB1);
+  cdgh = _mm_shuffle_epi32(
+      _mm_loadu_si128((const __m128i *)&sha_256_checkpoint.state[4]), 0x1B);
+  abef = _mm_alignr_epi8(tmp, cdgh, 8);
+  cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);
+
+  while(count--) {
+    __m128i abef_before = abef;
+    __m128i cdgh_before = cdgh;
+
+    for(int i = 0; i < 16; i++) {
+      if(i < 4) {
+        w[i] = _mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *)(blocks + 16 * i)), byte_swap);
+      } else {
+        /* W[t - 16] + s0(W[t - 15]) + W[t - 7] + s1(W[t - 2]) */
+        tmp = _mm_sha256msg1_epu32(w[i % 4], w[(i + 1) % 4]);
+        tmp = _mm_add_epi32(tmp,
+                            _mm_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4));
+        w[i % 4] = _mm_sha256msg2_epu32(tmp, w[(i + 3) % 4]);
+      }
+      tmp = _mm_add_epi32(w[i % 4],
+                          _mm_loadu_si128((const __m128i *)&K[4 * i]));
+      cdgh = _mm_sha256rnds2_epu32(cdgh, abef, tmp);
+      abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(tmp, 0x0E));
+    }
+
+    abef = _mm_add_epi32(abef, abef_before);
+    cdgh = _mm_add_epi32(cdgh, cdgh_before);
+    blocks += SHA_256_BLOCK_SIZE;
+  }
+
+  /* back to ABCD and EFGH */
+  tmp = _mm_shuffle_epi32(abef, 0x1B);
+  cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+  _mm_storeu_si128((__m128i *)&sha_256_checkpoint.state[0],
+                   _mm_blend_epi16(tmp, cdgh, 0xF0));
+  _mm_storeu_si128((__m128i *)&sha_256_checkpoint.state[4],
+                   _mm_alignr_epi8(cdgh, tmp, 8));
+}
+#endif /* WITH_SHA_NI */
+/*---------------------------------------------------------------------------*/
+static sha_256_transform_t
+get_transform(void)
+{
+  if(!transform) {
+#if WITH_SHA_NI
+    transform = has_sha_ni() ? transform_with_sha_ni : sha_256_transform;
+#else /* WITH_SHA_NI */
+    transform = sha_256_transform;
+#endif /* WITH_SHA_NI */
+  }
+  return transform;
+}
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+  sha_256_driver.init();
+}
+/*---------------------------------------------------------------------------*/
+static void
+update(const uint8_t *data, size_t len)
+{
+  sha_256_update_with_transform(data, len, get_transform());
+}
+/*---------------------------------------------------------------------------*/
+static void
+cancel(void)
+{
+  sha_256_driver.cancel();
+}
+/*---------------------------------------------------------------------------*/
+static bool
+finalize(uint8_t digest[static SHA_256_DIGEST_LENGTH])
+{
+  return sha_256_finalize_with_transform(digest, get_transform());
+}
+/*---------------------------------------------------------------------------*/
+static void
+create_checkpoint(sha_256_checkpoint_t *checkpoint)
+{
+  sha_256_driver.create_checkpoint(checkpoint);
+}
+/*---------------------------------------------------------------------------*/
+static void
+restore_checkpoint(const sha_256_checkpoint_t *checkpoint)
+{
+  sha_256_driver.restore_checkpoint(checkpoint);
+}
+/*---------------------------------------------------------------------------*/
+const struct sha_256_driver native_sha_256_driver = {
+  init,
+  update,
+  cancel,
+  finalize,
+  create_checkpoint,
+  restore_checkpoint,
+  sha_256_hash,
+};
+/*---------------------------------------------------------------------------*/
+
+/** @} */
@@ -218,6 +218,7 @@ exit:
 const struct aes_128_driver cc_aes_128_driver = {
   set_key,
   encrypt,
+  aes_128_encrypt_blocks_one_by_one,
   aes_128_get_lock,
   aes_128_release_lock
 };
@@ -102,6 +102,14 @@ typedef unsigned int uip_stats_t;
 #define PLATFORM_CONF_MAIN_ACCEPTS_ARGS  1
 #define PLATFORM_CONF_SUPPORTS_STACK_CHECK 0
 
+#ifndef AES_128_CONF_WITH_TABLES
+#define AES_128_CONF_WITH_TABLES 1
+#endif /* AES_128_CONF_WITH_TABLES */
+
+#ifndef SHA_256_CONF
+#define SHA_256_CONF native_sha_256_driver
+#endif /* SHA_256_CONF */
+
 #ifndef CSPRNG_CONF_ENABLED
 #define CSPRNG_CONF_ENABLED 1
 #endif /* CSPRNG_CONF_ENABLED */
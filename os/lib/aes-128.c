@@ -83,7 +83,39 @@ static const uint8_t sbox[256] = {
   0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68,
   0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
 };
-static uint8_t round_keys[11][AES_128_KEY_LENGTH];
+struct key_schedule {
+  uint8_t round_keys[11][AES_128_KEY_LENGTH];
+#if AES_128_CONF_WITH_TABLES
+  uint32_t round_key_words[11][4];
+#endif /* AES_128_CONF_WITH_TABLES */
+#if AES_128_CONF_KEY_CACHE_SIZE
+  const uint8_t *key_address; /* where the caller stores the key */
+  uint32_t last_use; /* 0 if unused */
+#endif /* AES_128_CONF_KEY_CACHE_SIZE */
+};
+#if AES_128_CONF_KEY_CACHE_SIZE
+/* The cache is set-associative. Keys are looked up by the address where
+ * the caller stores them, e.g., in a neighbor entry, so that the lookup
+ * does not depend on secret data */
+#if AES_128_CONF_KEY_CACHE_SIZE < 4
+#define KEY_CACHE_WAYS AES_128_CONF_KEY_CACHE_SIZE
+#else /* AES_128_CONF_KEY_CACHE_SIZE < 4 */
+#define KEY_CACHE_WAYS 4
+#endif /* AES_128_CONF_KEY_CACHE_SIZE < 4 */
+#define KEY_CACHE_SETS (AES_128_CONF_KEY_CACHE_SIZE / KEY_CACHE_WAYS)
+/* Expanded keys of the most recently used keys */
+static struct key_schedule key_cache[KEY_CACHE_SETS * KEY_CACHE_WAYS];
+static uint32_t key_cache_clock;
+static struct key_schedule *schedule = key_cache;
+#else /* AES_128_CONF_KEY_CACHE_SIZE */
+static struct key_schedule current_schedule;
+static struct key_schedule *const schedule = &current_schedule;
+#endif /* AES_128_CONF_KEY_CACHE_SIZE */
+#if AES_128_CONF_WITH_TABLES
+/* te0[x] holds the MixColumn of the column (sbox[x], 0, 0, 0), the other
+ * three byte positions are rotations thereof */
+static uint32_t te0[256];
+#endif /* AES_128_CONF_WITH_TABLES */
 #if AES_128_CONF_WITH_LOCKING
 static mutex_t lock;
 #endif /* AES_128_CONF_WITH_LOCKING */
@@ -96,10 +128,50 @@ galois_mul2(uint8_t value)
   uint8_t xor_val = (value >> 7) * 0x1b;
   return (value << 1) ^ xor_val;
 }
+#if AES_128_CONF_WITH_TABLES
 /*---------------------------------------------------------------------------*/
-static bool
-set_key(const uint8_t key[static AES_128_KEY_LENGTH])
+static uint32_t
+load_word(const uint8_t *bytes)
+{
+  return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16)
+         | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+/*---------------------------------------------------------------------------*/
+static void
+store_word(uint8_t *bytes, uint32_t word)
 {
+  bytes[0] = word >> 24;
+  bytes[1] = word >> 16;
+  bytes[2] = word >> 8;
+  bytes[3] = word;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+rotate_right(uint32_t word, uint_fast8_t bits)
+{
+  return (word >> bits) | (word << (32 - bits));
+}
+/*---------------------------------------------------------------------------*/
+/* SubBytes, ShiftRows, and MixColumns for the column that starts at row 0
+ * with the byte of column a */
+#define TABLE_COLUMN(a, b, c, d) \
+  (te0[(a) >> 24] \
+   ^ rotate_right(te0[((b) >> 16) & 0xff], 8) \
+   ^ rotate_right(te0[((c) >> 8) & 0xff], 16) \
+   ^ rotate_right(te0[(d) & 0xff], 24))
+/* SubBytes and ShiftRows for the column that starts with the byte of
+ * column a */
+#define SBOX_COLUMN(a, b, c, d) \
+  (((uint32_t)sbox[(a) >> 24] << 24) \
+   | ((uint32_t)sbox[((b) >> 16) & 0xff] << 16) \
+   | ((uint32_t)sbox[((c) >> 8) & 0xff] << 8) \
+   | sbox[(d) & 0xff])
+#endif /* AES_128_CONF_WITH_TABLES */
+/*---------------------------------------------------------------------------*/
+static void
+expand_key(struct key_schedule *ks, const uint8_t key[static AES_128_KEY_LENGTH])
+{
+  uint8_t (*round_keys)[AES_128_KEY_LENGTH] = ks->round_keys;
   uint8_t i;
   uint8_t j;
   uint8_t rcon;
@@ -117,12 +189,118 @@ set_key(const uint8_t key[static AES_128_KEY_LENGTH])
     }
     rcon = galois_mul2(rcon);
   }
+#if AES_128_CONF_WITH_TABLES
+  if(!te0[0]) {
+    for(i = 0; ; i++) {
+      uint8_t s = sbox[i];
+      te0[i] = ((uint32_t)galois_mul2(s) << 24) | ((uint32_t)s << 16)
+               | ((uint32_t)s << 8) | (galois_mul2(s) ^ s);
+      if(i == 0xff) {
+        break;
+      }
+    }
+  }
+  for(i = 0; i <= 10; i++) {
+    for(j = 0; j < 4; j++) {
+      ks->round_key_words[i][j] = load_word(round_keys[i] + 4 * j);
+    }
+  }
+#endif /* AES_128_CONF_WITH_TABLES */
+}
+#if AES_128_CONF_KEY_CACHE_SIZE
+/*---------------------------------------------------------------------------*/
+static struct key_schedule *
+get_set(const uint8_t *key_address)
+{
+  uintptr_t hash = (uintptr_t)key_address;
+
+  hash ^= hash >> 5;
+  hash ^= hash >> 11;
+  return key_cache + (hash % KEY_CACHE_SETS) * KEY_CACHE_WAYS;
+}
+/*---------------------------------------------------------------------------*/
+/* Compares in constant time */
+static bool
+keys_equal(const uint8_t a[static AES_128_KEY_LENGTH],
+           const uint8_t b[static AES_128_KEY_LENGTH])
+{
+  uint8_t difference = 0;
+
+  for(size_t i = 0; i < AES_128_KEY_LENGTH; i++) {
+    difference |= a[i] ^ b[i];
+  }
+  return !difference;
+}
+#endif /* AES_128_CONF_KEY_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
+static bool
+set_key(const uint8_t key[static AES_128_KEY_LENGTH])
+{
+#if AES_128_CONF_KEY_CACHE_SIZE
+  struct key_schedule *set = get_set(key);
+  struct key_schedule *least_recently_used = set;
+
+  key_cache_clock++;
+  for(size_t i = 0; i < KEY_CACHE_WAYS; i++) {
+    if(set[i].last_use && set[i].key_address == key) {
+      schedule = set + i;
+      schedule->last_use = key_cache_clock;
+      /* the caller may have stored another key at the same address */
+      if(!keys_equal(schedule->round_keys[0], key)) {
+        expand_key(schedule, key);
+      }
+      return true;
+    }
+    if(set[i].last_use < least_recently_used->last_use) {
+      least_recently_used = set + i;
+    }
+  }
+  schedule = least_recently_used;
+  schedule->key_address = key;
+  schedule->last_use = key_cache_clock;
+#endif /* AES_128_CONF_KEY_CACHE_SIZE */
+  expand_key(schedule, key);
   return true;
 }
+#if AES_128_CONF_WITH_TABLES
 /*---------------------------------------------------------------------------*/
 static bool
 encrypt(uint8_t state[static AES_128_BLOCK_SIZE])
 {
+  const uint32_t (*round_key_words)[4] = schedule->round_key_words;
+  uint32_t s0, s1, s2, s3;
+  uint32_t t0, t1, t2, t3;
+  uint_fast8_t round;
+
+  s0 = load_word(state) ^ round_key_words[0][0];
+  s1 = load_word(state + 4) ^ round_key_words[0][1];
+  s2 = load_word(state + 8) ^ round_key_words[0][2];
+  s3 = load_word(state + 12) ^ round_key_words[0][3];
+
+  for(round = 1; round < 10; round++) {
+    t0 = TABLE_COLUMN(s0, s1, s2, s3) ^ round_key_words[round][0];
+    t1 = TABLE_COLUMN(s1, s2, s3, s0) ^ round_key_words[round][1];
+    t2 = TABLE_COLUMN(s2, s3, s0, s1) ^ round_key_words[round][2];
+    t3 = TABLE_COLUMN(s3, s0, s1, s2) ^ round_key_words[round][3];
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+  }
+
+  /* last round skips MixColumn */
+  store_word(state, SBOX_COLUMN(s0, s1, s2, s3) ^ round_key_words[10][0]);
+  store_word(state + 4, SBOX_COLUMN(s1, s2, s3, s0) ^ round_key_words[10][1]);
+  store_word(state + 8, SBOX_COLUMN(s2, s3, s0, s1) ^ round_key_words[10][2]);
+  store_word(state + 12, SBOX_COLUMN(s3, s0, s1, s2) ^ round_key_words[10][3]);
+  return true;
+}
+#else /* AES_128_CONF_WITH_TABLES */
+/*---------------------------------------------------------------------------*/
+static bool
+encrypt(uint8_t state[static AES_128_BLOCK_SIZE])
+{
+  const uint8_t (*round_keys)[AES_128_KEY_LENGTH] = schedule->round_keys;
   uint8_t buf1, buf2, buf3, buf4, round, i;
 
   /* round 0 */
@@ -190,6 +368,17 @@ encrypt(uint8_t state[static AES_128_BLOCK_SIZE])
   }
   return true;
 }
+#endif /* AES_128_CONF_WITH_TABLES */
+/*---------------------------------------------------------------------------*/
+static bool
+encrypt_blocks(uint8_t *plaintexts_and_results, size_t count)
+{
+  while(count--) {
+    encrypt(plaintexts_and_results);
+    plaintexts_and_results += AES_128_BLOCK_SIZE;
+  }
+  return true;
+}
 /*---------------------------------------------------------------------------*/
 bool
 aes_128_get_lock(void)
@@ -209,9 +398,62 @@ aes_128_release_lock(void)
 #endif /* AES_128_CONF_WITH_LOCKING */
 }
 /*---------------------------------------------------------------------------*/
+bool
+aes_128_encrypt_blocks_one_by_one(uint8_t *plaintexts_and_results,
+                                  size_t count)
+{
+  while(count--) {
+    if(!AES_128.encrypt(plaintexts_and_results)) {
+      return false;
+    }
+    plaintexts_and_results += AES_128_BLOCK_SIZE;
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static void
+increment_counter(uint8_t counter[static AES_128_BLOCK_SIZE])
+{
+  uint_fast8_t i = AES_128_BLOCK_SIZE;
+  while(i-- && !++counter[i]);
+}
+/*---------------------------------------------------------------------------*/
+bool
+aes_128_ctr(uint8_t counter[static AES_128_BLOCK_SIZE],
+            uint8_t *m_and_result, size_t m_len)
+{
+  uint8_t key_stream[AES_128_CONF_CTR_BATCH_SIZE * AES_128_BLOCK_SIZE];
+
+  while(m_len) {
+    size_t blocks = 0;
+    size_t len;
+
+    /* fill a batch with consecutive counter blocks */
+    while((blocks < AES_128_CONF_CTR_BATCH_SIZE)
+          && (blocks * AES_128_BLOCK_SIZE < m_len)) {
+      memcpy(key_stream + blocks * AES_128_BLOCK_SIZE,
+             counter, AES_128_BLOCK_SIZE);
+      increment_counter(counter);
+      blocks++;
+    }
+    if(!AES_128.encrypt_blocks(key_stream, blocks)) {
+      return false;
+    }
+
+    len = MIN(m_len, blocks * AES_128_BLOCK_SIZE);
+    for(size_t i = 0; i < len; i++) {
+      m_and_result[i] ^= key_stream[i];
+    }
+    m_and_result += len;
+    m_len -= len;
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
 const struct aes_128_driver aes_128_driver = {
   set_key,
   encrypt,
+  encrypt_blocks,
   aes_128_get_lock,
   aes_128_release_lock
 };
@@ -44,6 +44,7 @@
 
 #include "contiki.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #define AES_128_BLOCK_SIZE 16
@@ -59,6 +60,25 @@
 #define AES_128_CONF_WITH_LOCKING 0
 #endif /* AES_128_CONF_WITH_LOCKING */
 
+/* Use 1 KB of lookup tables to speed up the software implementation */
+#ifndef AES_128_CONF_WITH_TABLES
+#define AES_128_CONF_WITH_TABLES 0
+#endif /* AES_128_CONF_WITH_TABLES */
+
+/* Number of expanded keys that the software implementation keeps, so that
+ * switching back to a recently used key skips the key expansion. Keys are
+ * cached by the address at which they are passed to set_key(), e.g., the
+ * pairwise key of a neighbor. Should be a multiple of 4. 0 keeps only the
+ * current key */
+#ifndef AES_128_CONF_KEY_CACHE_SIZE
+#define AES_128_CONF_KEY_CACHE_SIZE 0
+#endif /* AES_128_CONF_KEY_CACHE_SIZE */
+
+/* Number of blocks that aes_128_ctr() passes to encrypt_blocks at once */
+#ifndef AES_128_CONF_CTR_BATCH_SIZE
+#define AES_128_CONF_CTR_BATCH_SIZE 4
+#endif /* AES_128_CONF_CTR_BATCH_SIZE */
+
 /**
  * Structure of AES drivers.
  */
@@ -76,6 +96,14 @@ struct aes_128_driver {
    */
   bool (* encrypt)(uint8_t plaintext_and_result[static AES_128_BLOCK_SIZE]);
 
+  /**
+   * \brief Encrypts consecutive blocks independently of each other (ECB).
+   * \param plaintexts_and_results count * AES_128_BLOCK_SIZE bytes
+   * \param count The number of blocks
+   * \return True on success.
+   */
+  bool (* encrypt_blocks)(uint8_t *plaintexts_and_results, size_t count);
+
   /**
    * \brief Reserves exclusive access.
    */
@@ -92,6 +120,25 @@ extern const struct aes_128_driver AES_128;
 bool aes_128_get_lock(void);
 void aes_128_release_lock(void);
 
+/**
+ * \brief Implements encrypt_blocks by calling AES_128.encrypt per block.
+ *        For drivers that cannot do better.
+ */
+bool aes_128_encrypt_blocks_one_by_one(uint8_t *plaintexts_and_results,
+                                       size_t count);
+
+/**
+ * \brief Encrypts or decrypts in counter mode with AES_128.
+ * \param counter The initial counter block. On return, it holds the counter
+ *                block that follows the last one used. The counter is
+ *                incremented as a big-endian integer.
+ * \param m_and_result The data to XOR with the key stream.
+ * \param m_len The length of the data.
+ * \return True on success.
+ */
+bool aes_128_ctr(uint8_t counter[static AES_128_BLOCK_SIZE],
+                 uint8_t *m_and_result, size_t m_len);
+
 #endif /* AES_128_H_ */
 
 /** @} */
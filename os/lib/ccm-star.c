@@ -63,26 +63,6 @@ set_iv(uint8_t iv[static AES_128_BLOCK_SIZE],
   iv[15] = counter;
 }
 /*---------------------------------------------------------------------------*/
-/* XORs the block m[pos] ... m[pos + 15] with K_{counter} */
-static bool
-ctr_step(const uint8_t nonce[static CCM_STAR_NONCE_LENGTH],
-         uint16_t pos,
-         uint8_t *m_and_result, uint16_t m_len,
-         uint16_t counter)
-{
-  uint8_t a[AES_128_BLOCK_SIZE];
-
-  set_iv(a, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter);
-  if(!AES_128.encrypt(a)) {
-    return false;
-  }
-
-  for(uint_fast8_t i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-    m_and_result[pos + i] ^= a[i];
-  }
-  return true;
-}
-/*---------------------------------------------------------------------------*/
 static bool
 mic(const uint8_t nonce[static CCM_STAR_NONCE_LENGTH],
     const uint8_t *m, uint16_t m_len,
@@ -90,6 +70,7 @@ mic(const uint8_t nonce[static CCM_STAR_NONCE_LENGTH],
     uint8_t *mic, uint8_t mic_len)
 {
   uint8_t x[AES_128_BLOCK_SIZE];
+  uint8_t counter[AES_128_BLOCK_SIZE];
 
   set_iv(x, CCM_STAR_AUTH_FLAGS(a_len, mic_len), nonce, m_len);
   if(!AES_128.encrypt(x)) {
@@ -135,7 +116,9 @@ mic(const uint8_t nonce[static CCM_STAR_NONCE_LENGTH],
     }
   }
 
-  if(!ctr_step(nonce, 0, x, AES_128_BLOCK_SIZE, 0)) {
+  /* encrypt the MIC with K_0 */
+  set_iv(counter, CCM_STAR_ENCRYPTION_FLAGS, nonce, 0);
+  if(!aes_128_ctr(counter, x, mic_len)) {
     return false;
   }
 
@@ -147,14 +130,11 @@ static bool
 ctr(const uint8_t nonce[static CCM_STAR_NONCE_LENGTH],
     uint8_t *m, uint16_t m_len)
 {
-  uint16_t counter = 1;
-  /* 32-bit pos to reach the end of the loop if m_len is large */
-  for(uint32_t pos = 0; pos < m_len; pos += AES_128_BLOCK_SIZE) {
-    if(!ctr_step(nonce, pos, m, m_len, counter++)) {
-      return false;
-    }
-  }
-  return true;
+  uint8_t counter[AES_128_BLOCK_SIZE];
+
+  /* XOR the whole message with K_1, K_2, ... */
+  set_iv(counter, CCM_STAR_ENCRYPTION_FLAGS, nonce, 1);
+  return aes_128_ctr(counter, m, m_len);
 }
 /*---------------------------------------------------------------------------*/
 static bool
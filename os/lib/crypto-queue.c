@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup crypto
+ * @{
+ * \file
+ *         Queue of cryptographic jobs.
+ */
+
+#include "lib/crypto-queue.h"
+#include "lib/list.h"
+
+/* Log configuration */
+#include "sys/log.h"
+#define LOG_MODULE "Crypto"
+#define LOG_LEVEL LOG_LEVEL_NONE
+
+PROCESS(crypto_queue_process, "crypto_queue_process");
+LIST(pending_jobs);
+/* jobs of the current batch whose callbacks were not called, yet */
+LIST(finished_jobs);
+
+/*---------------------------------------------------------------------------*/
+void
+crypto_queue_cancel(crypto_queue_job_t *job)
+{
+  list_remove(pending_jobs, job);
+  list_remove(finished_jobs, job);
+}
+/*---------------------------------------------------------------------------*/
+static void
+submit(crypto_queue_job_t *job,
+       crypto_queue_job_type_t type,
+       crypto_queue_callback_t callback, void *opaque)
+{
+  crypto_queue_cancel(job);
+  job->type = type;
+  job->callback = callback;
+  job->opaque = opaque;
+  list_add(pending_jobs, job);
+  if(!process_is_running(&crypto_queue_process)) {
+    process_start(&crypto_queue_process, NULL);
+  }
+  process_poll(&crypto_queue_process);
+}
+/*---------------------------------------------------------------------------*/
+void
+crypto_queue_encrypt(crypto_queue_job_t *job,
+                     const uint8_t key[static AES_128_KEY_LENGTH],
+                     uint8_t *blocks, size_t count,
+                     crypto_queue_callback_t callback, void *opaque)
+{
+  job->aes_128.key = key;
+  job->aes_128.blocks = blocks;
+  job->aes_128.count = count;
+  submit(job, CRYPTO_QUEUE_JOB_AES_128, callback, opaque);
+}
+/*---------------------------------------------------------------------------*/
+void
+crypto_queue_aead(crypto_queue_job_t *job,
+                  const uint8_t key[static AES_128_KEY_LENGTH],
+                  const uint8_t nonce[static CCM_STAR_NONCE_LENGTH],
+                  uint8_t *m, uint16_t m_len,
+                  const uint8_t *a, uint16_t a_len,
+                  uint8_t *mic, uint8_t mic_len,
+                  bool forward,
+                  crypto_queue_callback_t callback, void *opaque)
+{
+  job->ccm_star.key = key;
+  job->ccm_star.nonce = nonce;
+  job->ccm_star.m = m;
+  job->ccm_star.m_len = m_len;
+  job->ccm_star.a = a;
+  job->ccm_star.a_len = a_len;
+  job->ccm_star.mic = mic;
+  job->ccm_star.mic_len = mic_len;
+  job->ccm_star.forward = forward;
+  submit(job, CRYPTO_QUEUE_JOB_CCM_STAR, callback, opaque);
+}
+/*---------------------------------------------------------------------------*/
+void
+crypto_queue_hash(crypto_queue_job_t *job,
+                  const uint8_t *data, size_t len,
+                  uint8_t digest[static SHA_256_DIGEST_LENGTH],
+                  crypto_queue_callback_t callback, void *opaque)
+{
+  job->sha_256.data = data;
+  job->sha_256.len = len;
+  job->sha_256.digest = digest;
+  submit(job, CRYPTO_QUEUE_JOB_SHA_256, callback, opaque);
+}
+/*---------------------------------------------------------------------------*/
+bool
+crypto_queue_is_queued(const crypto_queue_job_t *job)
+{
+  return list_contains(pending_jobs, job)
+         || list_contains(finished_jobs, job);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+needs_aes_128(const crypto_queue_job_t *job)
+{
+  return job->type != CRYPTO_QUEUE_JOB_SHA_256;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+run(crypto_queue_job_t *job)
+{
+  switch(job->type) {
+  case CRYPTO_QUEUE_JOB_AES_128:
+    return AES_128.set_key(job->aes_128.key)
+           && AES_128.encrypt_blocks(job->aes_128.blocks, job->aes_128.count);
+  case CRYPTO_QUEUE_JOB_CCM_STAR:
+    return CCM_STAR.set_key(job->ccm_star.key)
+           && CCM_STAR.aead(job->ccm_star.nonce,
+                            job->ccm_star.m, job->ccm_star.m_len,
+                            job->ccm_star.a, job->ccm_star.a_len,
+                            job->ccm_star.mic, job->ccm_star.mic_len,
+                            job->ccm_star.forward);
+  case CRYPTO_QUEUE_JOB_SHA_256:
+    return SHA_256.hash(job->sha_256.data,
+                        job->sha_256.len,
+                        job->sha_256.digest);
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Works off up to CRYPTO_QUEUE_BATCH_SIZE jobs, locking AES-128 at most once.
+ * Stops early if AES-128 is needed, but in use elsewhere.
+ * Returns false in that case.
+ */
+static bool
+run_batch(void)
+{
+  bool has_lock = false;
+  bool blocked = false;
+  crypto_queue_job_t *job;
+
+  for(size_t i = 0; i < CRYPTO_QUEUE_BATCH_SIZE; i++) {
+    job = list_head(pending_jobs);
+    if(!job) {
+      break;
+    }
+    if(needs_aes_128(job) && !has_lock) {
+      if(!AES_128.get_lock()) {
+        LOG_DBG("AES-128 is locked\n");
+        blocked = true;
+        break;
+      }
+      has_lock = true;
+    }
+    list_remove(pending_jobs, job);
+    job->successful = run(job);
+    list_add(finished_jobs, job);
+  }
+  if(has_lock) {
+    AES_128.release_lock();
+  }
+
+  /* callbacks may submit or cancel jobs */
+  while((job = list_pop(finished_jobs))) {
+    job->callback(job->opaque, job->successful);
+  }
+  return !blocked;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(crypto_queue_process, ev, data)
+{
+  static struct etimer backoff_timer;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+    while(list_head(pending_jobs)) {
+      if(run_batch()) {
+        /* let others run between batches */
+        PROCESS_PAUSE();
+      } else {
+        /* retrying right away would keep the event queue busy */
+        etimer_set(&backoff_timer, CRYPTO_QUEUE_LOCK_BACKOFF);
+        PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&backoff_timer));
+      }
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+
+/** @} */
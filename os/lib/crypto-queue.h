@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup crypto
+ * @{
+ * \file
+ *         Queue of cryptographic jobs that a dedicated process works off in
+ *         batches. Callers submit jobs together with a callback instead of
+ *         waiting for AES_128.get_lock() to succeed.
+ */
+
+#ifndef CRYPTO_QUEUE_H_
+#define CRYPTO_QUEUE_H_
+
+#include "contiki.h"
+#include "lib/ccm-star.h"
+#include "lib/sha-256.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CRYPTO_QUEUE_CONF_BATCH_SIZE
+#define CRYPTO_QUEUE_BATCH_SIZE CRYPTO_QUEUE_CONF_BATCH_SIZE
+#else /* CRYPTO_QUEUE_CONF_BATCH_SIZE */
+#define CRYPTO_QUEUE_BATCH_SIZE (4)
+#endif /* CRYPTO_QUEUE_CONF_BATCH_SIZE */
+
+/* how long to back off when AES-128 is in use elsewhere */
+#ifdef CRYPTO_QUEUE_CONF_LOCK_BACKOFF
+#define CRYPTO_QUEUE_LOCK_BACKOFF CRYPTO_QUEUE_CONF_LOCK_BACKOFF
+#else /* CRYPTO_QUEUE_CONF_LOCK_BACKOFF */
+#define CRYPTO_QUEUE_LOCK_BACKOFF (1)
+#endif /* CRYPTO_QUEUE_CONF_LOCK_BACKOFF */
+
+/**
+ * \brief            Called once a job is done.
+ * \param opaque     The pointer passed when submitting the job.
+ * \param successful \c true if the driver reported success.
+ */
+typedef void (* crypto_queue_callback_t)(void *opaque, bool successful);
+
+typedef enum crypto_queue_job_type_t {
+  CRYPTO_QUEUE_JOB_AES_128,
+  CRYPTO_QUEUE_JOB_CCM_STAR,
+  CRYPTO_QUEUE_JOB_SHA_256,
+} crypto_queue_job_type_t;
+
+/**
+ * A job. Jobs are allocated by their submitters and, like all the buffers
+ * they point to, must remain valid until the callback is called or the job
+ * is canceled.
+ */
+typedef struct crypto_queue_job_t {
+  struct crypto_queue_job_t *next;
+  crypto_queue_job_type_t type;
+  union {
+    struct {
+      const uint8_t *key;
+      uint8_t *blocks;
+      size_t count;
+    } aes_128;
+    struct {
+      const uint8_t *key;
+      const uint8_t *nonce;
+      uint8_t *m;
+      const uint8_t *a;
+      uint8_t *mic;
+      uint16_t m_len;
+      uint16_t a_len;
+      uint8_t mic_len;
+      bool forward;
+    } ccm_star;
+    struct {
+      const uint8_t *data;
+      size_t len;
+      uint8_t *digest;
+    } sha_256;
+  };
+  crypto_queue_callback_t callback;
+  void *opaque;
+  bool successful;
+} crypto_queue_job_t;
+
+/**
+ * \brief          Enqueues an ECB encryption of consecutive blocks.
+ * \param job      The job to use.
+ * \param key      The AES-128 key.
+ * \param blocks   The plaintexts, which get overwritten with the results.
+ * \param count    The number of blocks.
+ * \param callback Called when done.
+ * \param opaque   Passed to the callback.
+ */
+void crypto_queue_encrypt(crypto_queue_job_t *job,
+                          const uint8_t key[static AES_128_KEY_LENGTH],
+                          uint8_t *blocks, size_t count,
+                          crypto_queue_callback_t callback, void *opaque);
+
+/**
+ * \brief          Enqueues a CCM* operation.
+ *
+ *                 The parameters between key and forward are those of
+ *                 ccm_star_driver#aead.
+ */
+void crypto_queue_aead(crypto_queue_job_t *job,
+                       const uint8_t key[static AES_128_KEY_LENGTH],
+                       const uint8_t nonce[static CCM_STAR_NONCE_LENGTH],
+                       uint8_t *m, uint16_t m_len,
+                       const uint8_t *a, uint16_t a_len,
+                       uint8_t *mic, uint8_t mic_len,
+                       bool forward,
+                       crypto_queue_callback_t callback, void *opaque);
+
+/**
+ * \brief          Enqueues a SHA-256 hash computation.
+ * \param job      The job to use.
+ * \param data     The data to hash.
+ * \param len      The length of the data in bytes.
+ * \param digest   Where to store the digest.
+ * \param callback Called when done.
+ * \param opaque   Passed to the callback.
+ */
+void crypto_queue_hash(crypto_queue_job_t *job,
+                       const uint8_t *data, size_t len,
+                       uint8_t digest[static SHA_256_DIGEST_LENGTH],
+                       crypto_queue_callback_t callback, void *opaque);
+
+/**
+ * \brief     Removes a job without calling its callback.
+ *
+ *            Does nothing if the job is not queued.
+ */
+void crypto_queue_cancel(crypto_queue_job_t *job);
+
+/**
+ * \brief Tells whether a job is still waiting for its callback.
+ */
+bool crypto_queue_is_queued(const crypto_queue_job_t *job);
+
+#endif /* CRYPTO_QUEUE_H_ */
+
+/** @} */
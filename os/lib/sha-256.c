@@ -163,7 +163,7 @@ sha_256_checkpoint_t sha_256_checkpoint;
  * the 512-bit input block to produce a new state.
  */
 static void
-transform(const uint8_t block[static SHA_256_BLOCK_SIZE])
+transform_block(const uint8_t block[static SHA_256_BLOCK_SIZE])
 {
   uint32_t W[64];
   uint32_t S[8];
@@ -221,9 +221,18 @@ transform(const uint8_t block[static SHA_256_BLOCK_SIZE])
   }
 }
 /*---------------------------------------------------------------------------*/
+void
+sha_256_transform(const uint8_t *blocks, size_t count)
+{
+  while(count--) {
+    transform_block(blocks);
+    blocks += SHA_256_BLOCK_SIZE;
+  }
+}
+/*---------------------------------------------------------------------------*/
 /* Add padding and terminating bit-count. */
 static void
-sha_256_pad(void)
+sha_256_pad(sha_256_transform_t transform)
 {
   static const unsigned char PAD[64] = {
     0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -240,7 +249,7 @@ sha_256_pad(void)
     /* Finish the current block and mix. */
     memcpy(&sha_256_checkpoint.buf[sha_256_checkpoint.buf_len], PAD,
            SHA_256_BLOCK_SIZE - sha_256_checkpoint.buf_len);
-    transform(sha_256_checkpoint.buf);
+    transform(sha_256_checkpoint.buf, 1);
 
     /* The start of the final block is all zeroes. */
     memset(&sha_256_checkpoint.buf[0], 0, 56);
@@ -250,7 +259,7 @@ sha_256_pad(void)
   be64enc(&sha_256_checkpoint.buf[56], sha_256_checkpoint.bit_count);
 
   /* Mix in the final block. */
-  transform(sha_256_checkpoint.buf);
+  transform(sha_256_checkpoint.buf, 1);
 }
 /*---------------------------------------------------------------------------*/
 /* SHA-256 initialization. Begins a SHA-256 operation. */
@@ -272,9 +281,9 @@ init(void)
   sha_256_checkpoint.state[7] = 0x5BE0CD19;
 }
 /*---------------------------------------------------------------------------*/
-/* Add bytes into the hash */
-static void
-update(const uint8_t *data, size_t len)
+void
+sha_256_update_with_transform(const uint8_t *data, size_t len,
+                              sha_256_transform_t transform)
 {
   uint64_t bitlen;
 
@@ -295,16 +304,17 @@ update(const uint8_t *data, size_t len)
   memcpy(&sha_256_checkpoint.buf[sha_256_checkpoint.buf_len],
          data,
          SHA_256_BLOCK_SIZE - sha_256_checkpoint.buf_len);
-  transform(sha_256_checkpoint.buf);
+  transform(sha_256_checkpoint.buf, 1);
   data += SHA_256_BLOCK_SIZE - sha_256_checkpoint.buf_len;
   len -= SHA_256_BLOCK_SIZE - sha_256_checkpoint.buf_len;
   sha_256_checkpoint.buf_len = 0;
 
-  /* Perform complete blocks */
-  while(len >= 64) {
-    transform(data);
-    data += SHA_256_BLOCK_SIZE;
-    len -= SHA_256_BLOCK_SIZE;
+  /* Perform complete blocks at once */
+  size_t count = len / SHA_256_BLOCK_SIZE;
+  if(count) {
+    transform(data, count);
+    data += count * SHA_256_BLOCK_SIZE;
+    len -= count * SHA_256_BLOCK_SIZE;
   }
 
   /* Copy left over data into buffer */
@@ -312,6 +322,13 @@ update(const uint8_t *data, size_t len)
   sha_256_checkpoint.buf_len += len;
 }
 /*---------------------------------------------------------------------------*/
+/* Add bytes into the hash */
+static void
+update(const uint8_t *data, size_t len)
+{
+  sha_256_update_with_transform(data, len, sha_256_transform);
+}
+/*---------------------------------------------------------------------------*/
 static void
 cancel(void)
 {
@@ -321,11 +338,12 @@ cancel(void)
  * SHA-256 finalization.  Pads the input data, exports the hash value,
  * and clears the context state.
  */
-static bool
-finalize(uint8_t digest[static SHA_256_DIGEST_LENGTH])
+bool
+sha_256_finalize_with_transform(uint8_t digest[static SHA_256_DIGEST_LENGTH],
+                                sha_256_transform_t transform)
 {
   /* Add padding */
-  sha_256_pad();
+  sha_256_pad(transform);
 
   /* Write the hash */
   be32enc_vect(digest, sha_256_checkpoint.state, SHA_256_DIGEST_LENGTH);
@@ -336,6 +354,12 @@ finalize(uint8_t digest[static SHA_256_DIGEST_LENGTH])
   return true;
 }
 /*---------------------------------------------------------------------------*/
+static bool
+finalize(uint8_t digest[static SHA_256_DIGEST_LENGTH])
+{
+  return sha_256_finalize_with_transform(digest, sha_256_transform);
+}
+/*---------------------------------------------------------------------------*/
 static void
 create_checkpoint(sha_256_checkpoint_t *cp)
 {
@@ -421,6 +445,52 @@ sha_256_hmac(const uint8_t *key, size_t key_len,
 }
 /*---------------------------------------------------------------------------*/
 bool
+sha_256_hmac_context_init(sha_256_hmac_context_t *context,
+                          const uint8_t *key, size_t key_len)
+{
+  sha_256_hmac_init(key, key_len);
+  if(!sha_256_checkpoint.is_error_free) {
+    return false;
+  }
+  SHA_256.create_checkpoint(&context->inner);
+  SHA_256.init();
+  SHA_256.update(sha_256_checkpoint.opad, sizeof(sha_256_checkpoint.opad));
+  SHA_256.create_checkpoint(&context->outer);
+  memset(&sha_256_checkpoint.opad, 0, sizeof(sha_256_checkpoint.opad));
+  memset(&context->inner.opad, 0, sizeof(context->inner.opad));
+  memset(&context->outer.opad, 0, sizeof(context->outer.opad));
+  return context->outer.is_error_free;
+}
+/*---------------------------------------------------------------------------*/
+void
+sha_256_hmac_context_start(const sha_256_hmac_context_t *context)
+{
+  SHA_256.restore_checkpoint(&context->inner);
+}
+/*---------------------------------------------------------------------------*/
+bool
+sha_256_hmac_context_finish(const sha_256_hmac_context_t *context,
+                            uint8_t hmac[static SHA_256_DIGEST_LENGTH])
+{
+  if(!sha_256_checkpoint.is_error_free || !SHA_256.finalize(hmac)) {
+    return false;
+  }
+  SHA_256.restore_checkpoint(&context->outer);
+  SHA_256.update(hmac, SHA_256_DIGEST_LENGTH);
+  return SHA_256.finalize(hmac);
+}
+/*---------------------------------------------------------------------------*/
+bool
+sha_256_hmac_with_context(const sha_256_hmac_context_t *context,
+                          const uint8_t *data, size_t data_len,
+                          uint8_t hmac[static SHA_256_DIGEST_LENGTH])
+{
+  sha_256_hmac_context_start(context);
+  sha_256_hmac_update(data, data_len);
+  return sha_256_hmac_context_finish(context, hmac);
+}
+/*---------------------------------------------------------------------------*/
+bool
 sha_256_hkdf_extract(const uint8_t *salt, size_t salt_len,
                      const uint8_t *ikm, size_t ikm_len,
                      uint8_t prk[static SHA_256_DIGEST_LENGTH])
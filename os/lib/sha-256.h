@@ -65,6 +65,22 @@ typedef struct {
   bool is_error_free;
 } sha_256_checkpoint_t;
 
+/**
+ * Holds the hash sessions after absorbing an HMAC key, so that HMACs with
+ * the same key skip the compressions of the inner and outer padding.
+ */
+typedef struct {
+  sha_256_checkpoint_t inner;
+  sha_256_checkpoint_t outer;
+} sha_256_hmac_context_t;
+
+/**
+ * \brief        Compresses consecutive blocks into sha_256_checkpoint.state.
+ * \param blocks pointer to the blocks
+ * \param count  number of blocks
+ */
+typedef void (* sha_256_transform_t)(const uint8_t *blocks, size_t count);
+
 /**
  * Structure of SHA-256 drivers.
  */
@@ -115,6 +131,7 @@ struct sha_256_driver {
                 uint8_t digest[static SHA_256_DIGEST_LENGTH]);
 };
 
+extern const struct sha_256_driver sha_256_driver;
 extern const struct sha_256_driver SHA_256;
 extern sha_256_checkpoint_t sha_256_checkpoint;
 
@@ -125,6 +142,30 @@ extern sha_256_checkpoint_t sha_256_checkpoint;
 bool sha_256_hash(const uint8_t *data, size_t len,
                   uint8_t digest[static SHA_256_DIGEST_LENGTH]);
 
+/**
+ * \brief Software implementation of sha_256_transform_t.
+ */
+void sha_256_transform(const uint8_t *blocks, size_t count);
+
+/**
+ * \brief           Implements sha_256_driver#update on top of a transform.
+ * \param data      pointer to the data to hash
+ * \param len       length of the data to hash in bytes
+ * \param transform the compression function to use
+ */
+void sha_256_update_with_transform(const uint8_t *data, size_t len,
+                                   sha_256_transform_t transform);
+
+/**
+ * \brief           Implements sha_256_driver#finalize on top of a transform.
+ * \param digest    pointer to the hash value
+ * \param transform the compression function to use
+ * \return          \c true on success and \c false otherwise.
+ */
+bool sha_256_finalize_with_transform(
+    uint8_t digest[static SHA_256_DIGEST_LENGTH],
+    sha_256_transform_t transform);
+
 /**
  * \brief Initiates a stepwise HMAC-SHA-256 computation.
  * \param key     the key to authenticate with
@@ -159,6 +200,45 @@ bool sha_256_hmac(const uint8_t *key, size_t key_len,
                   const uint8_t *data, size_t data_len,
                   uint8_t hmac[static SHA_256_DIGEST_LENGTH]);
 
+/**
+ * \brief         Absorbs an HMAC key for repeated use.
+ * \param context where to store the resultant hash sessions
+ * \param key     the key to authenticate with
+ * \param key_len length of key in bytes
+ * \return        \c true on success and \c false otherwise.
+ */
+bool sha_256_hmac_context_init(sha_256_hmac_context_t *context,
+                               const uint8_t *key, size_t key_len);
+
+/**
+ * \brief         Like sha_256_hmac_init, but with a preprocessed key.
+ * \param context a context that was set up via sha_256_hmac_context_init
+ *
+ *                Continue with sha_256_hmac_update.
+ */
+void sha_256_hmac_context_start(const sha_256_hmac_context_t *context);
+
+/**
+ * \brief         Like sha_256_hmac_finish, but with a preprocessed key.
+ * \param context the context passed to sha_256_hmac_context_start
+ * \param hmac    pointer to where the resulting HMAC shall be stored
+ * \return        \c true on success and \c false otherwise.
+ */
+bool sha_256_hmac_context_finish(const sha_256_hmac_context_t *context,
+                                 uint8_t hmac[static SHA_256_DIGEST_LENGTH]);
+
+/**
+ * \brief          Computes HMAC-SHA-256 with a preprocessed key.
+ * \param context  a context that was set up via sha_256_hmac_context_init
+ * \param data     the data to authenticate
+ * \param data_len length of data in bytes
+ * \param hmac     pointer to where the resulting HMAC shall be stored
+ * \return         \c true on success and \c false otherwise.
+ */
+bool sha_256_hmac_with_context(const sha_256_hmac_context_t *context,
+                               const uint8_t *data, size_t data_len,
+                               uint8_t hmac[static SHA_256_DIGEST_LENGTH]);
+
 /**
  * \brief Extracts a key as per RFC 5869.
  * \param salt     optional salt value
@@ -127,4 +127,83 @@ coap_block1_handler(coap_message_t *request, coap_message_t *response,
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+
+/**
+ * \brief Streaming block 1 support within a CoAP resource.
+ *
+ *        Unlike coap_block1_handler(), this function passes each block
+ *        on to a consumer rather than assembling the payload in a buffer.
+ *        Blocks have to arrive in order. A retransmitted block, i.e., one
+ *        with the message ID of the last consumed block, is acknowledged
+ *        without passing it on again. Any other block with offset 0
+ *        starts a new payload.
+ *
+ * \param request Request pointer from the handler.
+ *
+ * \param response Response pointer from the handler.
+ *
+ * \param consumer Consumer of the blocks.
+ *
+ * \param progress Pointer to the progress of the transfer, which has to
+ * be kept across the requests of a transfer.
+ *
+ * \return 0 if the last block was consumed,
+ *         1 if more blocks will follow, or
+ *         -1 if the block was not consumed.
+ */
+int
+coap_block1_stream(coap_message_t *request, coap_message_t *response,
+                   coap_block1_consumer_t consumer,
+                   coap_block1_progress_t *progress)
+{
+  const uint8_t *payload = 0;
+  int pay_len = coap_get_payload(request, &payload);
+
+  if(!pay_len || !payload) {
+    coap_status_code = BAD_REQUEST_4_00;
+#if COAP_MESSAGE_ON_ERROR
+    coap_error_message = "NoPayload";
+#endif
+    return -1;
+  }
+
+  /*
+   * Offsets alone cannot tell a retransmitted block 0 from the block 0 of
+   * a new transfer with the same block size
+   */
+  if(progress->next_offset
+     && (request->mid == progress->mid)
+     && (request->block1_offset + pay_len == progress->next_offset)) {
+    LOG_DBG("Blockwise: retransmitted block 1 request\n");
+  } else if(!request->block1_offset
+            || (request->block1_offset == progress->next_offset)) {
+    if(consumer(payload, pay_len, request->block1_offset)) {
+      coap_status_code = INTERNAL_SERVER_ERROR_5_00;
+#if COAP_MESSAGE_ON_ERROR
+      coap_error_message = "ConsumerFailed";
+#endif
+      return -1;
+    }
+    progress->next_offset = request->block1_offset + pay_len;
+    progress->mid = request->mid;
+  } else {
+    coap_status_code = REQUEST_ENTITY_INCOMPLETE_4_08;
+#if COAP_MESSAGE_ON_ERROR
+    coap_error_message = "MissingBlock";
+#endif
+    return -1;
+  }
+
+  if(coap_is_option(request, COAP_OPTION_BLOCK1)) {
+    coap_set_header_block1(response, request->block1_num,
+                           request->block1_more, request->block1_size);
+    if(request->block1_more) {
+      coap_set_status_code(response, CONTINUE_2_31);
+      return 1;
+    }
+  }
+
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
@@ -48,8 +48,27 @@
 #include <stddef.h>
 #include <stdint.h>
 
+typedef struct coap_block1_progress {
+  uint32_t next_offset; /* of the next expected block, 0 initially */
+  uint16_t mid; /* of the request whose block was consumed last */
+} coap_block1_progress_t;
+
 int coap_block1_handler(coap_message_t *request, coap_message_t *response,
                         uint8_t *target, size_t *len, size_t max_len);
 
+/**
+ * \brief        Consumes the next block of a request payload.
+ * \param data   The block
+ * \param len    Length of the block
+ * \param offset Offset of the block within the payload
+ * \return       0 on success, or -1 on error
+ */
+typedef int (* coap_block1_consumer_t)(const uint8_t *data, uint16_t len,
+                                       uint32_t offset);
+
+int coap_block1_stream(coap_message_t *request, coap_message_t *response,
+                       coap_block1_consumer_t consumer,
+                       coap_block1_progress_t *progress);
+
 #endif /* COAP_BLOCK1_H_ */
 /** @} */
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      CoAP module for streaming block 2 transfers
+ */
+
+/**
+ * \addtogroup coap
+ * @{
+ */
+
+#include "coap-block2.h"
+#include "coap-timer.h"
+#include "sys/cc.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* Log configuration */
+#include "coap-log.h"
+#define LOG_MODULE "coap"
+#define LOG_LEVEL  LOG_LEVEL_COAP
+
+struct stream {
+  coap_endpoint_t endpoint;
+  coap_block2_producer_t producer; /* NULL if this slot is unused */
+  uint64_t used_at;
+  coap_block2_cursor_t cursor;
+  bool has_lookahead;
+  uint8_t lookahead;
+#if COAP_BLOCK2_WITH_CACHE
+  bool has_cached_block;
+  bool cached_block_has_more;
+  uint16_t cached_block_mid;
+  uint16_t cached_block_len;
+  uint32_t cached_block_offset;
+  uint8_t cached_block[COAP_MAX_BLOCK_SIZE];
+#endif /* COAP_BLOCK2_WITH_CACHE */
+};
+
+static struct stream streams[COAP_MAX_BLOCK2_STREAMS];
+static struct stream unkept_stream;
+
+/*---------------------------------------------------------------------------*/
+static void
+restart(struct stream *stream)
+{
+  memset(&stream->cursor, 0, sizeof(stream->cursor));
+  stream->has_lookahead = false;
+}
+/*---------------------------------------------------------------------------*/
+static struct stream *
+get_stream(const coap_endpoint_t *endpoint, coap_block2_producer_t producer)
+{
+  struct stream *victim = NULL;
+
+  if(!endpoint) {
+    /* e.g., notifications are rendered without a requesting endpoint */
+    memset(&unkept_stream, 0, sizeof(unkept_stream));
+    unkept_stream.producer = producer;
+    return &unkept_stream;
+  }
+
+  for(struct stream *stream = streams;
+      stream < streams + COAP_MAX_BLOCK2_STREAMS;
+      stream++) {
+    if(stream->producer == producer
+       && coap_endpoint_cmp(&stream->endpoint, endpoint)) {
+      victim = stream;
+      break;
+    }
+    if(!victim
+       || (victim->producer
+           && (!stream->producer || (stream->used_at < victim->used_at)))) {
+      victim = stream;
+    }
+  }
+
+  if((victim->producer != producer)
+     || !coap_endpoint_cmp(&victim->endpoint, endpoint)) {
+    LOG_DBG("Starting block 2 stream\n");
+    memset(victim, 0, sizeof(*victim));
+    coap_endpoint_copy(&victim->endpoint, endpoint);
+    victim->producer = producer;
+  }
+  victim->used_at = coap_timer_uptime();
+  return victim;
+}
+/*---------------------------------------------------------------------------*/
+static int
+produce(struct stream *stream, uint8_t *buffer, uint16_t len)
+{
+  uint16_t produced = 0;
+  int result;
+
+  if(!len) {
+    return 0;
+  }
+  if(stream->has_lookahead) {
+    buffer[produced++] = stream->lookahead;
+    stream->has_lookahead = false;
+  }
+  if(produced < len) {
+    result = stream->producer(&stream->cursor,
+                              buffer + produced, len - produced);
+    if(result < 0) {
+      return -1;
+    }
+    stream->cursor.offset += result;
+    produced += result;
+  }
+  return produced;
+}
+/*---------------------------------------------------------------------------*/
+/* moves the stream to offset, using buffer as scratch space */
+static int
+seek(struct stream *stream, uint32_t offset,
+     uint8_t *buffer, uint16_t buffer_size)
+{
+  uint32_t position = stream->cursor.offset - stream->has_lookahead;
+
+  if(offset < position) {
+    LOG_DBG("Restarting block 2 stream\n");
+    restart(stream);
+    position = 0;
+  }
+  while(position < offset) {
+    int result = produce(stream, buffer, MIN(buffer_size, offset - position));
+    if(result <= 0) {
+      return result;
+    }
+    position += result;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+coap_block2_stream(coap_message_t *request, coap_message_t *response,
+                   uint8_t *buffer, uint16_t preferred_size,
+                   int32_t *offset, coap_block2_producer_t producer)
+{
+  struct stream *stream;
+  uint32_t block_offset = *offset;
+  int len;
+  bool more;
+
+  stream = get_stream(coap_get_src_endpoint(request), producer);
+
+#if COAP_BLOCK2_WITH_CACHE
+  /*
+   * Only a retransmitted request gets the cached block since the
+   * representation may have changed in the meantime
+   */
+  if(stream->has_cached_block
+     && (stream->cached_block_mid == request->mid)
+     && (stream->cached_block_offset == block_offset)
+     && ((stream->cached_block_len == preferred_size)
+         || (!stream->cached_block_has_more
+             && (stream->cached_block_len <= preferred_size)))) {
+    LOG_DBG("Repeating cached block at %"PRIu32"\n", block_offset);
+    len = stream->cached_block_len;
+    more = stream->cached_block_has_more;
+    memcpy(buffer, stream->cached_block, len);
+  } else
+#endif /* COAP_BLOCK2_WITH_CACHE */
+  {
+    int lookahead_len = 0;
+
+    len = seek(stream, block_offset, buffer, preferred_size);
+    if(!len) {
+      coap_status_code = BAD_OPTION_4_02;
+#if COAP_MESSAGE_ON_ERROR
+      coap_error_message = "BlockOutOfScope";
+#endif
+      return -1;
+    }
+    if(len > 0) {
+      len = produce(stream, buffer, preferred_size);
+    }
+    if(len == preferred_size) {
+      /* look one byte ahead so as to tell whether another block follows */
+      lookahead_len = produce(stream, &stream->lookahead, 1);
+    }
+    if((len < 0) || (lookahead_len < 0)) {
+      restart(stream);
+      coap_status_code = INTERNAL_SERVER_ERROR_5_00;
+#if COAP_MESSAGE_ON_ERROR
+      coap_error_message = "ProducerFailed";
+#endif
+      return -1;
+    }
+    stream->has_lookahead = lookahead_len == 1;
+    more = stream->has_lookahead;
+
+#if COAP_BLOCK2_WITH_CACHE
+    stream->has_cached_block = len <= COAP_MAX_BLOCK_SIZE;
+    if(stream->has_cached_block) {
+      stream->cached_block_has_more = more;
+      stream->cached_block_mid = request->mid;
+      stream->cached_block_len = len;
+      stream->cached_block_offset = block_offset;
+      memcpy(stream->cached_block, buffer, len);
+    }
+#endif /* COAP_BLOCK2_WITH_CACHE */
+  }
+
+  coap_set_payload(response, buffer, len);
+  if(more) {
+    *offset = block_offset + len;
+  } else if(block_offset) {
+    *offset = -1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *      CoAP module for streaming block 2 transfers. A resource hands
+ *      out its representation through a cursor that is kept across the
+ *      block requests of a client, so that the representation is not
+ *      produced from scratch for every block.
+ */
+
+/**
+ * \addtogroup coap
+ * @{
+ */
+
+#ifndef COAP_BLOCK2_H_
+#define COAP_BLOCK2_H_
+
+#include "coap.h"
+#include <stdint.h>
+
+/*
+ * A cursor may be reset to offset 0 or dropped at any time, e.g., when a
+ * client skips back or when the stream is evicted for another client.
+ * The producer is not notified. Hence, the state must be a plain value,
+ * such as a running checksum, that is recomputed as the representation
+ * is produced from offset 0 again. It must never hold a resource, like a
+ * CFS file descriptor. Producers of files open them within each call and
+ * seek to the offset.
+ */
+typedef struct coap_block2_cursor {
+  uint32_t offset; /* of the next byte to produce, advanced by the caller */
+  uintptr_t state; /* plain value of the producer, 0 at offset 0 */
+} coap_block2_cursor_t;
+
+/**
+ * \brief        Produces the next bytes of a representation.
+ * \param cursor The cursor to advance
+ * \param buffer Where to write the next bytes
+ * \param len    Number of bytes to produce
+ * \return       Number of bytes produced, which is less than \p len at the
+ *               end of the representation, or -1 on error
+ */
+typedef int (* coap_block2_producer_t)(coap_block2_cursor_t *cursor,
+                                       uint8_t *buffer, uint16_t len);
+
+/**
+ * \brief Block 2 support for a GET handler with a streamed representation.
+ *
+ *        Fills the response with the requested block. Sequential block
+ *        requests of a client continue where the previous block ended and
+ *        a retransmitted block request, i.e., one with the same message ID,
+ *        is served from a cache. Otherwise, the producer is restarted and
+ *        skips ahead to the requested block.
+ *
+ * \param request  Request pointer from the handler
+ * \param response Response pointer from the handler
+ * \param buffer   Buffer pointer from the handler
+ * \param preferred_size Preferred size from the handler
+ * \param offset   Offset pointer from the handler
+ * \param producer Produces the representation
+ * \return 0 on success, or -1 on error
+ */
+int coap_block2_stream(coap_message_t *request, coap_message_t *response,
+                       uint8_t *buffer, uint16_t preferred_size,
+                       int32_t *offset, coap_block2_producer_t producer);
+
+#endif /* COAP_BLOCK2_H_ */
+/** @} */
@@ -62,6 +62,12 @@ struct coap_callback_request_state {
 
 /**
  * \brief Send a CoAP request to a remote endpoint.
+ *
+ * This function does not block. Further requests can be sent while
+ * earlier ones are pending, each with its own callback state, request and
+ * endpoint. With COAP_CONF_WITH_CONGESTION_CONTROL, requests beyond
+ * COAP_NSTART per endpoint are deferred until earlier ones complete.
+ *
  * \param callback_state The callback state to handle the CoAP request.
  * \param endpoint The destination endpoint.
  * \param request The request to be sent.
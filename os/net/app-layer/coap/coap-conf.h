@@ -83,6 +83,39 @@
 #define COAP_MAX_OPEN_TRANSACTIONS     4
 #endif /* COAP_MAX_OPEN_TRANSACTIONS */
 
+/*
+ * Congestion control after CoCoA. Retransmission timeouts are adapted to the
+ * round-trip times measured per peer and at most COAP_NSTART confirmable
+ * messages are outstanding per peer. Further confirmable messages are deferred
+ * until an outstanding one is acknowledged or times out.
+ */
+#ifdef COAP_CONF_WITH_CONGESTION_CONTROL
+#define COAP_WITH_CONGESTION_CONTROL COAP_CONF_WITH_CONGESTION_CONTROL
+#else
+#define COAP_WITH_CONGESTION_CONTROL 0
+#endif
+
+/* Number of peers whose round-trip times are tracked */
+#ifdef COAP_CONF_MAX_PEERS
+#define COAP_MAX_PEERS COAP_CONF_MAX_PEERS
+#else
+#define COAP_MAX_PEERS COAP_MAX_OPEN_TRANSACTIONS
+#endif
+
+/* Number of outstanding confirmable messages per peer */
+#ifdef COAP_CONF_NSTART
+#define COAP_NSTART COAP_CONF_NSTART
+#else
+#define COAP_NSTART 1
+#endif
+
+/* Count (re)transmissions and timeouts of confirmable messages */
+#ifdef COAP_CONF_WITH_TRANSACTION_STATS
+#define COAP_WITH_TRANSACTION_STATS COAP_CONF_WITH_TRANSACTION_STATS
+#else
+#define COAP_WITH_TRANSACTION_STATS 0
+#endif
+
 /* Maximum number of failed request attempts before action */
 #ifndef COAP_MAX_ATTEMPTS
 #define COAP_MAX_ATTEMPTS              4
@@ -105,6 +138,38 @@
 #define COAP_OBSERVE_REFRESH_INTERVAL  20
 #endif /* COAP_OBSERVE_REFRESH_INTERVAL */
 
+/*
+ * Minimum interval in milliseconds between notifications to an observer.
+ * Changes in between are coalesced into one notification carrying the latest
+ * representation. 0 disables coalescing.
+ */
+#ifdef COAP_CONF_OBSERVE_MIN_INTERVAL
+#define COAP_OBSERVE_MIN_INTERVAL COAP_CONF_OBSERVE_MIN_INTERVAL
+#else
+#define COAP_OBSERVE_MIN_INTERVAL 0
+#endif
+
+/* Number of URLs whose notification can be deferred at the same time */
+#ifdef COAP_CONF_OBSERVE_MAX_PENDING
+#define COAP_OBSERVE_MAX_PENDING COAP_CONF_OBSERVE_MAX_PENDING
+#else
+#define COAP_OBSERVE_MAX_PENDING COAP_MAX_OBSERVERS
+#endif
+
+/* Number of clients whose block 2 streams are kept at the same time */
+#ifdef COAP_CONF_MAX_BLOCK2_STREAMS
+#define COAP_MAX_BLOCK2_STREAMS COAP_CONF_MAX_BLOCK2_STREAMS
+#else
+#define COAP_MAX_BLOCK2_STREAMS 2
+#endif
+
+/* Keep the last block of each block 2 stream for retransmitted requests */
+#ifdef COAP_CONF_BLOCK2_WITH_CACHE
+#define COAP_BLOCK2_WITH_CACHE COAP_CONF_BLOCK2_WITH_CACHE
+#else
+#define COAP_BLOCK2_WITH_CACHE 1
+#endif
+
 /* Maximal length of observable URL */
 #ifdef COAP_CONF_OBSERVER_URL_LEN
 #define COAP_OBSERVER_URL_LEN COAP_CONF_OBSERVER_URL_LEN
@@ -119,6 +184,17 @@
 #define COAP_WELL_KNOWN_RESOURCE_ENABLED  1
 #endif
 
+/*
+ * Number of hash buckets for indexing resources by URI path, so that requests
+ * are dispatched without comparing their URI path against every resource. 0
+ * disables the index. Must be a power of two.
+ */
+#ifdef COAP_CONF_RESOURCE_INDEX_BUCKETS
+#define COAP_RESOURCE_INDEX_BUCKETS COAP_CONF_RESOURCE_INDEX_BUCKETS
+#else
+#define COAP_RESOURCE_INDEX_BUCKETS 0
+#endif
+
 /* Add a human readable message to payload if an error occurs */
 #ifdef COAP_CONF_MESSAGE_ON_ERROR
 #define COAP_MESSAGE_ON_ERROR   COAP_CONF_MESSAGE_ON_ERROR
@@ -71,6 +71,12 @@ static int invoke_coap_resource_service(coap_message_t *request,
 LIST(coap_handlers);
 LIST(coap_resource_services);
 static uint8_t is_initialized = 0;
+#if COAP_RESOURCE_INDEX_BUCKETS
+#if COAP_RESOURCE_INDEX_BUCKETS & (COAP_RESOURCE_INDEX_BUCKETS - 1)
+#error COAP_RESOURCE_INDEX_BUCKETS must be a power of two
+#endif
+static coap_resource_t *resource_index[COAP_RESOURCE_INDEX_BUCKETS];
+#endif /* COAP_RESOURCE_INDEX_BUCKETS */
 
 /*---------------------------------------------------------------------------*/
 /*- CoAP service handlers---------------------------------------------------*/
@@ -320,7 +326,7 @@ coap_receive(const coap_endpoint_t *src,
         coap_resource_response_handler_t callback = transaction->callback;
         void *callback_data = transaction->callback_data;
 
-        coap_clear_transaction(transaction);
+        coap_acknowledge_transaction(transaction);
 
         /* check if someone registered for the response */
         if(callback) {
@@ -393,6 +399,9 @@ coap_engine_init(void)
 
   list_init(coap_handlers);
   list_init(coap_resource_services);
+#if COAP_RESOURCE_INDEX_BUCKETS
+  memset(resource_index, 0, sizeof(resource_index));
+#endif /* COAP_RESOURCE_INDEX_BUCKETS */
 
 #if COAP_WELL_KNOWN_RESOURCE_ENABLED
   coap_activate_resource(&res_well_known_core, ".well-known/core");
@@ -402,6 +411,77 @@ coap_engine_init(void)
   coap_init_connection();
 }
 /*---------------------------------------------------------------------------*/
+#if COAP_RESOURCE_INDEX_BUCKETS
+/* FNV-1a */
+#define HASH_OFFSET_BASIS 2166136261u
+#define HASH_PRIME 16777619u
+
+static uint32_t
+hash_update(uint32_t hash, char c)
+{
+  return (hash ^ (uint8_t)c) * HASH_PRIME;
+}
+/*---------------------------------------------------------------------------*/
+static coap_resource_t **
+get_bucket(uint32_t hash)
+{
+  return &resource_index[hash & (COAP_RESOURCE_INDEX_BUCKETS - 1)];
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+hash_url(const char *url)
+{
+  uint32_t hash = HASH_OFFSET_BASIS;
+  while(*url) {
+    hash = hash_update(hash, *url++);
+  }
+  return hash;
+}
+/*---------------------------------------------------------------------------*/
+static void
+unindex_resource(coap_resource_t *resource)
+{
+  if(!resource->url) {
+    return;
+  }
+  for(coap_resource_t **next = get_bucket(hash_url(resource->url));
+      *next;
+      next = &(*next)->bucket_next) {
+    if(*next == resource) {
+      *next = resource->bucket_next;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_resource(coap_resource_t *resource)
+{
+  /* append so that the first resource activated under a path wins */
+  coap_resource_t **next = get_bucket(hash_url(resource->url));
+  while(*next) {
+    next = &(*next)->bucket_next;
+  }
+  resource->bucket_next = NULL;
+  *next = resource;
+}
+/*---------------------------------------------------------------------------*/
+static coap_resource_t *
+lookup_resource(uint32_t hash, const char *url, int url_len, bool is_parent)
+{
+  for(coap_resource_t *resource = *get_bucket(hash);
+      resource;
+      resource = resource->bucket_next) {
+    if((!is_parent || (resource->flags & HAS_SUB_RESOURCES))
+       && (strlen(resource->url) == (size_t)url_len)
+       && !memcmp(resource->url, url, url_len)) {
+      return resource;
+    }
+  }
+  return NULL;
+}
+#endif /* COAP_RESOURCE_INDEX_BUCKETS */
+/*---------------------------------------------------------------------------*/
 /**
  * \brief Makes a resource available under the given URI path
  *
@@ -413,8 +493,15 @@ void
 coap_activate_resource(coap_resource_t *resource, const char *path)
 {
   coap_periodic_resource_t *periodic;
+#if COAP_RESOURCE_INDEX_BUCKETS
+  /* the resource may be re-activated under another path */
+  unindex_resource(resource);
+#endif /* COAP_RESOURCE_INDEX_BUCKETS */
   resource->url = path;
   list_add(coap_resource_services, resource);
+#if COAP_RESOURCE_INDEX_BUCKETS
+  index_resource(resource);
+#endif /* COAP_RESOURCE_INDEX_BUCKETS */
 
   LOG_INFO("Activating: %s\n", resource->url);
 
@@ -446,6 +533,52 @@ coap_get_next_resource(coap_resource_t *resource)
   return list_item_next(resource);
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * A resource whose URI path equals that of the request takes precedence over
+ * a resource with sub-resources. Among the latter, the one with the longest
+ * URI path wins.
+ */
+static coap_resource_t *
+find_resource(const char *url, int url_len)
+{
+#if COAP_RESOURCE_INDEX_BUCKETS
+  /* hash the URI path, looking up parent resources at each '/' */
+  coap_resource_t *parent = NULL;
+  uint32_t hash = HASH_OFFSET_BASIS;
+  for(int i = 0; i < url_len; i++) {
+    if(url[i] == '/') {
+      coap_resource_t *resource = lookup_resource(hash, url, i, true);
+      if(resource) {
+        parent = resource;
+      }
+    }
+    hash = hash_update(hash, url[i]);
+  }
+  coap_resource_t *resource = lookup_resource(hash, url, url_len, false);
+  return resource ? resource : parent;
+#else /* COAP_RESOURCE_INDEX_BUCKETS */
+  coap_resource_t *parent = NULL;
+  int parent_url_len = 0;
+  for(coap_resource_t *resource = list_head(coap_resource_services);
+      resource; resource = resource->next) {
+    int res_url_len = strlen(resource->url);
+    if(url_len == res_url_len) {
+      if(!memcmp(resource->url, url, res_url_len)) {
+        return resource;
+      }
+    } else if(url_len > res_url_len
+              && (resource->flags & HAS_SUB_RESOURCES)
+              && url[res_url_len] == '/'
+              && (!parent || (res_url_len > parent_url_len))
+              && !memcmp(resource->url, url, res_url_len)) {
+      parent = resource;
+      parent_url_len = res_url_len;
+    }
+  }
+  return parent;
+#endif /* COAP_RESOURCE_INDEX_BUCKETS */
+}
+/*---------------------------------------------------------------------------*/
 static int
 invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
                              uint8_t *buffer, uint16_t buffer_size,
@@ -456,44 +589,34 @@ invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
 
   coap_resource_t *resource = NULL;
   const char *url = NULL;
-  int url_len, res_url_len;
+  int url_len;
 
   url_len = coap_get_header_uri_path(request, &url);
-  for(resource = list_head(coap_resource_services);
-      resource; resource = resource->next) {
-
-    /* if the web service handles that kind of requests and urls matches */
-    res_url_len = strlen(resource->url);
-    if((url_len == res_url_len
-        || (url_len > res_url_len
-            && (resource->flags & HAS_SUB_RESOURCES)
-            && url[res_url_len] == '/'))
-       && strncmp(resource->url, url, res_url_len) == 0) {
-      coap_resource_flags_t method = coap_get_method_type(request);
-      found = 1;
-
-      LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
-               (uint16_t)method, resource->flags);
-
-      if((method & METHOD_GET) && resource->get_handler != NULL) {
-        /* call handler function */
-        resource->get_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_POST) && resource->post_handler != NULL) {
-        /* call handler function */
-        resource->post_handler(request, response, buffer, buffer_size,
+  resource = find_resource(url, url_len);
+  if(resource) {
+    coap_resource_flags_t method = coap_get_method_type(request);
+    found = 1;
+
+    LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
+             (uint16_t)method, resource->flags);
+
+    if((method & METHOD_GET) && resource->get_handler != NULL) {
+      /* call handler function */
+      resource->get_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_POST) && resource->post_handler != NULL) {
+      /* call handler function */
+      resource->post_handler(request, response, buffer, buffer_size,
+                             offset);
+    } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
+      /* call handler function */
+      resource->put_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
+      /* call handler function */
+      resource->delete_handler(request, response, buffer, buffer_size,
                                offset);
-      } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
-        /* call handler function */
-        resource->put_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
-        /* call handler function */
-        resource->delete_handler(request, response, buffer, buffer_size,
-                                 offset);
-      } else {
-        allowed = 0;
-        coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
-      }
-      break;
+    } else {
+      allowed = 0;
+      coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
     }
   }
   if(!found) {
@@ -111,6 +111,9 @@ struct coap_resource_s {
     coap_resource_trigger_handler_t trigger;
     coap_resource_trigger_handler_t resume;
   };
+#if COAP_RESOURCE_INDEX_BUCKETS
+  coap_resource_t *bucket_next;     /* next resource in the same hash bucket */
+#endif /* COAP_RESOURCE_INDEX_BUCKETS */
 };
 
 struct coap_periodic_resource_s {
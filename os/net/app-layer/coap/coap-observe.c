@@ -47,15 +47,32 @@
 #include "coap-engine.h"
 #include "lib/memb.h"
 #include "lib/list.h"
+#include "sys/cc.h"
+#include <stdbool.h>
 
 /* Log configuration */
 #include "coap-log.h"
 #define LOG_MODULE "coap"
 #define LOG_LEVEL  LOG_LEVEL_COAP
 
+#if COAP_OBSERVE_MIN_INTERVAL
+typedef struct {
+  coap_resource_t *resource;
+  uint64_t due;
+  char url[COAP_OBSERVER_URL_LEN];
+  bool is_used;
+} pending_notification_t;
+
+static void send_pending_notifications(coap_timer_t *timer);
+#endif /* COAP_OBSERVE_MIN_INTERVAL */
+
 /*---------------------------------------------------------------------------*/
 MEMB(observers_memb, coap_observer_t, COAP_MAX_OBSERVERS);
 LIST(observers_list);
+#if COAP_OBSERVE_MIN_INTERVAL
+static pending_notification_t pending_notifications[COAP_OBSERVE_MAX_PENDING];
+static coap_timer_t pending_timer;
+#endif /* COAP_OBSERVE_MIN_INTERVAL */
 /*---------------------------------------------------------------------------*/
 /*- Internal API ------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -79,6 +96,10 @@ add_observer(const coap_endpoint_t *endpoint, const uint8_t *token,
     o->token_len = token_len;
     memcpy(o->token, token, token_len);
     o->last_mid = 0;
+#if COAP_OBSERVE_MIN_INTERVAL
+    /* the response to the registration counts as a notification */
+    o->last_notified_at = coap_timer_uptime();
+#endif /* COAP_OBSERVE_MIN_INTERVAL */
 
     LOG_INFO("Adding observer (%u/%u) for /%s [0x%02X%02X]\n",
              list_length(observers_list) + 1, COAP_MAX_OBSERVERS,
@@ -185,35 +206,34 @@ coap_notify_observers(coap_resource_t *resource)
 {
   coap_notify_observers_sub(resource, NULL);
 }
-/* Can be used either for sub - or when there is not resource - just
-   a handler */
-void
-coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
+/*---------------------------------------------------------------------------*/
+static bool
+is_observing(const coap_observer_t *obs, const char *url, int url_len,
+             uint8_t sub_ok)
+{
+  int obs_url_len = strlen(obs->url);
+
+  /* Do a match based on the parent/sub-resource match so that it is
+     possible to do parent-node observe */
+  return (obs_url_len == url_len
+          || (obs_url_len > url_len
+              && sub_ok
+              && obs->url[url_len] == '/'))
+         && strncmp(url, obs->url, url_len) == 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_notifications(coap_resource_t *resource, const char *url)
 {
-  /* build notification */
+  /* not static since handlers may notify observers in turn */
   coap_message_t notification[1]; /* this way the message can be treated as pointer as usual */
   coap_message_t request[1]; /* this way the message can be treated as pointer as usual */
+  uint8_t payload[COAP_MAX_CHUNK_SIZE];
   coap_observer_t *obs = NULL;
-  int url_len, obs_url_len;
-  char url[COAP_OBSERVER_URL_LEN];
+  int url_len;
   uint8_t sub_ok = 0;
+  bool is_rendered = false;
 
-  if(resource != NULL) {
-    url_len = strlen(resource->url);
-    strncpy(url, resource->url, COAP_OBSERVER_URL_LEN - 1);
-    if(url_len < COAP_OBSERVER_URL_LEN - 1 && subpath != NULL) {
-      strncpy(&url[url_len], subpath, COAP_OBSERVER_URL_LEN - url_len - 1);
-    }
-  } else if(subpath != NULL) {
-    strncpy(url, subpath, COAP_OBSERVER_URL_LEN - 1);
-  } else {
-    /* No resource, no subpath */
-    return;
-  }
-
-  /* Ensure url is null terminated because strncpy does not guarantee this */
-  url[COAP_OBSERVER_URL_LEN - 1] = '\0';
-  /* url now contains the notify URL that needs to match the observer */
   LOG_INFO("Notification from %s\n", url);
 
   coap_init_message(notification, COAP_TYPE_NON, CONTENT_2_05, 0);
@@ -227,28 +247,48 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
   sub_ok = (resource == NULL) || (resource->flags & HAS_SUB_RESOURCES);
   for(obs = (coap_observer_t *)list_head(observers_list); obs;
       obs = obs->next) {
-    obs_url_len = strlen(obs->url);
-
-    /* Do a match based on the parent/sub-resource match so that it is
-       possible to do parent-node observe */
-
-    /***** TODO fix here so that we handle the notofication correctly ******/
-    /* All the new-style ... is assuming that the URL might be within */
-    if((obs_url_len == url_len
-        || (obs_url_len > url_len
-            && sub_ok
-            && obs->url[url_len] == '/'))
-       && strncmp(url, obs->url, url_len) == 0) {
+    if(is_observing(obs, url, url_len, sub_ok)) {
       coap_transaction_t *transaction = NULL;
 
-      /*TODO implement special transaction for CON, sharing the same buffer to allow for more observers */
-
       if((transaction = coap_new_transaction(coap_get_mid(), &obs->endpoint))) {
+        /* all observers get the same representation, so render it once */
+        if(!is_rendered) {
+          int32_t new_offset = 0;
+
+          /* Either old style get_handler or the full handler */
+          if(coap_call_handlers(request, notification, payload,
+                                COAP_MAX_CHUNK_SIZE, &new_offset) > 0) {
+            LOG_DBG("Notification on new handlers\n");
+          } else {
+            if(resource != NULL) {
+              resource->get_handler(request, notification, payload,
+                                    COAP_MAX_CHUNK_SIZE, &new_offset);
+            } else {
+              /* What to do here? */
+              notification->code = BAD_REQUEST_4_00;
+            }
+          }
+
+          if(new_offset != 0) {
+            coap_set_header_block2(notification,
+                                   0,
+                                   new_offset != -1,
+                                   COAP_MAX_BLOCK_SIZE);
+            coap_set_payload(notification,
+                             notification->payload,
+                             MIN(notification->payload_len,
+                                 COAP_MAX_BLOCK_SIZE));
+          }
+          is_rendered = true;
+        }
+
         /* if COAP_OBSERVE_REFRESH_INTERVAL is zero, never send observations as confirmable messages */
         if(COAP_OBSERVE_REFRESH_INTERVAL != 0
             && (obs->obs_counter % COAP_OBSERVE_REFRESH_INTERVAL == 0)) {
           LOG_DBG("           Force Confirmable for\n");
           notification->type = COAP_TYPE_CON;
+        } else {
+          notification->type = COAP_TYPE_NON;
         }
 
         LOG_DBG("           Observer ");
@@ -257,28 +297,13 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
 
         /* update last MID for RST matching */
         obs->last_mid = transaction->mid;
+#if COAP_OBSERVE_MIN_INTERVAL
+        obs->last_notified_at = coap_timer_uptime();
+#endif /* COAP_OBSERVE_MIN_INTERVAL */
 
         /* prepare response */
         notification->mid = transaction->mid;
 
-	int32_t new_offset = 0;
-
-        /* Either old style get_handler or the full handler */
-        if(coap_call_handlers(request, notification, transaction->message +
-                              COAP_MAX_HEADER_SIZE, COAP_MAX_CHUNK_SIZE,
-                              &new_offset) > 0) {
-          LOG_DBG("Notification on new handlers\n");
-        } else {
-          if(resource != NULL) {
-            resource->get_handler(request, notification,
-                                  transaction->message + COAP_MAX_HEADER_SIZE,
-                                  COAP_MAX_CHUNK_SIZE, &new_offset);
-          } else {
-            /* What to do here? */
-            notification->code = BAD_REQUEST_4_00;
-          }
-        }
-
         if(notification->code < BAD_REQUEST_4_00) {
           coap_set_header_observe(notification, (obs->obs_counter)++);
           /* mask out to keep the CoAP observe option length <= 3 bytes */
@@ -286,17 +311,6 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
         }
         coap_set_token(notification, obs->token, obs->token_len);
 
-	if(new_offset != 0) {
-	  coap_set_header_block2(notification,
-				 0,
-				 new_offset != -1,
-				 COAP_MAX_BLOCK_SIZE);
-	  coap_set_payload(notification,
-			   notification->payload,
-			   MIN(notification->payload_len,
-			       COAP_MAX_BLOCK_SIZE));
-	}
-
         transaction->message_len =
           coap_serialize_message(notification, transaction->message);
 
@@ -306,6 +320,122 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if COAP_OBSERVE_MIN_INTERVAL
+static void
+schedule_pending_notifications(void)
+{
+  pending_notification_t *next = NULL;
+  uint64_t now;
+
+  for(size_t i = 0; i < COAP_OBSERVE_MAX_PENDING; i++) {
+    if(pending_notifications[i].is_used
+       && (!next || (pending_notifications[i].due < next->due))) {
+      next = pending_notifications + i;
+    }
+  }
+  if(!next) {
+    coap_timer_stop(&pending_timer);
+    return;
+  }
+
+  now = coap_timer_uptime();
+  coap_timer_set_callback(&pending_timer, send_pending_notifications);
+  coap_timer_set(&pending_timer, next->due > now ? next->due - now : 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_pending_notifications(coap_timer_t *timer)
+{
+  uint64_t now = coap_timer_uptime();
+
+  for(size_t i = 0; i < COAP_OBSERVE_MAX_PENDING; i++) {
+    if(pending_notifications[i].is_used
+       && (pending_notifications[i].due <= now)) {
+      pending_notifications[i].is_used = false;
+      send_notifications(pending_notifications[i].resource,
+                         pending_notifications[i].url);
+    }
+  }
+  schedule_pending_notifications();
+}
+/*---------------------------------------------------------------------------*/
+/* returns false if the notification is to be sent right away */
+static bool
+defer_notification(coap_resource_t *resource, const char *url)
+{
+  coap_observer_t *obs;
+  pending_notification_t *pending = NULL;
+  int url_len = strlen(url);
+  uint8_t sub_ok = (resource == NULL) || (resource->flags & HAS_SUB_RESOURCES);
+  uint64_t due = 0;
+
+  for(obs = (coap_observer_t *)list_head(observers_list); obs;
+      obs = obs->next) {
+    if(is_observing(obs, url, url_len, sub_ok)) {
+      due = MAX(due, obs->last_notified_at + COAP_OBSERVE_MIN_INTERVAL);
+    }
+  }
+  if(due <= coap_timer_uptime()) {
+    return false;
+  }
+
+  for(size_t i = 0; i < COAP_OBSERVE_MAX_PENDING; i++) {
+    if(!pending_notifications[i].is_used) {
+      pending = pending_notifications + i;
+    } else if(pending_notifications[i].resource == resource
+              && !strcmp(pending_notifications[i].url, url)) {
+      /* the latest representation will be rendered once due */
+      return true;
+    }
+  }
+  if(!pending) {
+    LOG_WARN("Too many pending notifications\n");
+    return false;
+  }
+
+  LOG_DBG("Deferring notification from %s\n", url);
+  pending->resource = resource;
+  strcpy(pending->url, url);
+  pending->due = due;
+  pending->is_used = true;
+  schedule_pending_notifications();
+  return true;
+}
+#endif /* COAP_OBSERVE_MIN_INTERVAL */
+/*---------------------------------------------------------------------------*/
+/* Can be used either for sub - or when there is not resource - just
+   a handler */
+void
+coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
+{
+  int url_len;
+  char url[COAP_OBSERVER_URL_LEN];
+
+  if(resource != NULL) {
+    url_len = strlen(resource->url);
+    strncpy(url, resource->url, COAP_OBSERVER_URL_LEN - 1);
+    if(url_len < COAP_OBSERVER_URL_LEN - 1 && subpath != NULL) {
+      strncpy(&url[url_len], subpath, COAP_OBSERVER_URL_LEN - url_len - 1);
+    }
+  } else if(subpath != NULL) {
+    strncpy(url, subpath, COAP_OBSERVER_URL_LEN - 1);
+  } else {
+    /* No resource, no subpath */
+    return;
+  }
+
+  /* Ensure url is null terminated because strncpy does not guarantee this */
+  url[COAP_OBSERVER_URL_LEN - 1] = '\0';
+  /* url now contains the notify URL that needs to match the observer */
+
+#if COAP_OBSERVE_MIN_INTERVAL
+  if(defer_notification(resource, url)) {
+    return;
+  }
+#endif /* COAP_OBSERVE_MIN_INTERVAL */
+  send_notifications(resource, url);
+}
+/*---------------------------------------------------------------------------*/
 void
 coap_observe_handler(const coap_resource_t *resource, coap_message_t *coap_req,
                      coap_message_t *coap_res)
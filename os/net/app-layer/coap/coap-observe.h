@@ -61,6 +61,9 @@ typedef struct coap_observer {
 
   coap_timer_t retrans_timer;
   uint8_t retrans_counter;
+#if COAP_OBSERVE_MIN_INTERVAL
+  uint64_t last_notified_at;
+#endif /* COAP_OBSERVE_MIN_INTERVAL */
 } coap_observer_t;
 
 void coap_remove_observer(coap_observer_t *o);
@@ -47,16 +47,54 @@
 #include "lib/memb.h"
 #include "lib/list.h"
 #include "lib/random.h"
+#include "sys/cc.h"
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* Log configuration */
 #include "coap-log.h"
 #define LOG_MODULE "coap"
 #define LOG_LEVEL  LOG_LEVEL_COAP
 
+#if COAP_WITH_TRANSACTION_STATS
+#define STATS_INC(field) (coap_transaction_stats.field++)
+#else /* COAP_WITH_TRANSACTION_STATS */
+#define STATS_INC(field)
+#endif /* COAP_WITH_TRANSACTION_STATS */
+
+#if COAP_WITH_CONGESTION_CONTROL
+#define STRONG_K (4)
+#define WEAK_K (1)
+#define MAX_RTO (60 * 1000)
+#define SMALL_RTO (1000)
+#define LARGE_RTO (3000)
+
+struct rtt_estimator {
+  uint32_t srtt;
+  uint32_t rttvar;
+};
+
+struct coap_peer {
+  coap_endpoint_t endpoint;
+  struct rtt_estimator strong;
+  struct rtt_estimator weak;
+  uint64_t updated_at;
+  uint32_t rto; /* 0 if this slot is unused */
+  uint8_t transactions; /* outstanding and deferred ones */
+  uint8_t outstanding;
+};
+#endif /* COAP_WITH_CONGESTION_CONTROL */
+
 /*---------------------------------------------------------------------------*/
 MEMB(transactions_memb, coap_transaction_t, COAP_MAX_OPEN_TRANSACTIONS);
 LIST(transactions_list);
+#if COAP_WITH_CONGESTION_CONTROL
+static struct coap_peer peers[COAP_MAX_PEERS];
+#endif /* COAP_WITH_CONGESTION_CONTROL */
+#if COAP_WITH_TRANSACTION_STATS
+struct coap_transaction_stats coap_transaction_stats;
+#endif /* COAP_WITH_TRANSACTION_STATS */
 
 /*---------------------------------------------------------------------------*/
 static void
@@ -72,6 +110,127 @@ coap_retransmit_transaction(coap_timer_t *nt)
   coap_send_transaction(t);
 }
 /*---------------------------------------------------------------------------*/
+#if COAP_WITH_CONGESTION_CONTROL
+static struct coap_peer *
+get_peer(const coap_endpoint_t *endpoint)
+{
+  struct coap_peer *victim = NULL;
+
+  for(struct coap_peer *peer = peers; peer < peers + COAP_MAX_PEERS; peer++) {
+    if(!peer->rto) {
+      victim = peer;
+    } else if(coap_endpoint_cmp(&peer->endpoint, endpoint)) {
+      return peer;
+    } else if(!peer->transactions
+              && (!victim
+                  || (victim->rto && (peer->updated_at < victim->updated_at)))) {
+      /* replace the least recently updated peer without transactions */
+      victim = peer;
+    }
+  }
+
+  if(victim) {
+    memset(victim, 0, sizeof(*victim));
+    coap_endpoint_copy(&victim->endpoint, endpoint);
+    victim->rto = COAP_RESPONSE_TIMEOUT_TICKS;
+    victim->updated_at = coap_timer_uptime();
+  }
+  return victim;
+}
+/*---------------------------------------------------------------------------*/
+static void
+age_rto(struct coap_peer *peer, uint64_t now)
+{
+  if((peer->rto < SMALL_RTO) && (now - peer->updated_at > 16 * peer->rto)) {
+    peer->rto *= 2;
+    peer->updated_at = now;
+  } else if((peer->rto > LARGE_RTO)
+            && (now - peer->updated_at > 4 * peer->rto)) {
+    peer->rto = (COAP_RESPONSE_TIMEOUT_TICKS + peer->rto) / 2;
+    peer->updated_at = now;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+update_estimator(struct rtt_estimator *estimator, uint32_t rtt, uint32_t k)
+{
+  if(!estimator->srtt) {
+    estimator->srtt = rtt;
+    estimator->rttvar = rtt / 2;
+  } else {
+    uint32_t delta = estimator->srtt > rtt
+                     ? estimator->srtt - rtt
+                     : rtt - estimator->srtt;
+    estimator->rttvar = (3 * estimator->rttvar + delta) / 4;
+    estimator->srtt = (7 * estimator->srtt + rtt) / 8;
+  }
+  return estimator->srtt + k * estimator->rttvar;
+}
+/*---------------------------------------------------------------------------*/
+/* returns false if the transaction has to wait for outstanding ones */
+static bool
+start_transaction(coap_transaction_t *t)
+{
+  uint32_t rto;
+
+  if(!t->peer) {
+    t->peer = get_peer(&t->endpoint);
+    if(!t->peer) {
+      LOG_DBG("Not tracking transaction %u\n", t->mid);
+      t->retrans_interval =
+        COAP_RESPONSE_TIMEOUT_TICKS + (random_rand() %
+                                       COAP_RESPONSE_TIMEOUT_BACKOFF_MASK);
+      t->backoff_factor = 4;
+      return true;
+    }
+    t->peer->transactions++;
+  }
+
+  if(t->peer->outstanding >= COAP_NSTART) {
+    if(!t->is_deferred) {
+      LOG_DBG("Deferring transaction %u\n", t->mid);
+      STATS_INC(deferrals);
+      t->is_deferred = 1;
+    }
+    return false;
+  }
+  t->is_deferred = 0;
+  t->peer->outstanding++;
+  t->sent_at = coap_timer_uptime();
+
+  /* dither between RTO and 1.5 * RTO */
+  age_rto(t->peer, t->sent_at);
+  rto = t->peer->rto;
+  t->retrans_interval = rto + (random_rand() % (rto / 2 + 1));
+  if(rto < SMALL_RTO) {
+    t->backoff_factor = 6;
+  } else if(rto > LARGE_RTO) {
+    t->backoff_factor = 3;
+  } else {
+    t->backoff_factor = 4;
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static void
+finish_transaction(struct coap_peer *peer, bool was_deferred)
+{
+  peer->transactions--;
+  if(was_deferred) {
+    return;
+  }
+  peer->outstanding--;
+
+  /* send the oldest deferred transaction to this peer */
+  for(coap_transaction_t *t = list_head(transactions_list); t; t = t->next) {
+    if((t->peer == peer) && t->is_deferred) {
+      coap_send_transaction(t);
+      return;
+    }
+  }
+}
+#endif /* COAP_WITH_CONGESTION_CONTROL */
+/*---------------------------------------------------------------------------*/
 
 /*---------------------------------------------------------------------------*/
 /*- Internal API ------------------------------------------------------------*/
@@ -84,6 +243,10 @@ coap_new_transaction(uint16_t mid, const coap_endpoint_t *endpoint)
   if(t) {
     t->mid = mid;
     t->retrans_counter = 0;
+#if COAP_WITH_CONGESTION_CONTROL
+    t->peer = NULL;
+    t->is_deferred = 0;
+#endif /* COAP_WITH_CONGESTION_CONTROL */
 
     /* save client address */
     coap_endpoint_copy(&t->endpoint, endpoint);
@@ -101,23 +264,39 @@ coap_send_transaction(coap_transaction_t *t)
 
   if(COAP_TYPE_CON ==
      ((COAP_HEADER_TYPE_MASK & t->message[0]) >> COAP_HEADER_TYPE_POSITION)) {
+#if COAP_WITH_CONGESTION_CONTROL
+    if((t->retrans_counter == 0) && !start_transaction(t)) {
+      return;
+    }
+#endif /* COAP_WITH_CONGESTION_CONTROL */
     if(t->retrans_counter <= COAP_MAX_RETRANSMIT) {
       /* not timed out yet */
       coap_sendto(&t->endpoint, t->message, t->message_len);
       LOG_DBG("Keeping transaction %u\n", t->mid);
 
       if(t->retrans_counter == 0) {
+        STATS_INC(transmissions);
         coap_timer_set_callback(&t->retrans_timer, coap_retransmit_transaction);
         coap_timer_set_user_data(&t->retrans_timer, t);
+#if !COAP_WITH_CONGESTION_CONTROL
         t->retrans_interval =
           COAP_RESPONSE_TIMEOUT_TICKS + (random_rand() %
                                          COAP_RESPONSE_TIMEOUT_BACKOFF_MASK);
+#endif /* !COAP_WITH_CONGESTION_CONTROL */
         LOG_DBG("Initial interval %lu msec\n",
                 (unsigned long)t->retrans_interval);
       } else {
+        STATS_INC(retransmissions);
+#if COAP_WITH_CONGESTION_CONTROL
+        t->retrans_interval = MIN(MAX_RTO,
+                                  t->retrans_interval * t->backoff_factor / 2);
+        LOG_DBG("Backed off (%u) interval %lu msec\n", t->retrans_counter,
+                (unsigned long)t->retrans_interval);
+#else /* COAP_WITH_CONGESTION_CONTROL */
         t->retrans_interval <<= 1;  /* double */
         LOG_DBG("Doubled (%u) interval %lu s\n", t->retrans_counter,
                 (unsigned long)(t->retrans_interval / 1000));
+#endif /* COAP_WITH_CONGESTION_CONTROL */
       }
 
       /* interval updated above */
@@ -125,6 +304,7 @@ coap_send_transaction(coap_transaction_t *t)
     } else {
       /* timed out */
       LOG_DBG("Timeout\n");
+      STATS_INC(timeouts);
       coap_resource_response_handler_t callback = t->callback;
       void *callback_data = t->callback_data;
 
@@ -149,10 +329,51 @@ coap_clear_transaction(coap_transaction_t *t)
   if(t) {
     LOG_DBG("Freeing transaction %u: %p\n", t->mid, t);
 
+#if COAP_WITH_CONGESTION_CONTROL
+    struct coap_peer *peer = t->peer;
+    bool was_deferred = t->is_deferred;
+#endif /* COAP_WITH_CONGESTION_CONTROL */
+
     coap_timer_stop(&t->retrans_timer);
     list_remove(transactions_list, t);
     memb_free(&transactions_memb, t);
+
+#if COAP_WITH_CONGESTION_CONTROL
+    if(peer) {
+      finish_transaction(peer, was_deferred);
+    }
+#endif /* COAP_WITH_CONGESTION_CONTROL */
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+coap_acknowledge_transaction(coap_transaction_t *t)
+{
+#if COAP_WITH_CONGESTION_CONTROL
+  /*
+   * Responses to the first transmission feed the strong estimator. Those
+   * after one or two retransmissions may belong to any transmission and
+   * only feed the weak estimator.
+   */
+  if(t->peer && !t->is_deferred && (t->retrans_counter <= 2)) {
+    struct coap_peer *peer = t->peer;
+    uint64_t now = coap_timer_uptime();
+    uint32_t rtt = MAX(1, now - t->sent_at);
+
+    if(!t->retrans_counter) {
+      peer->rto = (update_estimator(&peer->strong, rtt, STRONG_K)
+                   + peer->rto) / 2;
+    } else {
+      peer->rto = (update_estimator(&peer->weak, rtt, WEAK_K)
+                   + 3 * peer->rto) / 4;
+    }
+    peer->rto = MIN(MAX_RTO, peer->rto);
+    peer->updated_at = now;
+    LOG_DBG("RTT %lu msec, RTO %lu msec\n",
+            (unsigned long)rtt, (unsigned long)peer->rto);
   }
+#endif /* COAP_WITH_CONGESTION_CONTROL */
+  coap_clear_transaction(t);
 }
 /*---------------------------------------------------------------------------*/
 coap_transaction_t *
@@ -55,6 +55,19 @@
 #define COAP_RESPONSE_TIMEOUT_TICKS         (1000 * COAP_RESPONSE_TIMEOUT)
 #define COAP_RESPONSE_TIMEOUT_BACKOFF_MASK  (uint32_t)(((1000 * COAP_RESPONSE_TIMEOUT * ((float)COAP_RESPONSE_RANDOM_FACTOR - 1.0)) + 0.5) + 1)
 
+#if COAP_WITH_TRANSACTION_STATS
+struct coap_transaction_stats {
+  uint32_t transmissions;
+  uint32_t retransmissions;
+  uint32_t timeouts;
+  uint32_t deferrals;
+};
+
+extern struct coap_transaction_stats coap_transaction_stats;
+#endif /* COAP_WITH_TRANSACTION_STATS */
+
+struct coap_peer;
+
 /* container for transactions with message buffer and retransmission info */
 typedef struct coap_transaction {
   struct coap_transaction *next;        /* for LIST */
@@ -63,6 +76,12 @@ typedef struct coap_transaction {
   coap_timer_t retrans_timer;
   uint32_t retrans_interval;
   uint8_t retrans_counter;
+#if COAP_WITH_CONGESTION_CONTROL
+  struct coap_peer *peer;               /* NULL if not tracked */
+  uint64_t sent_at;                     /* of the first transmission */
+  uint8_t backoff_factor;               /* in halves */
+  uint8_t is_deferred;
+#endif /* COAP_WITH_CONGESTION_CONTROL */
 
   coap_endpoint_t endpoint;
 
@@ -77,6 +96,7 @@ typedef struct coap_transaction {
 coap_transaction_t *coap_new_transaction(uint16_t mid, const coap_endpoint_t *ep);
 void coap_send_transaction(coap_transaction_t *t);
 void coap_clear_transaction(coap_transaction_t *t);
+void coap_acknowledge_transaction(coap_transaction_t *t);
 coap_transaction_t *coap_get_transaction_by_mid(uint16_t mid);
 
 #endif /* COAP_TRANSACTIONS_H_ */
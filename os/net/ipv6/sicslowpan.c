@@ -226,23 +226,37 @@ static uint16_t my_tag;
 
 /** The total length of the IPv6 packet in the sicslowpan_buf. */
 
+/* REASS_CONTEXTS corresponds to the number of simultaneous
+ * reassemblies that can be made. The fragments themselves are stored
+ * in chunks that all contexts share, so a context is cheap.
+ **/
+#ifdef SICSLOWPAN_CONF_REASS_CONTEXTS
+#define SICSLOWPAN_REASS_CONTEXTS SICSLOWPAN_CONF_REASS_CONTEXTS
+#else
+#define SICSLOWPAN_REASS_CONTEXTS 4
+#endif
+
 /* This needs to be defined in NBR / Nodes depending on available RAM   */
 /*   and expected reassembly requirements                               */
-#ifdef SICSLOWPAN_CONF_FRAGMENT_BUFFERS
-#define SICSLOWPAN_FRAGMENT_BUFFERS SICSLOWPAN_CONF_FRAGMENT_BUFFERS
+#ifdef SICSLOWPAN_CONF_FRAG_CHUNKS
+#define SICSLOWPAN_FRAG_CHUNKS SICSLOWPAN_CONF_FRAG_CHUNKS
 #else
-#define SICSLOWPAN_FRAGMENT_BUFFERS 12
+#define SICSLOWPAN_FRAG_CHUNKS 44
 #endif
 
-/* REASS_CONTEXTS corresponds to the number of simultaneous
- * reassemblies that can be made. NOTE: the first buffer for each
- * reassembly is stored in the context since it can be larger than the
- * rest of the fragments due to header compression.
- **/
-#ifdef SICSLOWPAN_CONF_REASS_CONTEXTS
-#define SICSLOWPAN_REASS_CONTEXTS SICSLOWPAN_CONF_REASS_CONTEXTS
+/* The number of bytes that each chunk can hold */
+#ifdef SICSLOWPAN_CONF_FRAG_CHUNK_SIZE
+#define SICSLOWPAN_FRAG_CHUNK_SIZE SICSLOWPAN_CONF_FRAG_CHUNK_SIZE
 #else
-#define SICSLOWPAN_REASS_CONTEXTS 2
+#define SICSLOWPAN_FRAG_CHUNK_SIZE 32
+#endif
+
+#if SICSLOWPAN_REASS_CONTEXTS > 127
+#error Too many SICSLOWPAN_REASS_CONTEXTS set.
+#endif
+
+#if SICSLOWPAN_FRAG_CHUNK_SIZE > 255
+#error Too large SICSLOWPAN_FRAG_CHUNK_SIZE set.
 #endif
 
 /* The size of each fragment (IP payload) for the 6lowpan fragmentation */
@@ -258,15 +272,35 @@ static uint16_t my_tag;
 #error Too large SICSLOWPAN_FRAGMENT_SIZE set.
 #endif
 
-/* Assuming that the worst growth for uncompression is 38 bytes */
-#define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
-
 #ifdef SICSLOWPAN_CONF_WITH_DEDUPLICATION
 #define WITH_DEDUPLICATION SICSLOWPAN_CONF_WITH_DEDUPLICATION
 #else /* SICSLOWPAN_CONF_WITH_DEDUPLICATION */
 #define WITH_DEDUPLICATION 0
 #endif /* SICSLOWPAN_CONF_WITH_DEDUPLICATION */
 
+/*
+ * Fragment forwarding as per RFC 8930. Instead of reassembling
+ * datagrams that are routed through this node, the first fragment is
+ * forwarded right away and a virtual reassembly buffer (VRB) entry
+ * remembers where to send the subsequent fragments.
+ */
+#ifdef SICSLOWPAN_CONF_FRAG_FORWARDING
+#define WITH_FRAG_FORWARDING (SICSLOWPAN_CONF_FRAG_FORWARDING && UIP_CONF_ROUTER)
+#else /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+#define WITH_FRAG_FORWARDING 0
+#endif /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+
+#if WITH_FRAG_FORWARDING && WITH_MESH_ADDRESSING
+#error Fragment forwarding is only supported with route-over
+#endif /* WITH_FRAG_FORWARDING && WITH_MESH_ADDRESSING */
+
+/* The number of datagrams that can be forwarded simultaneously */
+#ifdef SICSLOWPAN_CONF_VRB_ENTRIES
+#define SICSLOWPAN_VRB_ENTRIES SICSLOWPAN_CONF_VRB_ENTRIES
+#else /* SICSLOWPAN_CONF_VRB_ENTRIES */
+#define SICSLOWPAN_VRB_ENTRIES 4
+#endif /* SICSLOWPAN_CONF_VRB_ENTRIES */
+
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
   /** When reassembling, the source address of the fragments being merged */
@@ -280,26 +314,76 @@ struct sicslowpan_frag_info {
   /** Reassembly %process %timer. */
   struct timer reass_timer;
 
-  /** Fragment size of first fragment */
+  /** Uncompressed size of the first fragment, or zero if it is yet to
+      be received. Subsequent fragments may arrive before the first. */
   uint16_t first_frag_len;
-  /** First fragment - needs a larger buffer since the size is uncompressed size
-   and we need to know total size to know when we have received last fragment. */
-  uint8_t first_frag[SICSLOWPAN_FIRST_FRAGMENT_SIZE];
 };
 
 static struct sicslowpan_frag_info frag_info[SICSLOWPAN_REASS_CONTEXTS];
 
-struct sicslowpan_frag_buf {
+struct sicslowpan_frag_chunk {
   /* the index of the frag_info */
   uint8_t index;
-  /* Fragment offset */
-  uint8_t offset;
-  /* Length of this fragment (if zero this buffer is not allocated) */
+  /* Length of this chunk (if zero this chunk is not allocated) */
   uint8_t len;
-  uint8_t data[SICSLOWPAN_FRAGMENT_SIZE];
+  /* Byte offset of this chunk within the reassembled packet */
+  uint16_t offset;
+  uint8_t data[SICSLOWPAN_FRAG_CHUNK_SIZE];
 };
 
-static struct sicslowpan_frag_buf frag_buf[SICSLOWPAN_FRAGMENT_BUFFERS];
+static struct sicslowpan_frag_chunk frag_chunks[SICSLOWPAN_FRAG_CHUNKS];
+
+#if WITH_FRAG_FORWARDING
+struct sicslowpan_vrb_entry {
+  /** The previous hop and its tag */
+  linkaddr_t sender;
+  uint16_t tag;
+  /** The next hop and the tag used toward it */
+  linkaddr_t next_hop;
+  uint16_t next_tag;
+  /** Total length of the fragmented packet, zero if unused */
+  uint16_t len;
+  /** End of the fragments forwarded so far, as a byte offset */
+  uint16_t forwarded_len;
+  struct timer timer;
+#if LLSEC802154_USES_AUX_HEADER
+  /** Security of the received first fragment, applied to all fragments */
+  uint8_t security_level;
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  uint8_t key_id_mode;
+  uint8_t key_index;
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+};
+
+static struct sicslowpan_vrb_entry vrb[SICSLOWPAN_VRB_ENTRIES];
+#endif /* WITH_FRAG_FORWARDING */
+
+/*---------------------------------------------------------------------------*/
+static int8_t
+find_context(uint16_t tag)
+{
+  for(int8_t i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    if(frag_info[i].len > 0 && frag_info[i].tag == tag &&
+       linkaddr_cmp(&frag_info[i].sender,
+                    packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+      return i;
+    }
+  }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+is_stored(uint8_t index, uint16_t offset)
+{
+  for(size_t i = 0; i < SICSLOWPAN_FRAG_CHUNKS; i++) {
+    if(frag_chunks[i].len > 0 && frag_chunks[i].index == index &&
+       frag_chunks[i].offset == offset) {
+      return true;
+    }
+  }
+  return false;
+}
 
 #if WITH_DEDUPLICATION
 #define HISTORY_DEPTH 4
@@ -342,28 +426,15 @@ static bool
 is_duplicate_fragment(uint16_t tag, uint8_t frag_offset)
 {
   const linkaddr_t *sender = packetbuf_addr(PACKETBUF_ADDR_SENDER);
-  bool is_active_tag = false;
-  size_t i;
-  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-    if(frag_info[i].len
-       && tag == frag_info[i].tag
-       && linkaddr_cmp(sender, &frag_info[i].sender)) {
-      is_active_tag = true;
-      break;
-    }
-  }
-  if(is_active_tag) {
+  int8_t i = find_context(tag);
+  if(i >= 0) {
     if(!frag_offset) {
       /* we already received a FRAG1 for this tag */
-      return true;
+      return frag_info[i].first_frag_len > 0;
     }
     /* look for duplicate FRAGN for this tag */
-    for(size_t j = 0; j < SICSLOWPAN_FRAGMENT_BUFFERS; j++) {
-      if(frag_buf[j].len
-         && (frag_buf[j].index == i)
-         && (frag_buf[j].offset == frag_offset)) {
-        return true;
-      }
+    if(is_stored(i, (uint16_t)frag_offset << 3)) {
+      return true;
     }
   }
   /* check if any of the recently reassembled packets had the same tag */
@@ -387,10 +458,10 @@ clear_fragments(uint8_t frag_info_index)
   int i, clear_count;
   clear_count = 0;
   frag_info[frag_info_index].len = 0;
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len > 0 && frag_buf[i].index == frag_info_index) {
-      /* deallocate the buffer */
-      frag_buf[i].len = 0;
+  for(i = 0; i < SICSLOWPAN_FRAG_CHUNKS; i++) {
+    if(frag_chunks[i].len > 0 && frag_chunks[i].index == frag_info_index) {
+      /* deallocate the chunk */
+      frag_chunks[i].len = 0;
       clear_count++;
     }
   }
@@ -412,10 +483,42 @@ timeout_fragments(int not_context)
   return count;
 }
 /*---------------------------------------------------------------------------*/
+/* Splits data into chunks. Either all or none of the data is stored. */
+static bool
+store_chunks(uint8_t index, uint16_t offset, const uint8_t *data, uint16_t len)
+{
+  size_t needed = (len + SICSLOWPAN_FRAG_CHUNK_SIZE - 1)
+                  / SICSLOWPAN_FRAG_CHUNK_SIZE;
+  size_t free_chunks = 0;
+  size_t i;
+
+  for(i = 0; i < SICSLOWPAN_FRAG_CHUNKS && free_chunks < needed; i++) {
+    if(frag_chunks[i].len == 0) {
+      free_chunks++;
+    }
+  }
+  if(free_chunks < needed) {
+    return false;
+  }
+
+  for(i = 0; len > 0; i++) {
+    if(frag_chunks[i].len == 0) {
+      uint8_t chunk_len = MIN(len, SICSLOWPAN_FRAG_CHUNK_SIZE);
+      frag_chunks[i].index = index;
+      frag_chunks[i].offset = offset;
+      frag_chunks[i].len = chunk_len;
+      memcpy(frag_chunks[i].data, data, chunk_len);
+      offset += chunk_len;
+      data += chunk_len;
+      len -= chunk_len;
+    }
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
 static int
 store_fragment(uint8_t index, uint8_t offset)
 {
-  int i;
   int len;
 
   len = packetbuf_datalen() - packetbuf_hdr_len;
@@ -428,121 +531,127 @@ store_fragment(uint8_t index, uint8_t offset)
   /* Reject duplicates: a fragment at this offset is already stored for
      this reassembly context. Counting duplicates toward reassembled_len
      would let the completion check fire with zero-filled gaps. */
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len > 0 && frag_buf[i].index == index &&
-       frag_buf[i].offset == offset) {
-      return 0;
-    }
+  if(is_stored(index, (uint16_t)offset << 3)) {
+    return 0;
   }
 
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len == 0) {
-      /* copy over the data from packetbuf into the fragment buffer,
-         and store offset and len */
-      frag_buf[i].offset = offset; /* frag offset */
-      frag_buf[i].len = len;
-      frag_buf[i].index = index;
-      memcpy(frag_buf[i].data, packetbuf_ptr + packetbuf_hdr_len, len);
-      /* return the length of the stored fragment */
-      return len;
+  if(!store_chunks(index, (uint16_t)offset << 3,
+                   packetbuf_ptr + packetbuf_hdr_len, len)) {
+    /* failed */
+    return -1;
+  }
+  /* return the length of the stored fragment */
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int8_t
+new_context(uint16_t tag, uint16_t frag_size)
+{
+  int i;
+  int8_t found = -1;
+
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    /* clear all fragment info with expired timer to free all chunks */
+    if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
+      clear_fragments(i);
+    }
+
+    /* We use len as indication on used or not used */
+    if(found < 0 && frag_info[i].len == 0) {
+      /* We remember the first free fragment info but must continue
+         the loop to free any other expired chunks. */
+      found = i;
     }
   }
-  /* failed */
-  return -1;
+
+  if(found < 0) {
+    LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
+    return -1;
+  }
+
+  /* Found a free fragment info to store data in. Reset the running
+     reassembly state so that stale values from a previous session on
+     a reused context cannot survive. */
+  frag_info[found].len = frag_size;
+  frag_info[found].reassembled_len = 0;
+  frag_info[found].first_frag_len = 0;
+  frag_info[found].tag = tag;
+  linkaddr_copy(&frag_info[found].sender,
+                packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  timer_set(&frag_info[found].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+  return found;
 }
 /*---------------------------------------------------------------------------*/
 /* add a new fragment to the buffer */
 static int8_t
 add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
 {
-  int i;
   int len;
-  int8_t found = -1;
+  int8_t found = find_context(tag);
 
   if(offset == 0) {
-    /* This is a first fragment - check if we can add this */
-    for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-      /* clear all fragment info with expired timer to free all fragment buffers */
-      if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
-        clear_fragments(i);
-      }
-
-      /* Reuse any existing context for this (sender, tag) so duplicate
-         FRAG1 packets cannot exhaust the reassembly table. */
-      if(frag_info[i].len > 0 && frag_info[i].tag == tag &&
-         linkaddr_cmp(&frag_info[i].sender,
-                      packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
-        clear_fragments(i);
-        found = i;
-        continue;
-      }
-
-      /* We use len as indication on used or not used */
-      if(found < 0 && frag_info[i].len == 0) {
-        /* We remember the first free fragment info but must continue
-           the loop to free any other expired fragment buffers. */
-        found = i;
-      }
+    /* This is a first fragment. Subsequent fragments that arrived
+       earlier are kept, whereas a repeated first fragment restarts
+       the reassembly so that duplicate FRAG1 packets cannot exhaust
+       the reassembly table. */
+    if(found >= 0 && frag_info[found].first_frag_len > 0) {
+      clear_fragments(found);
+      found = -1;
     }
-
     if(found < 0) {
-      LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
-      return -1;
+      found = new_context(tag, frag_size);
     }
-
-    /* Found a free fragment info to store data in. Reset the running
-       reassembly state so that stale values from a previous session on
-       a reused context cannot survive if this FRAG1 later fails to
-       decompress and is never overwritten. */
-    frag_info[found].len = frag_size;
-    frag_info[found].reassembled_len = 0;
-    frag_info[found].first_frag_len = 0;
-    frag_info[found].tag = tag;
-    linkaddr_copy(&frag_info[found].sender,
-                  packetbuf_addr(PACKETBUF_ADDR_SENDER));
-    timer_set(&frag_info[found].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
     /* first fragment can not be stored immediately but is moved into
        the buffer while uncompressing */
     return found;
   }
 
-  /* This is a N-fragment - should find the info */
-  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
-    if(frag_info[i].tag == tag && frag_info[i].len > 0 &&
-       linkaddr_cmp(&frag_info[i].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
-      /* Tag and Sender match - this must be the correct info to store in */
-      found = i;
-      break;
-    }
-  }
-
   if(found < 0) {
-    /* no entry found for storing the new fragment */
-    LOG_WARN("reassembly: failed to store N-fragment - could not find session - tag: %d offset: %d\n", tag, offset);
-    return -1;
+    /* This N-fragment arrived before the first fragment */
+    found = new_context(tag, frag_size);
+    if(found < 0) {
+      LOG_WARN("reassembly: failed to store N-fragment - could not create session - tag: %d offset: %d\n", tag, offset);
+      return -1;
+    }
   }
 
-  /* i is the index of the reassembly context */
-  len = store_fragment(i, offset);
-  if(len < 0 && timeout_fragments(i) > 0) {
-    len = store_fragment(i, offset);
+  len = store_fragment(found, offset);
+  if(len < 0 && timeout_fragments(found) > 0) {
+    len = store_fragment(found, offset);
   }
   if(len > 0) {
-    frag_info[i].reassembled_len += len;
-    return i;
+    frag_info[found].reassembled_len += len;
+    return found;
   } else if(len == 0) {
     /* Duplicate fragment: already stored and accounted for. */
-    return i;
+    return found;
   } else {
     /* should we also clear all fragments since we failed to store
        this fragment? */
-    LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", frag_info[i].tag);
+    LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", frag_info[found].tag);
     return -1;
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Stores the first fragment, whose uncompressed headers and payload
+   are in uip_buf */
+static bool
+store_first_fragment(int8_t context, uint16_t first_frag_len)
+{
+  if(!store_chunks(context, 0, (uint8_t *)UIP_IP_BUF, first_frag_len)
+     && (!timeout_fragments(context)
+         || !store_chunks(context, 0, (uint8_t *)UIP_IP_BUF, first_frag_len))) {
+    LOG_WARN("reassembly: failed to store first fragment - tag: %d\n",
+             frag_info[context].tag);
+    clear_fragments(context);
+    return false;
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
 /* Copy all the fragments that are associated with a specific context
-   into uip */
+   into uip. If the first fragment was not stored, it must be in uip
+   already. */
 static bool
 copy_frags2uip(int context)
 {
@@ -556,24 +665,20 @@ copy_frags2uip(int context)
     return false;
   }
 
-  /* Copy from the fragment context info buffer first */
-  memcpy((uint8_t *)UIP_IP_BUF, (uint8_t *)frag_info[context].first_frag,
-         frag_info[context].first_frag_len);
-
   /* Ensure that no previous data is used for reassembly in case of missing fragments. */
   memset((uint8_t *)UIP_IP_BUF + frag_info[context].first_frag_len, 0,
          frag_info[context].len - frag_info[context].first_frag_len);
 
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    /* And also copy all matching fragments */
-    if(frag_buf[i].len > 0 && frag_buf[i].index == context) {
-      if(((size_t)frag_buf[i].offset << 3) + frag_buf[i].len > sizeof(uip_buf)) {
+  for(i = 0; i < SICSLOWPAN_FRAG_CHUNKS; i++) {
+    /* And also copy all matching chunks */
+    if(frag_chunks[i].len > 0 && frag_chunks[i].index == context) {
+      if((size_t)frag_chunks[i].offset + frag_chunks[i].len > sizeof(uip_buf)) {
         LOG_WARN("input: invalid fragment offset\n");
         clear_fragments(context);
         return false;
       }
-      memcpy((uint8_t *)UIP_IP_BUF + (uint16_t)(frag_buf[i].offset << 3),
-             (uint8_t *)frag_buf[i].data, frag_buf[i].len);
+      memcpy((uint8_t *)UIP_IP_BUF + frag_chunks[i].offset,
+             frag_chunks[i].data, frag_chunks[i].len);
     }
   }
   /* deallocate all the fragments for this context */
@@ -581,6 +686,16 @@ copy_frags2uip(int context)
 
   return true;
 }
+/*---------------------------------------------------------------------------*/
+size_t
+sicslowpan_frag_store_size(void)
+{
+  return sizeof(frag_info) + sizeof(frag_chunks)
+#if WITH_FRAG_FORWARDING
+         + sizeof(vrb)
+#endif /* WITH_FRAG_FORWARDING */
+         ;
+}
 #endif /* SICSLOWPAN_CONF_FRAG */
 
 /* -------------------------------------------------------------------------- */
@@ -1742,11 +1857,16 @@ fragment_copy_payload_and_send(uint16_t uip_offset)
     return 0;
   }
 
+  /* Let the MAC layer share the frame of q rather than copying it. If
+     packetbuf is left untouched, restoring it below is cheap, too. */
+  queuebuf_offer(q);
+
   /* Send fragment */
   send_packet();
 
   /* Restore packetbuf from queuebuf */
   queuebuf_to_packetbuf(q);
+  queuebuf_offer(NULL);
   queuebuf_free(q);
 
   /* Check tx result. */
@@ -2027,6 +2147,415 @@ output(const linkaddr_t *localdest)
   return 1;
 }
 
+#if WITH_FRAG_FORWARDING
+/*--------------------------------------------------------------------*/
+static struct sicslowpan_vrb_entry *
+vrb_lookup(uint16_t tag)
+{
+  for(size_t i = 0; i < SICSLOWPAN_VRB_ENTRIES; i++) {
+    if(vrb[i].len > 0 && vrb[i].tag == tag &&
+       linkaddr_cmp(&vrb[i].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+      if(timer_expired(&vrb[i].timer)) {
+        vrb[i].len = 0;
+        return NULL;
+      }
+      return &vrb[i];
+    }
+  }
+  return NULL;
+}
+/*--------------------------------------------------------------------*/
+static struct sicslowpan_vrb_entry *
+vrb_allocate(void)
+{
+  for(size_t i = 0; i < SICSLOWPAN_VRB_ENTRIES; i++) {
+    if(vrb[i].len == 0 || timer_expired(&vrb[i].timer)) {
+      return &vrb[i];
+    }
+  }
+  return NULL;
+}
+/*--------------------------------------------------------------------*/
+/* Remembers the security of the received fragment in packetbuf */
+static void
+vrb_save_attrs(struct sicslowpan_vrb_entry *entry)
+{
+#if LLSEC802154_USES_AUX_HEADER
+  entry->security_level = packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL);
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  entry->key_id_mode = packetbuf_attr(PACKETBUF_ATTR_KEY_ID_MODE);
+  entry->key_index = packetbuf_attr(PACKETBUF_ATTR_KEY_INDEX);
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+}
+/*--------------------------------------------------------------------*/
+/* Applies the remembered security to the fragment in packetbuf */
+static void
+vrb_restore_attrs(const struct sicslowpan_vrb_entry *entry)
+{
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+#if LLSEC802154_USES_AUX_HEADER
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL, entry->security_level);
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_ID_MODE, entry->key_id_mode);
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_INDEX, entry->key_index);
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+}
+/*--------------------------------------------------------------------*/
+/* Returns the link-layer address of the next hop toward the
+   destination in uip_buf, or NULL if the next hop is not known */
+static const linkaddr_t *
+get_forwarding_next_hop(void)
+{
+  uip_ipaddr_t srh_nexthop;
+  const uip_ipaddr_t *nexthop;
+
+  if(NETSTACK_ROUTING.ext_header_srh_get_next_hop(&srh_nexthop)) {
+    nexthop = &srh_nexthop;
+  } else if(uip_ds6_is_addr_onlink(&UIP_IP_BUF->destipaddr)) {
+    nexthop = &UIP_IP_BUF->destipaddr;
+  } else {
+    uip_ds6_route_t *route = uip_ds6_route_lookup(&UIP_IP_BUF->destipaddr);
+    nexthop = route ? uip_ds6_route_nexthop(route) : uip_ds6_defrt_choose();
+  }
+  if(nexthop == NULL) {
+    return NULL;
+  }
+  return (const linkaddr_t *)uip_ds6_nbr_lladdr_from_ipaddr(nexthop);
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Walks the options of a Hop-by-Hop Options header in uip_buf
+ * \param ext_buf the Hop-by-Hop Options header
+ * \param update whether to let the routing protocol process RPL options
+ * \return false if there are options other than padding and RPL
+ * options, or if the routing protocol rejects an RPL option
+ */
+static bool
+process_hbh_options(uint8_t *ext_buf, bool update)
+{
+  uint16_t ext_hdr_len = (((struct uip_hbho_hdr *)ext_buf)->len << 3) + 8;
+  uint16_t opt_offset = 2;
+
+  while(opt_offset < ext_hdr_len) {
+    switch(ext_buf[opt_offset]) {
+    case UIP_EXT_HDR_OPT_PAD1:
+      opt_offset++;
+      continue;
+    case UIP_EXT_HDR_OPT_PADN:
+      break;
+    case UIP_EXT_HDR_OPT_RPL:
+      if(update
+         && !NETSTACK_ROUTING.ext_header_hbh_update(ext_buf, opt_offset)) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+    }
+    if(opt_offset + 2 > ext_hdr_len) {
+      return false;
+    }
+    opt_offset += ext_buf[opt_offset + 1] + 2;
+  }
+  return opt_offset == ext_hdr_len;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Checks the extension headers of the first fragment in uip_buf
+ * \param first_frag_len the uncompressed length of the first fragment
+ * \param rh set to the routing header, or NULL if there is none
+ * \return true if the datagram can be forwarded without reassembly
+ *
+ * Only the headers that the routing protocol updates in place are
+ * accepted, i.e., a Hop-by-Hop Options header with padding and RPL
+ * options, as well as a routing header. All headers have to be within
+ * the first fragment.
+ */
+static bool
+check_ext_headers(uint16_t first_frag_len, struct uip_routing_hdr **rh)
+{
+  uint8_t *next_header;
+  uint8_t protocol;
+
+  *rh = NULL;
+  for(next_header = uipbuf_get_next_header(uip_buf, first_frag_len,
+                                           &protocol, true);
+      next_header != NULL && uip_is_proto_ext_hdr(protocol);
+      next_header = uipbuf_get_next_header(next_header,
+                                           first_frag_len
+                                           - (next_header - uip_buf),
+                                           &protocol, false)) {
+    switch(protocol) {
+    case UIP_PROTO_HBHO:
+      if(next_header != UIP_IP_PAYLOAD(0)
+         || !process_hbh_options(next_header, false)) {
+        return false;
+      }
+      break;
+    case UIP_PROTO_ROUTING:
+      if(*rh != NULL) {
+        return false;
+      }
+      *rh = (struct uip_routing_hdr *)next_header;
+      break;
+    default:
+      return false;
+    }
+  }
+  return next_header != NULL
+         && (protocol == UIP_PROTO_UDP
+             || protocol == UIP_PROTO_TCP
+             || protocol == UIP_PROTO_ICMP6);
+}
+/*--------------------------------------------------------------------*/
+static void
+vrb_init(struct sicslowpan_vrb_entry *entry, const linkaddr_t *sender,
+         uint16_t tag, const linkaddr_t *next_hop,
+         uint16_t frag_size, uint16_t first_frag_len)
+{
+  linkaddr_copy(&entry->sender, sender);
+  entry->tag = tag;
+  linkaddr_copy(&entry->next_hop, next_hop);
+  entry->len = frag_size;
+  entry->forwarded_len = first_frag_len;
+  timer_set(&entry->timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Forwards a first fragment, whose uncompressed headers and
+ * payload are in uip_buf, without reassembling the datagram.
+ * \param tag the tag of the received fragment
+ * \param frag_size the size of the whole datagram
+ * \param first_frag_len the uncompressed length of the first fragment
+ * \return true if forwarded or dropped, false if the datagram has to
+ * be reassembled
+ *
+ * Extension headers are processed as in uip_process(), as long as the
+ * routing protocol updates them in place. The DAG root, which inserts
+ * and removes extension headers, always reassembles.
+ */
+static bool
+forward_first_fragment(uint16_t tag, uint16_t frag_size,
+                       uint16_t first_frag_len)
+{
+  struct sicslowpan_vrb_entry *entry;
+  struct uip_routing_hdr *rh;
+  const linkaddr_t *next_hop;
+  linkaddr_t sender;
+  uint16_t saved_uip_len;
+  bool updated;
+  uint16_t frag1_end;
+
+  if(vrb_lookup(tag) != NULL) {
+    LOG_WARN("forward: duplicate frag1\n");
+    return true;
+  }
+  if(!check_ext_headers(first_frag_len, &rh)) {
+    return false;
+  }
+  if(uip_is_addr_mcast(&UIP_IP_BUF->destipaddr)
+     || uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr)
+     || uip_is_addr_linklocal(&UIP_IP_BUF->srcipaddr)
+     || uip_is_addr_unspecified(&UIP_IP_BUF->srcipaddr)
+     || UIP_IP_BUF->ttl <= 1
+     || NETSTACK_ROUTING.node_is_root()) {
+    return false;
+  }
+  /* With a source routing header, we are the current destination */
+  if(rh == NULL
+     ? uip_ds6_is_my_addr(&UIP_IP_BUF->destipaddr)
+     : rh->seg_left == 0 || !uip_ds6_is_my_addr(&UIP_IP_BUF->destipaddr)) {
+    return false;
+  }
+  entry = vrb_allocate();
+  if(entry == NULL) {
+    LOG_WARN("forward: no free VRB entry, reassembling instead\n");
+    return false;
+  }
+
+  linkaddr_copy(&sender, packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  /* packetbuf_clear() drops the security of the received fragment */
+  vrb_save_attrs(entry);
+  /* The routing protocol looks for extension headers within uip_len */
+  saved_uip_len = uip_len;
+  uip_len = first_frag_len;
+  next_hop = NULL;
+  if(rh == NULL) {
+    next_hop = get_forwarding_next_hop();
+    if(next_hop == NULL) {
+      uip_len = saved_uip_len;
+      return false;
+    }
+  }
+
+  /* Once the extension headers are updated, reassembling the datagram
+     would process them a second time, so we drop it instead */
+  updated = rh != NULL || UIP_IP_BUF->proto == UIP_PROTO_HBHO;
+  if(UIP_IP_BUF->proto == UIP_PROTO_HBHO
+     && !process_hbh_options(UIP_IP_PAYLOAD(0), true)) {
+    LOG_WARN("forward: dropping datagram with rejected RPL option\n");
+    goto discard;
+  }
+  if(rh != NULL) {
+    if(!NETSTACK_ROUTING.ext_header_srh_update()
+       || uip_ds6_is_my_addr(&UIP_IP_BUF->destipaddr)
+       || uip_is_addr_mcast(&UIP_IP_BUF->destipaddr)
+       || uip_is_addr_unspecified(&UIP_IP_BUF->destipaddr)
+       || uip_is_addr_loopback(&UIP_IP_BUF->destipaddr)) {
+      LOG_WARN("forward: dropping datagram with invalid routing header\n");
+      goto discard;
+    }
+    next_hop = get_forwarding_next_hop();
+    if(next_hop == NULL) {
+      LOG_WARN("forward: dropping source-routed datagram, no next hop\n");
+      goto discard;
+    }
+  }
+  if(!NETSTACK_ROUTING.ext_header_update() || uip_len != first_frag_len) {
+    LOG_WARN("forward: dropping datagram, failed to update headers\n");
+    goto discard;
+  }
+  uip_len = saved_uip_len;
+  UIP_IP_BUF->ttl--;
+
+  /* Recompress the headers as in output() */
+  uncomp_hdr_len = UIP_IPH_LEN;
+  packetbuf_hdr_len = 0;
+  packetbuf_clear();
+  packetbuf_ptr = packetbuf_dataptr();
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, next_hop);
+  vrb_restore_attrs(entry);
+  mac_max_payload = NETSTACK_MAC.max_payload();
+
+#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6
+  compress_hdr_ipv6();
+#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6 */
+#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH
+  add_paging_dispatch(1);
+  add_6lorh_hdr();
+#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH */
+#if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC
+  if(compress_hdr_iphc() == 0) {
+    mac_max_payload = 0;
+  }
+#endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC */
+
+  /* The recompressed headers may be larger than the received ones, in
+     which case the tail of the first fragment moves into an extra
+     fragment. Fragment offsets are multiples of 8 bytes. */
+  frag1_end = MIN(first_frag_len,
+                  (uncomp_hdr_len + mac_max_payload
+                   - packetbuf_hdr_len - SICSLOWPAN_FRAG1_HDR_LEN) & ~7);
+  if(mac_max_payload <= 0 || frag1_end < uncomp_hdr_len) {
+    if(updated) {
+      LOG_WARN("forward: failed to recompress headers, dropping datagram\n");
+      goto discard;
+    }
+    LOG_WARN("forward: failed to recompress headers, reassembling instead\n");
+    UIP_IP_BUF->ttl++;
+    packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender);
+    /* the reassembled datagram is as secure as its fragments */
+    vrb_restore_attrs(entry);
+    return false;
+  }
+
+  vrb_init(entry, &sender, tag, next_hop, frag_size, first_frag_len);
+  entry->next_tag = my_tag++;
+
+  LOG_INFO("forward: tag %u from ", tag);
+  LOG_INFO_LLADDR(&sender);
+  LOG_INFO_(" as tag %u to ", entry->next_tag);
+  LOG_INFO_LLADDR(next_hop);
+  LOG_INFO_("\n");
+
+  memmove(packetbuf_ptr + SICSLOWPAN_FRAG1_HDR_LEN, packetbuf_ptr, packetbuf_hdr_len);
+  packetbuf_hdr_len += SICSLOWPAN_FRAG1_HDR_LEN;
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+        ((SICSLOWPAN_DISPATCH_FRAG1 << 8) | frag_size));
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, entry->next_tag);
+  memcpy(packetbuf_ptr + packetbuf_hdr_len,
+         (uint8_t *)UIP_IP_BUF + uncomp_hdr_len, frag1_end - uncomp_hdr_len);
+  packetbuf_set_datalen(packetbuf_hdr_len + frag1_end - uncomp_hdr_len);
+  send_packet();
+
+  if(frag1_end < first_frag_len) {
+    packetbuf_clear();
+    packetbuf_ptr = packetbuf_dataptr();
+    packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, next_hop);
+    vrb_restore_attrs(entry);
+    SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+          ((SICSLOWPAN_DISPATCH_FRAGN << 8) | frag_size));
+    SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, entry->next_tag);
+    PACKETBUF_FRAG_PTR[PACKETBUF_FRAG_OFFSET] = frag1_end >> 3;
+    memcpy(packetbuf_ptr + SICSLOWPAN_FRAGN_HDR_LEN,
+           (uint8_t *)UIP_IP_BUF + frag1_end, first_frag_len - frag1_end);
+    packetbuf_set_datalen(SICSLOWPAN_FRAGN_HDR_LEN
+                          + first_frag_len - frag1_end);
+    send_packet();
+  }
+  return true;
+
+discard:
+  uip_len = saved_uip_len;
+  /* A null next hop makes the entry swallow the subsequent fragments */
+  vrb_init(entry, &sender, tag, &linkaddr_null, frag_size, first_frag_len);
+  return true;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Forwards a subsequent fragment, which is in packetbuf, if the
+ * first fragment of its datagram was forwarded.
+ * \param tag the tag of the received fragment
+ * \param frag_offset the offset of the received fragment in 8-byte units
+ * \return true if forwarded or dropped, false if the fragment has to be
+ * reassembled
+ */
+static bool
+forward_subsequent_fragment(uint16_t tag, uint8_t frag_offset)
+{
+  struct sicslowpan_vrb_entry *entry = vrb_lookup(tag);
+  uint16_t datalen;
+  uint8_t *dataptr;
+
+  if(entry == NULL) {
+    return false;
+  }
+
+  datalen = packetbuf_datalen();
+  dataptr = packetbuf_dataptr();
+  if(datalen <= SICSLOWPAN_FRAGN_HDR_LEN) {
+    return true;
+  }
+  /* The previous hop sends the fragments in order, so a fragment
+     before the end of the forwarded ones is a retransmission */
+  if(((uint16_t)frag_offset << 3) < entry->forwarded_len) {
+    LOG_WARN("forward: duplicate fragn\n");
+    return true;
+  }
+  entry->forwarded_len = ((uint16_t)frag_offset << 3)
+                         + datalen - SICSLOWPAN_FRAGN_HDR_LEN;
+  if(entry->forwarded_len >= entry->len) {
+    /* This was the last fragment */
+    entry->len = 0;
+  }
+  if(linkaddr_cmp(&entry->next_hop, &linkaddr_null)) {
+    /* The first fragment was dropped */
+    return true;
+  }
+  SET16(dataptr, PACKETBUF_FRAG_TAG, entry->next_tag);
+
+  packetbuf_clear();
+  packetbuf_set_datalen(datalen);
+  memmove(packetbuf_dataptr(), dataptr, datalen);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &entry->next_hop);
+  vrb_restore_attrs(entry);
+  send_packet();
+  return true;
+}
+#endif /* WITH_FRAG_FORWARDING */
+
 /*--------------------------------------------------------------------*/
 /** \brief Process a received 6lowpan packet.
  *
@@ -2188,6 +2717,12 @@ input(void)
       frag_size = GET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE) & 0x07ff;
       packetbuf_hdr_len += SICSLOWPAN_FRAGN_HDR_LEN;
 
+#if WITH_FRAG_FORWARDING
+      if(forward_subsequent_fragment(frag_tag, frag_offset)) {
+        return;
+      }
+#endif /* WITH_FRAG_FORWARDING */
+
       /* Add the fragment to the fragmentation context (this will also
          copy the payload) */
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
@@ -2201,7 +2736,9 @@ input(void)
          we should not store more */
       buffer = NULL;
 
-      if(frag_info[frag_context].reassembled_len >= frag_size) {
+      /* Complete once the first fragment arrived, too */
+      if(frag_info[frag_context].first_frag_len > 0 &&
+         frag_info[frag_context].reassembled_len >= frag_size) {
         last_fragment = 1;
       }
       is_fragment = 1;
@@ -2292,21 +2829,9 @@ input(void)
 
 #if SICSLOWPAN_CONF_FRAG
   if(first_fragment) {
-    if((uncomp_hdr_len + packetbuf_payload_len) < frag_size) {
-      /* create context since there are more fragments to come */
-      frag_context = add_fragment(frag_tag, frag_size, frag_offset);
-      if(frag_context == -1) {
-        LOG_ERR("input: failed to allocate new reassembly context\n");
-        return;
-      }
-      frag_info[frag_context].reassembled_len
-          = frag_info[frag_context].first_frag_len
-          = uncomp_hdr_len + packetbuf_payload_len;
-      /* copy uncompressed header to new context */
-      memcpy(frag_info[frag_context].first_frag, buffer, uncomp_hdr_len);
-      buffer = frag_info[frag_context].first_frag;
-      buffer_size = SICSLOWPAN_FIRST_FRAGMENT_SIZE;
-    } else {
+    /* If there are more fragments to come, the first fragment is
+       uncompressed into uip_buf and stored below */
+    if((uncomp_hdr_len + packetbuf_payload_len) >= frag_size) {
       /* since we expect no more fragments, leave uncompressed header in uip */
       last_fragment = 1;
 #if WITH_DEDUPLICATION
@@ -2338,6 +2863,38 @@ input(void)
   }
 
 #if SICSLOWPAN_CONF_FRAG
+  if(first_fragment && !last_fragment) {
+    uint16_t first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
+
+#if WITH_FRAG_FORWARDING
+    if(find_context(frag_tag) < 0
+       && forward_first_fragment(frag_tag, frag_size, first_frag_len)) {
+      return;
+    }
+#endif /* WITH_FRAG_FORWARDING */
+
+    frag_context = add_fragment(frag_tag, frag_size, frag_offset);
+    if(frag_context == -1) {
+      LOG_ERR("input: failed to allocate new reassembly context\n");
+      return;
+    }
+    frag_info[frag_context].first_frag_len = first_frag_len;
+    frag_info[frag_context].reassembled_len += first_frag_len;
+    if(frag_info[frag_context].reassembled_len < frag_size) {
+      /* Wait for the subsequent fragments */
+      store_first_fragment(frag_context, first_frag_len);
+      return;
+    }
+    /* The subsequent fragments arrived before the first fragment */
+    if(!copy_frags2uip(frag_context)) {
+      return;
+    }
+    last_fragment = 1;
+#if WITH_DEDUPLICATION
+    store_reassembled_tag(frag_tag);
+#endif /* WITH_DEDUPLICATION */
+  }
+
   /*
    * If we have a full IP packet in sicslowpan_buf, deliver it to
    * the IP stack
@@ -309,5 +309,11 @@ struct sicslowpan_nh_compressor {
 
 extern const struct network_driver sicslowpan_driver;
 
+/**
+ * \brief Returns the number of bytes that are reserved for
+ * reassembling and forwarding fragmented packets.
+ */
+size_t sicslowpan_frag_store_size(void);
+
 #endif /* SICSLOWPAN_H_ */
 /** @} */
@@ -85,6 +85,28 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_WITH_INDEX
+/* The route index hashes the prefix of each route into one of
+   ROUTE_INDEX_SIZE buckets. A lookup hashes the destination address
+   once for each prefix length in use, starting with the longest. */
+#if UIP_DS6_ROUTE_NB <= 16
+#define ROUTE_INDEX_SIZE 16
+#elif UIP_DS6_ROUTE_NB <= 64
+#define ROUTE_INDEX_SIZE 64
+#elif UIP_DS6_ROUTE_NB <= 256
+#define ROUTE_INDEX_SIZE 256
+#elif UIP_DS6_ROUTE_NB <= 1024
+#define ROUTE_INDEX_SIZE 1024
+#elif UIP_DS6_ROUTE_NB <= 4096
+#define ROUTE_INDEX_SIZE 4096
+#else
+#define ROUTE_INDEX_SIZE 16384
+#endif
+static uip_ds6_route_t *route_index[ROUTE_INDEX_SIZE];
+/* Number of routes per prefix length */
+static uint16_t routes_per_length[128 + 1];
+#endif /* UIP_DS6_ROUTE_WITH_INDEX */
+
 #endif /* (UIP_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -96,6 +118,74 @@ MEMB(defaultroutermemb, uip_ds6_defrt_t, UIP_DS6_DEFRT_NB);
 LIST(notificationlist);
 #endif
 
+#if UIP_DS6_ROUTE_WITH_INDEX
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t **
+route_index_bucket(const uip_ipaddr_t *addr, uint8_t length)
+{
+  uint32_t hash;
+  uint8_t i;
+
+  /* Only hash the bytes that uip_ipaddr_prefixcmp() compares */
+  hash = length;
+  for(i = 0; i < (length >> 3); i++) {
+    hash += addr->u8[i];
+    hash += hash << 10;
+    hash ^= hash >> 6;
+  }
+  hash += hash << 3;
+  hash ^= hash >> 11;
+  hash += hash << 15;
+  return &route_index[hash & (ROUTE_INDEX_SIZE - 1)];
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+route_index_lookup(const uip_ipaddr_t *addr)
+{
+  int length;
+  uip_ds6_route_t *r;
+
+  /* Like the scan of the route list, never match a zero-length prefix */
+  for(length = 128; length > 0; length--) {
+    if(routes_per_length[length] == 0) {
+      continue;
+    }
+    for(r = *route_index_bucket(addr, length); r != NULL; r = r->bucket_next) {
+      if(r->length == length && uip_ipaddr_prefixcmp(addr, &r->ipaddr, length)) {
+        return r;
+      }
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_index_add(uip_ds6_route_t *route)
+{
+  uip_ds6_route_t **bucket;
+
+  bucket = route_index_bucket(&route->ipaddr, route->length);
+  route->bucket_next = *bucket;
+  *bucket = route;
+  routes_per_length[route->length]++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_index_rm(uip_ds6_route_t *route)
+{
+  uip_ds6_route_t **r;
+
+  for(r = route_index_bucket(&route->ipaddr, route->length);
+      *r != NULL;
+      r = &(*r)->bucket_next) {
+    if(*r == route) {
+      *r = route->bucket_next;
+      routes_per_length[route->length]--;
+      return;
+    }
+  }
+}
+#endif /* UIP_DS6_ROUTE_WITH_INDEX */
 /*---------------------------------------------------------------------------*/
 static void
 assert_nbr_routes_list_sane(void)
@@ -168,6 +258,10 @@ uip_ds6_route_init(void)
 #if (UIP_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_WITH_INDEX
+  memset(route_index, 0, sizeof(route_index));
+  memset(routes_per_length, 0, sizeof(routes_per_length));
+#endif /* UIP_DS6_ROUTE_WITH_INDEX */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_MAX_ROUTES != 0) */
@@ -275,9 +369,11 @@ uip_ds6_route_t *
 uip_ds6_route_lookup(const uip_ipaddr_t *addr)
 {
 #if (UIP_MAX_ROUTES != 0)
+#if !UIP_DS6_ROUTE_WITH_INDEX
   uip_ds6_route_t *r;
-  uip_ds6_route_t *found_route;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_WITH_INDEX */
+  uip_ds6_route_t *found_route;
 
   LOG_INFO("Looking up route for ");
   LOG_INFO_6ADDR(addr);
@@ -287,12 +383,15 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     return NULL;
   }
 
+#if UIP_DS6_ROUTE_WITH_INDEX
+  found_route = route_index_lookup(addr);
+#else /* UIP_DS6_ROUTE_WITH_INDEX */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
       r != NULL;
       r = uip_ds6_route_next(r)) {
-    if(r->length >= longestmatch &&
+    if(r->length > longestmatch &&
        uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
       longestmatch = r->length;
       found_route = r;
@@ -302,6 +401,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_WITH_INDEX */
 
   if(found_route != NULL) {
     LOG_INFO("Found route: ");
@@ -313,6 +413,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     LOG_INFO("No route found\n");
   }
 
+#if !UIP_DS6_ROUTE_WITH_INDEX || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -322,6 +423,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* !UIP_DS6_ROUTE_WITH_INDEX || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
 
   return found_route;
 #else /* (UIP_MAX_ROUTES != 0) */
@@ -341,7 +443,7 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
     assert_nbr_routes_list_sane();
   }
 
-  if(ipaddr == NULL || nexthop == NULL) {
+  if(ipaddr == NULL || nexthop == NULL || length > 128) {
     return NULL;
   }
 
@@ -464,6 +566,9 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
 
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
+#if UIP_DS6_ROUTE_WITH_INDEX
+  route_index_add(r);
+#endif /* UIP_DS6_ROUTE_WITH_INDEX */
 
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
@@ -509,6 +614,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_WITH_INDEX
+    route_index_rm(route);
+#endif /* UIP_DS6_ROUTE_WITH_INDEX */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -111,6 +111,15 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_MAX_ROUTES */
 
+/** \brief Index routes in hash buckets per prefix length, so that
+ *  uip_ds6_route_lookup() probes one bucket per prefix length in use
+ *  instead of walking the whole routing table */
+#ifdef UIP_DS6_ROUTE_CONF_WITH_INDEX
+#define UIP_DS6_ROUTE_WITH_INDEX UIP_DS6_ROUTE_CONF_WITH_INDEX
+#else /* UIP_DS6_ROUTE_CONF_WITH_INDEX */
+#define UIP_DS6_ROUTE_WITH_INDEX 0
+#endif /* UIP_DS6_ROUTE_CONF_WITH_INDEX */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -170,6 +179,10 @@ struct uip_ds6_route_neighbor_routes {
 /** \brief An entry in the routing table */
 typedef struct uip_ds6_route {
   struct uip_ds6_route *next;
+#if UIP_DS6_ROUTE_WITH_INDEX
+  /* Next route in the same hash bucket of the route index */
+  struct uip_ds6_route *bucket_next;
+#endif /* UIP_DS6_ROUTE_WITH_INDEX */
   /* Each route entry belongs to a specific neighbor. That neighbor
      holds a list of all routing entries that go through it. The
      routes field point to the uip_ds6_route_neighbor_routes that
@@ -58,6 +58,96 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, uip_sr_node_t, UIP_SR_LINK_NUM);
 
+#if UIP_SR_WITH_INDEX
+/* Hash buckets of nodes, keyed by link identifier */
+#if UIP_SR_LINK_NUM <= 16
+#define NODE_INDEX_SIZE 16
+#elif UIP_SR_LINK_NUM <= 64
+#define NODE_INDEX_SIZE 64
+#elif UIP_SR_LINK_NUM <= 256
+#define NODE_INDEX_SIZE 256
+#elif UIP_SR_LINK_NUM <= 1024
+#define NODE_INDEX_SIZE 1024
+#else
+#define NODE_INDEX_SIZE 4096
+#endif
+static uip_sr_node_t *node_index[NODE_INDEX_SIZE];
+/* Changes whenever a node is added, moved, expired, or removed, or the
+   prefix changes, which invalidates the cached paths of all nodes */
+static uint16_t graph_version;
+/* The root node for which the cached paths were computed */
+static const uip_sr_node_t *path_root;
+/* path_len of nodes that cannot be reached from the root */
+#define PATH_LEN_UNREACHABLE 0xFF
+#endif /* UIP_SR_WITH_INDEX */
+
+#if UIP_SR_WITH_INDEX
+/*---------------------------------------------------------------------------*/
+static uip_sr_node_t **
+index_bucket(const unsigned char *link_identifier)
+{
+  uint32_t hash;
+  uint8_t i;
+
+  hash = 0;
+  for(i = 0; i < 8; i++) {
+    hash += link_identifier[i];
+    hash += hash << 10;
+    hash ^= hash >> 6;
+  }
+  hash += hash << 3;
+  hash ^= hash >> 11;
+  hash += hash << 15;
+  return &node_index[hash & (NODE_INDEX_SIZE - 1)];
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_add(uip_sr_node_t *node)
+{
+  uip_sr_node_t **bucket = index_bucket(node->link_identifier);
+  node->bucket_next = *bucket;
+  *bucket = node;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_remove(uip_sr_node_t *node)
+{
+  uip_sr_node_t **l;
+  for(l = index_bucket(node->link_identifier); *l != NULL; l = &(*l)->bucket_next) {
+    if(*l == node) {
+      *l = node->bucket_next;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+graph_changed(void)
+{
+  uip_sr_node_t *l;
+
+  graph_version++;
+  if(graph_version == 0) {
+    /* Prevent stale cache entries from becoming valid again */
+    for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
+      l->path_version = 0;
+    }
+    graph_version = 1;
+  }
+}
+#endif /* UIP_SR_WITH_INDEX */
+/*---------------------------------------------------------------------------*/
+/* Counts the number of bytes in common between two addresses at p1 and p2 */
+static uint8_t
+count_matching_bytes(const void *p1, const void *p2, size_t n)
+{
+  for(size_t i = 0; i < n; i++) {
+    if(((uint8_t *)p1)[i] != ((uint8_t *)p2)[i]) {
+      return i;
+    }
+  }
+  return n;
+}
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_num_nodes(void)
@@ -82,7 +172,14 @@ uip_sr_node_t *
 uip_sr_get_node(const void *graph, const uip_ipaddr_t *addr)
 {
   uip_sr_node_t *l;
+  if(addr == NULL) {
+    return NULL;
+  }
+#if UIP_SR_WITH_INDEX
+  for(l = *index_bucket(addr->u8 + 8); l != NULL; l = l->bucket_next) {
+#else /* UIP_SR_WITH_INDEX */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
+#endif /* UIP_SR_WITH_INDEX */
     /* Compare prefix and node identifier */
     if(node_matches_address(graph, l, addr)) {
       return l;
@@ -110,6 +207,57 @@ uip_sr_is_addr_reachable(const void *graph, const uip_ipaddr_t *addr)
   return node != NULL && node == root_node;
 }
 /*---------------------------------------------------------------------------*/
+int
+uip_sr_get_path(uip_sr_node_t *dest_node, const uip_sr_node_t *root_node,
+                uint8_t *path_len, uint8_t *cmpr)
+{
+  int max_depth = UIP_SR_LINK_NUM;
+  uip_sr_node_t *node;
+  uip_ipaddr_t dest_addr;
+  uip_ipaddr_t node_addr;
+  uint8_t len;
+  uint8_t matching;
+  int is_reachable;
+
+#if UIP_SR_WITH_INDEX
+  if(root_node != path_root) {
+    path_root = root_node;
+    graph_changed();
+  }
+  if(dest_node->path_version == graph_version) {
+    *path_len = dest_node->path_len;
+    *cmpr = dest_node->path_cmpr;
+    return dest_node->path_len != PATH_LEN_UNREACHABLE;
+  }
+#endif /* UIP_SR_WITH_INDEX */
+
+  NETSTACK_ROUTING.get_sr_node_ipaddr(&dest_addr, dest_node);
+  len = 0;
+  *cmpr = 15;
+  node = dest_node;
+  while(node != NULL && node != root_node && max_depth > 0) {
+    if(node != dest_node) {
+      /* How many bytes in common between all nodes in the path? */
+      NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+      matching = count_matching_bytes(&node_addr, &dest_addr, 16);
+      *cmpr = MIN(*cmpr, matching);
+      len++;
+    }
+    node = node->parent;
+    max_depth--;
+  }
+  is_reachable = node != NULL && node == root_node;
+  *path_len = len;
+
+#if UIP_SR_WITH_INDEX
+  dest_node->path_version = graph_version;
+  dest_node->path_len = is_reachable ? len : PATH_LEN_UNREACHABLE;
+  dest_node->path_cmpr = *cmpr;
+#endif /* UIP_SR_WITH_INDEX */
+
+  return is_reachable;
+}
+/*---------------------------------------------------------------------------*/
 void
 uip_sr_expire_parent(const void *graph, const uip_ipaddr_t *child,
                      const uip_ipaddr_t *parent)
@@ -130,6 +278,9 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
   uip_sr_node_t *child_node = uip_sr_get_node(graph, child);
   uip_sr_node_t *parent_node = uip_sr_get_node(graph, parent);
   uip_sr_node_t *old_parent_node;
+#if UIP_SR_WITH_INDEX
+  void *old_graph;
+#endif /* UIP_SR_WITH_INDEX */
 
   if(parent != NULL) {
     /* No node for the parent, add one with infinite lifetime */
@@ -155,8 +306,18 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
     child_node->parent = NULL;
     list_add(nodelist, child_node);
     num_nodes++;
+#if UIP_SR_WITH_INDEX
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+    child_node->path_version = 0;
+    child_node->graph = NULL;
+    index_add(child_node);
+#endif /* UIP_SR_WITH_INDEX */
   }
 
+#if UIP_SR_WITH_INDEX
+  old_graph = child_node->graph;
+  old_parent_node = child_node->parent;
+#endif /* UIP_SR_WITH_INDEX */
   /* Initialize node */
   child_node->graph = graph;
   child_node->lifetime = lifetime;
@@ -177,6 +338,13 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
   } else {
     child_node->parent = parent_node;
   }
+#if UIP_SR_WITH_INDEX
+  /* A new node starts with a NULL graph, so this also covers additions */
+  if(child_node->graph != old_graph
+     || child_node->parent != old_parent_node) {
+    graph_changed();
+  }
+#endif /* UIP_SR_WITH_INDEX */
 
   LOG_INFO("NS: updating link, child ");
   LOG_INFO_6ADDR(child);
@@ -193,6 +361,11 @@ uip_sr_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if UIP_SR_WITH_INDEX
+  memset(node_index, 0, sizeof(node_index));
+  graph_version = 1;
+  path_root = NULL;
+#endif /* UIP_SR_WITH_INDEX */
 }
 /*---------------------------------------------------------------------------*/
 uip_sr_node_t *
@@ -235,11 +408,20 @@ uip_sr_periodic(unsigned seconds)
           LOG_INFO_("\n");
         }
         list_remove(nodelist, l);
+#if UIP_SR_WITH_INDEX
+        index_remove(l);
+        graph_changed();
+#endif /* UIP_SR_WITH_INDEX */
         memb_free(&nodememb, l);
         num_nodes--;
       }
     } else if(l->lifetime != UIP_SR_INFINITE_LIFETIME) {
       l->lifetime = l->lifetime > seconds ? l->lifetime - seconds : 0;
+#if UIP_SR_WITH_INDEX
+      if(l->lifetime == 0) {
+        graph_changed();
+      }
+#endif /* UIP_SR_WITH_INDEX */
     }
   }
 }
@@ -255,6 +437,20 @@ uip_sr_free_all(void)
     memb_free(&nodememb, l);
     num_nodes--;
   }
+#if UIP_SR_WITH_INDEX
+  memset(node_index, 0, sizeof(node_index));
+  /* The memory of the root node may be reused for another node */
+  path_root = NULL;
+  graph_changed();
+#endif /* UIP_SR_WITH_INDEX */
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_sr_invalidate_paths(void)
+{
+#if UIP_SR_WITH_INDEX
+  graph_changed();
+#endif /* UIP_SR_WITH_INDEX */
 }
 /*---------------------------------------------------------------------------*/
 int
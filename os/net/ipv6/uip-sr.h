@@ -85,6 +85,15 @@
 
 #define UIP_SR_INFINITE_LIFETIME           0xFFFFFFFF
 
+/* Index nodes by their link identifier and cache the path from the root
+ * to each node until the graph changes. Speeds up the construction of
+ * source routing headers in large networks. */
+#ifdef UIP_SR_CONF_WITH_INDEX
+#define UIP_SR_WITH_INDEX UIP_SR_CONF_WITH_INDEX
+#else /* UIP_SR_CONF_WITH_INDEX */
+#define UIP_SR_WITH_INDEX 0
+#endif /* UIP_SR_CONF_WITH_INDEX */
+
 /********** Data Structures  **********/
 
 /** \brief A node in a source routing graph, stored at the root and representing
@@ -98,6 +107,14 @@ typedef struct uip_sr_node {
   us with the prefix */
   unsigned char link_identifier[8];
   struct uip_sr_node *parent;
+#if UIP_SR_WITH_INDEX
+  /* Next node in the same hash bucket */
+  struct uip_sr_node *bucket_next;
+  /* Graph version for which path_len and path_cmpr are valid */
+  uint16_t path_version;
+  uint8_t path_len;
+  uint8_t path_cmpr;
+#endif /* UIP_SR_WITH_INDEX */
 } uip_sr_node_t;
 
 /********** Public functions **********/
@@ -165,6 +182,21 @@ uip_sr_node_t *uip_sr_get_node(const void *graph, const uip_ipaddr_t *addr);
  */
 int uip_sr_is_addr_reachable(const void *graph, const uip_ipaddr_t *addr);
 
+/**
+ * Computes the path from the root to a node, as needed for building a
+ * source routing header
+ *
+ * \param dest_node The destination node
+ * \param root_node The root node
+ * \param path_len Set to the number of hops between the root and the
+ * destination, excluding both
+ * \param cmpr Set to the number of leading bytes that the addresses of
+ * these hops share with the destination address, at most 15
+ * \return 1 if there is a path from the root to the node, 0 otherwise
+ */
+int uip_sr_get_path(uip_sr_node_t *dest_node, const uip_sr_node_t *root_node,
+                    uint8_t *path_len, uint8_t *cmpr);
+
 /**
  * A function called periodically. Used to age the links (decrease lifetime
  * and expire links accordingly)
@@ -183,6 +215,13 @@ void uip_sr_init(void);
  */
 void uip_sr_free_all(void);
 
+/**
+ * Drop the paths cached by uip_sr_get_path. To be called by the routing
+ * protocol whenever the addresses of nodes may have changed, e.g., when
+ * the prefix changes
+ */
+void uip_sr_invalidate_paths(void);
+
 /**
 * Print a textual description of a source routing link
 *
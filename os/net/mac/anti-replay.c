@@ -36,7 +36,9 @@
  *
  * \file
  *         Protects against replay attacks by comparing with the last
- *         unicast or broadcast frame counter of the sender.
+ *         unicast or broadcast frame counter of the sender. Optionally,
+ *         a sliding window additionally accepts frames that arrive out
+ *         of order, as long as their frame counter was not seen before.
  * \author
  *         Konrad Krentz <konrad.krentz@gmail.com>
  */
@@ -57,6 +59,13 @@ uint32_t anti_replay_my_unicast_counter;
 static uint32_t my_counter;
 #endif /* ANTI_REPLAY_WITH_SUPPRESSION */
 
+#if ANTI_REPLAY_WITH_STATS
+struct anti_replay_stats anti_replay_stats;
+#define STATS_INC(x) (anti_replay_stats.x++)
+#else /* ANTI_REPLAY_WITH_STATS */
+#define STATS_INC(x)
+#endif /* ANTI_REPLAY_WITH_STATS */
+
 /*---------------------------------------------------------------------------*/
 static void
 order_and_set_counter(uint32_t counter)
@@ -102,33 +111,130 @@ void
 anti_replay_init_info(struct anti_replay_info *info)
 {
   memset(info, 0, sizeof(struct anti_replay_info));
+#if ANTI_REPLAY_WINDOW_SIZE
+  /* frames from before the session are not accepted */
+  info->broadcast_window = (anti_replay_window_t)~0;
+  info->unicast_window = (anti_replay_window_t)~0;
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
 #if ANTI_REPLAY_WITH_SUPPRESSION
   info->my_unicast_counter = anti_replay_my_unicast_counter;
 #endif /* ANTI_REPLAY_WITH_SUPPRESSION */
 }
 /*---------------------------------------------------------------------------*/
+#if ANTI_REPLAY_WINDOW_SIZE
+/* Moves the window along with the last frame counter */
+static void
+advance(uint32_t counter,
+        uint32_t *last_counter,
+        anti_replay_window_t *window)
+{
+  uint32_t distance = counter - *last_counter;
+
+  if(!*last_counter) {
+    /* first frame of this session - keep rejecting older ones */
+  } else if(distance < ANTI_REPLAY_WINDOW_SIZE) {
+    *window = (*window << distance)
+              | ((anti_replay_window_t)1 << (distance - 1));
+  } else if(distance == ANTI_REPLAY_WINDOW_SIZE) {
+    *window = (anti_replay_window_t)1 << (distance - 1);
+  } else {
+    *window = 0;
+  }
+  *last_counter = counter;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+was_replayed(uint32_t received_counter,
+             uint32_t *last_counter,
+             anti_replay_window_t *window)
+{
+  uint32_t distance;
+
+  if(received_counter > *last_counter) {
+    advance(received_counter, last_counter, window);
+    STATS_INC(accepted_in_order);
+    return false;
+  }
+
+  distance = *last_counter - received_counter;
+  if(!distance) {
+    STATS_INC(rejected_duplicates);
+    return true;
+  }
+  if(distance > ANTI_REPLAY_WINDOW_SIZE) {
+    STATS_INC(rejected_stale);
+    return true;
+  }
+  if(*window & ((anti_replay_window_t)1 << (distance - 1))) {
+    STATS_INC(rejected_duplicates);
+    return true;
+  }
+  *window |= (anti_replay_window_t)1 << (distance - 1);
+  STATS_INC(accepted_out_of_order);
+  return false;
+}
+#else /* ANTI_REPLAY_WINDOW_SIZE */
+static bool
+was_replayed(uint32_t received_counter, uint32_t *last_counter)
+{
+  if(received_counter > *last_counter) {
+    *last_counter = received_counter;
+    STATS_INC(accepted_in_order);
+    return false;
+  }
+  if(received_counter == *last_counter) {
+    STATS_INC(rejected_duplicates);
+  } else {
+    STATS_INC(rejected_stale);
+  }
+  return true;
+}
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
+/*---------------------------------------------------------------------------*/
 bool
 anti_replay_was_replayed(struct anti_replay_info *info)
 {
   uint32_t received_counter = anti_replay_get_counter();
 
   if(packetbuf_holds_broadcast()) {
-    /* broadcast */
-    if(received_counter <= info->last_broadcast_counter) {
-      return true;
-    } else {
-      info->last_broadcast_counter = received_counter;
-      return false;
-    }
+    return was_replayed(received_counter,
+                        &info->last_broadcast_counter
+#if ANTI_REPLAY_WINDOW_SIZE
+                        , &info->broadcast_window
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
+                        );
   } else {
-    /* unicast */
-    if(received_counter <= info->last_unicast_counter) {
-      return true;
-    } else {
-      info->last_unicast_counter = received_counter;
-      return false;
-    }
+    return was_replayed(received_counter,
+                        &info->last_unicast_counter
+#if ANTI_REPLAY_WINDOW_SIZE
+                        , &info->unicast_window
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
+                        );
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+anti_replay_reset_broadcast_counter(struct anti_replay_info *info,
+                                    uint32_t counter)
+{
+  info->last_broadcast_counter = counter;
+#if ANTI_REPLAY_WINDOW_SIZE
+  info->broadcast_window = (anti_replay_window_t)~0;
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
+}
+/*---------------------------------------------------------------------------*/
+void
+anti_replay_advance_unicast_counter(struct anti_replay_info *info,
+                                    uint32_t counter)
+{
+  if(counter <= info->last_unicast_counter) {
+    return;
   }
+#if ANTI_REPLAY_WINDOW_SIZE
+  advance(counter, &info->last_unicast_counter, &info->unicast_window);
+#else /* ANTI_REPLAY_WINDOW_SIZE */
+  info->last_unicast_counter = counter;
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -176,23 +282,26 @@ anti_replay_write_my_broadcast_counter(uint8_t *dst)
 void
 anti_replay_restore_counter(const struct anti_replay_info *info, uint8_t lsbs)
 {
-  frame802154_frame_counter_t copied_counter = {
-    copied_counter.u32 = LLSEC802154_HTONL(packetbuf_holds_broadcast()
-                                           ? info->last_broadcast_counter
-                                           : info->last_unicast_counter)
-  };
+  uint32_t last_counter = packetbuf_holds_broadcast()
+                          ? info->last_broadcast_counter
+                          : info->last_unicast_counter;
+  uint32_t counter = (last_counter & ~(uint32_t)0xFF) | lsbs;
 
-  if(lsbs < copied_counter.u8[0]) {
-    copied_counter.u8[1]++;
-    if(!copied_counter.u8[1]) {
-      copied_counter.u8[2]++;
-      if(!copied_counter.u8[2]) {
-        copied_counter.u8[3]++;
-      }
-    }
+  if(counter < last_counter) {
+    counter += 0x100;
+  }
+#if ANTI_REPLAY_WINDOW_SIZE
+  /* prefer to interpret the LSBs as an out-of-order frame counter */
+  if((counter - last_counter >= 0x100 - ANTI_REPLAY_WINDOW_SIZE)
+     && (counter >= 0x100)) {
+    counter -= 0x100;
   }
-  copied_counter.u8[0] = lsbs;
-  anti_replay_parse_counter(copied_counter.u8);
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
+
+  frame802154_frame_counter_t reordered_counter = {
+    .u32 = LLSEC802154_HTONL(counter)
+  };
+  anti_replay_parse_counter(reordered_counter.u8);
 }
 /*---------------------------------------------------------------------------*/
 #else /* ANTI_REPLAY_WITH_SUPPRESSION */
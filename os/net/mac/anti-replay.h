@@ -53,14 +53,64 @@
 #define ANTI_REPLAY_WITH_SUPPRESSION 0
 #endif /* ANTI_REPLAY_CONF_WITH_SUPPRESSION */
 
+/*
+ * Number of frame counters below the last one that are still accepted if
+ * they were not received before. 0 disables the sliding window, i.e., only
+ * strictly increasing frame counters are accepted.
+ */
+#ifdef ANTI_REPLAY_CONF_WINDOW_SIZE
+#define ANTI_REPLAY_WINDOW_SIZE ANTI_REPLAY_CONF_WINDOW_SIZE
+#else /* ANTI_REPLAY_CONF_WINDOW_SIZE */
+#define ANTI_REPLAY_WINDOW_SIZE 0
+#endif /* ANTI_REPLAY_CONF_WINDOW_SIZE */
+
+#ifdef ANTI_REPLAY_CONF_WITH_STATS
+#define ANTI_REPLAY_WITH_STATS ANTI_REPLAY_CONF_WITH_STATS
+#else /* ANTI_REPLAY_CONF_WITH_STATS */
+#define ANTI_REPLAY_WITH_STATS 0
+#endif /* ANTI_REPLAY_CONF_WITH_STATS */
+
+#if ANTI_REPLAY_WINDOW_SIZE == 0
+#elif ANTI_REPLAY_WINDOW_SIZE == 8
+typedef uint8_t anti_replay_window_t;
+#elif ANTI_REPLAY_WINDOW_SIZE == 16
+typedef uint16_t anti_replay_window_t;
+#elif ANTI_REPLAY_WINDOW_SIZE == 32
+typedef uint32_t anti_replay_window_t;
+#elif ANTI_REPLAY_WINDOW_SIZE == 64
+typedef uint64_t anti_replay_window_t;
+#else
+#error "ANTI_REPLAY_CONF_WINDOW_SIZE must be 0, 8, 16, 32, or 64"
+#endif
+
 struct anti_replay_info {
   uint32_t last_broadcast_counter;
   uint32_t last_unicast_counter;
+#if ANTI_REPLAY_WINDOW_SIZE
+  /* bit i is set if last_*_counter - 1 - i was received */
+  anti_replay_window_t broadcast_window;
+  anti_replay_window_t unicast_window;
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
 #if ANTI_REPLAY_WITH_SUPPRESSION
   uint32_t my_unicast_counter;
 #endif /* ANTI_REPLAY_WITH_SUPPRESSION */
 };
 
+#if ANTI_REPLAY_WITH_STATS
+struct anti_replay_stats {
+  /* frames whose frame counter exceeded the last one */
+  uint32_t accepted_in_order;
+  /* frames that were accepted through the sliding window */
+  uint32_t accepted_out_of_order;
+  /* frames whose frame counter was received before */
+  uint32_t rejected_duplicates;
+  /* frames whose frame counter fell behind the sliding window */
+  uint32_t rejected_stale;
+};
+
+extern struct anti_replay_stats anti_replay_stats;
+#endif /* ANTI_REPLAY_WITH_STATS */
+
 #if ANTI_REPLAY_WITH_SUPPRESSION
 extern uint32_t anti_replay_my_broadcast_counter;
 extern uint32_t anti_replay_my_unicast_counter;
@@ -89,6 +139,27 @@ void anti_replay_init_info(struct anti_replay_info *info);
  */
 bool anti_replay_was_replayed(struct anti_replay_info *info);
 
+/**
+ * \brief         Sets the last broadcast frame counter of a sender and
+ *                marks all previous broadcast frame counters as received
+ * \param info    Anti-replay information about the sender
+ * \param counter The sender's current broadcast frame counter
+ */
+void anti_replay_reset_broadcast_counter(struct anti_replay_info *info,
+                                         uint32_t counter);
+
+/**
+ * \brief         Raises the last unicast frame counter of a sender, e.g.,
+ *                to the frame counter of an acknowledgement frame
+ * \param info    Anti-replay information about the sender
+ * \param counter The sender's current unicast frame counter
+ *
+ *                The sliding window is moved along, just as if a frame
+ *                with this frame counter was received.
+ */
+void anti_replay_advance_unicast_counter(struct anti_replay_info *info,
+                                         uint32_t counter);
+
 /**
  * \brief Parses the frame counter to packetbuf attributes
  */
@@ -118,6 +189,11 @@ void anti_replay_write_my_broadcast_counter(uint8_t *dst);
 /**
  * \brief             Restores suppressed frame counter
  * \param sender_info Anti-replay information about the sender
+ *
+ *                    With a sliding window, LSBs that point up to
+ *                    ANTI_REPLAY_WINDOW_SIZE frame counters back are
+ *                    restored to an out-of-order frame counter, which
+ *                    shortens the tolerated forward jump accordingly.
  */
 void anti_replay_restore_counter(const struct anti_replay_info *sender_info,
                                  uint8_t lsbs);
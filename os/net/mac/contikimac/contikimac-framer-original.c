@@ -512,8 +512,9 @@ on_unicast_transmitted(void)
 
   if(entry->permanent->anti_replay_info.last_unicast_counter
      != contikimac_state.strobe.last_unicast_counter) {
-    entry->permanent->anti_replay_info.last_unicast_counter =
-        contikimac_state.strobe.last_unicast_counter;
+    anti_replay_advance_unicast_counter(
+        &entry->permanent->anti_replay_info,
+        contikimac_state.strobe.last_unicast_counter);
     AKES_DELETE_STRATEGY.prolong_permanent_neighbor(entry->permanent);
   }
 #endif /* AKES_MAC_ENABLED */
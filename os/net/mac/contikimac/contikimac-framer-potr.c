@@ -45,6 +45,7 @@
 #include "net/mac/contikimac/contikimac-strategy.h"
 #include "net/mac/contikimac/contikimac.h"
 #include "net/mac/llsec802154.h"
+#include "net/mac/otp-table.h"
 #include "net/netstack.h"
 #include "net/packetbuf.h"
 #include "services/akes/akes-mac.h"
@@ -682,17 +683,16 @@ filter(void)
     contikimac_framer_potr_otp_t otp;
 
     contikimac_ccm_inputs_generate_otp_nonce(nonce, 0);
-    if(!CCM_STAR.set_key(
-           type == CONTIKIMAC_FRAMER_POTR_FRAME_TYPE_ACK
-           ? nbr->tentative_pairwise_key
-           : (!CONTIKIMAC_FRAMER_POTR_ILOS_ENABLED || is_broadcast
-              ? nbr->group_key
-              : akes_mac_group_key))
-       || !CCM_STAR.aead(nonce,
-                         NULL, 0,
-                         &totlen, 1,
-                         otp.u8, CONTIKIMAC_FRAMER_POTR_OTP_LEN,
-                         false)) {
+    const uint8_t *key = type == CONTIKIMAC_FRAMER_POTR_FRAME_TYPE_ACK
+                         ? nbr->tentative_pairwise_key
+                         : (!CONTIKIMAC_FRAMER_POTR_ILOS_ENABLED || is_broadcast
+                            ? nbr->group_key
+                            : akes_mac_group_key);
+    if(!otp_table_compute(contikimac_get_last_wake_up_time(),
+                          key,
+                          nonce,
+                          totlen,
+                          otp.u8, CONTIKIMAC_FRAMER_POTR_OTP_LEN)) {
       LOG_ERR("CCM* failed\n");
       return FRAMER_FAILED;
     }
@@ -701,7 +701,7 @@ filter(void)
       return FRAMER_FAILED;
     }
 
-    if(memcmp(otp.u8, p, CONTIKIMAC_FRAMER_POTR_OTP_LEN)) {
+    if(!otp_table_equals(otp.u8, p, CONTIKIMAC_FRAMER_POTR_OTP_LEN)) {
       LOG_ERR("invalid OTP\n");
       return FRAMER_FAILED;
     }
@@ -903,8 +903,9 @@ on_unicast_transmitted(void)
 
 #if ANTI_REPLAY_WITH_SUPPRESSION
   if(akes_mac_is_update()) {
-    entry->permanent->anti_replay_info.last_broadcast_counter =
-        anti_replay_read_counter(contikimac_state.strobe.acknowledgment + 2);
+    anti_replay_reset_broadcast_counter(
+        &entry->permanent->anti_replay_info,
+        anti_replay_read_counter(contikimac_state.strobe.acknowledgment + 2));
   }
 #endif /* ANTI_REPLAY_WITH_SUPPRESSION */
 
@@ -348,8 +348,9 @@ read_piggyback(const uint8_t *data,
   case AKES_HELLOACK_P_IDENTIFIER:
 #if ANTI_REPLAY_WITH_SUPPRESSION
     data += 4;
-    entry->permanent->anti_replay_info.last_broadcast_counter =
-        anti_replay_read_counter(data);
+    anti_replay_reset_broadcast_counter(
+        &entry->permanent->anti_replay_info,
+        anti_replay_read_counter(data));
     data += 4;
 #endif /* ANTI_REPLAY_WITH_SUPPRESSION */
 #if CONTIKIMAC_WITH_SECURE_PHASE_LOCK
@@ -375,8 +376,9 @@ read_piggyback(const uint8_t *data,
 #if CONTIKIMAC_WITH_SECURE_PHASE_LOCK
   case AKES_ACK_IDENTIFIER:
 #if ANTI_REPLAY_WITH_SUPPRESSION
-    entry->permanent->anti_replay_info.last_broadcast_counter =
-        anti_replay_read_counter(data);
+    anti_replay_reset_broadcast_counter(
+        &entry->permanent->anti_replay_info,
+        anti_replay_read_counter(data));
     data += 4;
 #endif /* ANTI_REPLAY_WITH_SUPPRESSION */
     data += CONTIKIMAC_Q_LEN + 1;
@@ -393,8 +395,9 @@ read_piggyback(const uint8_t *data,
 #endif /* CONTIKIMAC_WITH_SECURE_PHASE_LOCK */
 #if ANTI_REPLAY_WITH_SUPPRESSION
   case AKES_UPDATE_IDENTIFIER:
-    entry->permanent->anti_replay_info.last_broadcast_counter =
-        anti_replay_read_counter(data);
+    anti_replay_reset_broadcast_counter(
+        &entry->permanent->anti_replay_info,
+        anti_replay_read_counter(data));
     data += 4;
     break;
 #endif /* ANTI_REPLAY_WITH_SUPPRESSION */
@@ -55,9 +55,16 @@ on_unicast_transmitted(void)
 {
 }
 /*---------------------------------------------------------------------------*/
+static bool
+predict_rendezvous(const linkaddr_t *addr, rtimer_clock_t *rendezvous)
+{
+  return false;
+}
+/*---------------------------------------------------------------------------*/
 const struct contikimac_synchronizer contikimac_synchronizer_null = {
   init,
   schedule,
   on_unicast_transmitted,
+  predict_rendezvous,
 };
 /*---------------------------------------------------------------------------*/
@@ -160,10 +160,36 @@ on_unicast_transmitted(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+static bool
+predict_rendezvous(const linkaddr_t *addr, rtimer_clock_t *rendezvous)
+{
+  const struct contikimac_phase *phase;
+#if AKES_MAC_ENABLED
+  akes_nbr_entry_t *entry = akes_nbr_get_entry(addr);
+  if(!entry || !entry->permanent) {
+    return false;
+  }
+  phase = &contikimac_nbr_get(entry->permanent)->phase;
+#else /* AKES_MAC_ENABLED */
+  phase = nbr_table_get_from_lladdr(sync_data_table, addr);
+  if(!phase) {
+    return false;
+  }
+#endif /* AKES_MAC_ENABLED */
+  if(phase->t0 == phase->t1) {
+    /* no phase-lock information stored, yet */
+    return false;
+  }
+  *rendezvous = wake_up_counter_shift_to_future(phase->t0
+                                                - PHASE_LOCK_GUARD_TIME);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
 const struct contikimac_synchronizer contikimac_synchronizer_original = {
   init,
   schedule,
   on_unicast_transmitted,
+  predict_rendezvous,
 };
 /*---------------------------------------------------------------------------*/
 #endif /* CONTIKIMAC_WITH_ORIGINAL_PHASE_LOCK */
@@ -173,10 +173,24 @@ on_unicast_transmitted(void)
 #endif /* CONTIKIMAC_FRAMER_POTR_ILOS_ENABLED */
 }
 /*---------------------------------------------------------------------------*/
+static bool
+predict_rendezvous(const linkaddr_t *addr, rtimer_clock_t *rendezvous)
+{
+  akes_nbr_entry_t *entry = akes_nbr_get_entry(addr);
+  if(!entry || !entry->permanent) {
+    return false;
+  }
+  *rendezvous = wake_up_counter_shift_to_future(
+      contikimac_nbr_get(entry->permanent)->phase.t
+      - PHASE_LOCK_GUARD_TIME_NEGATIVE);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
 const struct contikimac_synchronizer contikimac_synchronizer_splo = {
   init,
   schedule,
   on_unicast_transmitted,
+  predict_rendezvous,
 };
 /*---------------------------------------------------------------------------*/
 #endif /* CONTIKIMAC_WITH_SECURE_PHASE_LOCK */
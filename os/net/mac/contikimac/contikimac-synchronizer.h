@@ -40,7 +40,9 @@
 
 #include "contiki.h"
 #include "net/mac/contikimac/contikimac.h"
+#include "net/linkaddr.h"
 #include "net/mac/mac.h"
+#include "sys/rtimer.h"
 
 #if !CONTIKIMAC_WITH_PHASE_LOCK
 #define CONTIKIMAC_SYNCHRONIZER contikimac_synchronizer_null
@@ -60,6 +62,10 @@ struct contikimac_synchronizer {
 
   /** Updates synchronization data after a unicast transmission */
   void (* on_unicast_transmitted)(void);
+
+  /** Predicts when a transmission to a receiver can start */
+  bool (* predict_rendezvous)(const linkaddr_t *addr,
+                              rtimer_clock_t *rendezvous);
 };
 
 extern const struct contikimac_synchronizer CONTIKIMAC_SYNCHRONIZER;
@@ -1014,6 +1014,15 @@ send(mac_callback_t sent, void *ptr)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+bool
+frame_queue_predict_rendezvous(const linkaddr_t *addr,
+                               rtimer_clock_t *rendezvous)
+{
+  return CONTIKIMAC_SYNCHRONIZER.predict_rendezvous(addr, rendezvous);
+}
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+/*---------------------------------------------------------------------------*/
 static void
 input(void)
 {
@@ -293,6 +293,7 @@ typedef union {
   } strobe;
 } contikimac_state_t;
 
+rtimer_clock_t contikimac_get_last_wake_up_time(void);
 #if CONTIKIMAC_WITH_ORIGINAL_PHASE_LOCK
 rtimer_clock_t contikimac_get_last_but_one_t0(void);
 #endif /* CONTIKIMAC_WITH_ORIGINAL_PHASE_LOCK */
@@ -305,7 +306,6 @@ rtimer_clock_t contikimac_get_phase(void);
 uint8_t contikimac_get_last_delta(void);
 uint8_t contikimac_get_last_strobe_index(void);
 bool potr_has_strobe_index(enum potr_frame_type type);
-rtimer_clock_t contikimac_get_last_wake_up_time(void);
 #if CONTIKIMAC_FRAMER_POTR_ILOS_ENABLED
 rtimer_clock_t contikimac_get_next_strobe_start(void);
 wake_up_counter_t contikimac_get_wake_up_counter(rtimer_clock_t t);
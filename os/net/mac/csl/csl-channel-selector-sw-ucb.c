@@ -3078,26 +3078,18 @@ static void
 init(csl_nbr_t *csl_nbr)
 {
   memset(csl_nbr->window, 0, sizeof(csl_nbr->window));
+  memset(csl_nbr->pulls, 0, sizeof(csl_nbr->pulls));
+  memset(csl_nbr->rewards, 0, sizeof(csl_nbr->rewards));
   csl_nbr->time_step = 0;
 }
 /*---------------------------------------------------------------------------*/
 static uint_fast16_t
 propose_channels(csl_nbr_t *csl_nbr)
 {
-  ufix16_t pulls[CSL_CHANNELS_COUNT] = { 0 };
-  ufix16_t rewards[CSL_CHANNELS_COUNT] = { 0 };
-  for(uint32_t s = 0; s < MIN(WINDOW_SIZE, csl_nbr->time_step); s++) {
-    uint8_t arm = csl_nbr->window[s].arm;
-    pulls[arm] += UFIX16_ONE;
-    if(csl_nbr->window[s].reward) {
-      rewards[arm] += UFIX16_FROM_UINT(1 << (EXPLORATION_TENDENCY_SHIFT / 2));
-    }
-  }
-
   uint_fast16_t proposed_channels = 0;
   uint_fast8_t proposed_channels_count = 0;
   for(uint_fast8_t i = 0; i < CSL_CHANNELS_COUNT; i++) {
-    if(!pulls[i]) {
+    if(!csl_nbr->pulls[i]) {
       proposed_channels |= 1 << i;
       proposed_channels_count++;
     }
@@ -3126,9 +3118,13 @@ propose_channels(csl_nbr_t *csl_nbr)
   for(uint_fast8_t i = 0; i < CSL_CHANNELS_COUNT; i++) {
     ufix16_t ucb;
 
-    if(pulls[i]) {
-      ufix16_t exploitation = ufix16_divide(rewards[i], pulls[i]);
-      ufix16_t exploration = ufix16_sqrt(ufix16_divide(intermediate, pulls[i]));
+    if(csl_nbr->pulls[i]) {
+      ufix16_t pulls = UFIX16_FROM_UINT(csl_nbr->pulls[i]);
+      ufix16_t rewards =
+          UFIX16_FROM_UINT(csl_nbr->rewards[i]
+                           << (EXPLORATION_TENDENCY_SHIFT / 2));
+      ufix16_t exploitation = ufix16_divide(rewards, pulls);
+      ufix16_t exploration = ufix16_sqrt(ufix16_divide(intermediate, pulls));
       ucb = exploitation + exploration;
     } else {
       ucb = UFIX16_MAX;
@@ -3184,21 +3180,24 @@ static void
 take_feedback(csl_nbr_t *csl_nbr, bool successful, uint8_t channel)
 {
   uint32_t entry_index = csl_nbr->time_step % WINDOW_SIZE;
+  if(csl_nbr->time_step >= WINDOW_SIZE) {
+    /* the oldest entry slides out of the window */
+    csl_nbr->pulls[csl_nbr->window[entry_index].arm]--;
+    csl_nbr->rewards[csl_nbr->window[entry_index].arm] -=
+        csl_nbr->window[entry_index].reward;
+  }
   csl_nbr->window[entry_index].arm = channel;
   csl_nbr->window[entry_index].reward = successful;
+  csl_nbr->pulls[channel]++;
+  csl_nbr->rewards[channel] += successful;
   csl_nbr->time_step++;
 }
 /*---------------------------------------------------------------------------*/
 static bool
 is_exploring(csl_nbr_t *csl_nbr)
 {
-  uint_fast16_t bitmap = 0;
-  for(uint32_t s = 0; s < MIN(WINDOW_SIZE, csl_nbr->time_step); s++) {
-    bitmap |= 1 << csl_nbr->window[s].arm;
-  }
-
-  for(uint_fast16_t mask = 1; mask <= 1 << CSL_CHANNELS_COUNT; mask <<= 1) {
-    if(!(mask & bitmap)) {
+  for(uint_fast8_t i = 0; i < CSL_CHANNELS_COUNT; i++) {
+    if(!csl_nbr->pulls[i]) {
       return true;
     }
   }
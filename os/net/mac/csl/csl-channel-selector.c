@@ -47,6 +47,24 @@
 #define LOG_MODULE "CSL"
 #define LOG_LEVEL LOG_LEVEL_MAC
 
+/*---------------------------------------------------------------------------*/
+#if !CSL_COMPLIANT
+static void
+refresh(csl_nbr_t *csl_nbr, const linkaddr_t *addr)
+{
+  csl_nbr->rendezvous_mask = csl_forecast_rendezvous_mask(
+      CSL_CHANNEL_SELECTOR.propose_channels(csl_nbr), addr);
+}
+#endif /* !CSL_COMPLIANT */
+/*---------------------------------------------------------------------------*/
+void
+csl_channel_selector_init(csl_nbr_t *csl_nbr, const linkaddr_t *addr)
+{
+#if !CSL_COMPLIANT
+  CSL_CHANNEL_SELECTOR.init(csl_nbr);
+  refresh(csl_nbr, addr);
+#endif /* !CSL_COMPLIANT */
+}
 /*---------------------------------------------------------------------------*/
 void
 csl_channel_selector_take_feedback(bool successful, uint_fast8_t burst_index)
@@ -71,6 +89,7 @@ csl_channel_selector_take_feedback(bool successful, uint_fast8_t burst_index)
   CSL_CHANNEL_SELECTOR.take_feedback(csl_nbr,
                                      successful,
                                      csl_get_channel_index());
+  refresh(csl_nbr, packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
 
 #endif /* !CSL_COMPLIANT */
 }
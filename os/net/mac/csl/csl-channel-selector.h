@@ -42,6 +42,7 @@
 #define CSL_CHANNEL_SELECTOR_H_
 
 #include "contiki.h"
+#include "net/linkaddr.h"
 #include <stdbool.h>
 
 #ifdef CSL_CHANNEL_SELECTOR_CONF_SW_UCB_WINDOW_SIZE
@@ -85,6 +86,13 @@ struct csl_channel_selector {
   bool (* is_exploring)(csl_nbr_t *csl_nbr);
 };
 
+/**
+ * \brief         Initializes the channel selection for a new neighbor.
+ * \param csl_nbr The neighbor.
+ * \param addr    The neighbor's address.
+ */
+void csl_channel_selector_init(csl_nbr_t *csl_nbr, const linkaddr_t *addr);
+
 void csl_channel_selector_take_feedback(bool successful,
                                         uint_fast8_t burst_index);
 bool csl_channel_selector_take_feedback_is_exploring(void);
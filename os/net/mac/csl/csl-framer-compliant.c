@@ -679,8 +679,9 @@ on_unicast_transmitted(void)
 
   if(entry->permanent->anti_replay_info.last_unicast_counter
      != csl_state.transmit.last_unicast_counter) {
-    entry->permanent->anti_replay_info.last_unicast_counter =
-        csl_state.transmit.last_unicast_counter;
+    anti_replay_advance_unicast_counter(
+        &entry->permanent->anti_replay_info,
+        csl_state.transmit.last_unicast_counter);
     AKES_DELETE_STRATEGY.prolong_permanent_neighbor(entry->permanent);
   }
 #endif /* LLSEC802154_USES_FRAME_COUNTER */
@@ -49,6 +49,7 @@
 #endif /* SMOR */
 #include "net/mac/csl/csl-ccm-inputs.h"
 #include "net/mac/csl/csl-framer.h"
+#include "net/mac/otp-table.h"
 #include "net/packetbuf.h"
 #include "services/akes/akes-mac.h"
 #include "services/akes/akes-nbr.h"
@@ -728,11 +729,21 @@ parse_wake_up_frame(void)
     }
 #endif /* defined(FILTERING_CLIENT) && !defined(AGGREGATOR) */
     uint8_t otp[CSL_FRAMER_POTR_OTP_LEN];
-    bool aead_result = CCM_STAR.aead(nonce,
-                                     NULL, 0,
-                                     &csl_state.duty_cycle.next_frames_len, 1,
-                                     otp, CSL_FRAMER_POTR_OTP_LEN,
-                                     false);
+    bool aead_result =
+#if defined(FILTERING_CLIENT) && !defined(AGGREGATOR)
+        has_filtering_otp
+        ? CCM_STAR.aead(nonce,
+                        NULL, 0,
+                        &csl_state.duty_cycle.next_frames_len, 1,
+                        otp, CSL_FRAMER_POTR_OTP_LEN,
+                        false)
+        :
+#endif /* defined(FILTERING_CLIENT) && !defined(AGGREGATOR) */
+        otp_table_compute(csl_get_last_wake_up_time(),
+                          nbr->pairwise_key,
+                          nonce,
+                          csl_state.duty_cycle.next_frames_len,
+                          otp, CSL_FRAMER_POTR_OTP_LEN);
     if(!aead_result) {
 #if defined(FILTERING_CLIENT) && !defined(AGGREGATOR)
       filtering_client_unset_otp_key();
@@ -752,7 +763,7 @@ parse_wake_up_frame(void)
       LOG_ERR("could not read at line %i\n", __LINE__);
       return FRAMER_FAILED;
     }
-    if(memcmp(otp, dataptr, CSL_FRAMER_POTR_OTP_LEN)) {
+    if(!otp_table_equals(otp, dataptr, CSL_FRAMER_POTR_OTP_LEN)) {
       LOG_WARN("invalid OTP\n");
       return FRAMER_FAILED;
     }
@@ -69,6 +69,11 @@ typedef struct csl_nbr {
   struct csl_synchronizer_splo_data sync_data;
   int32_t drift;
   struct csl_synchronizer_splo_data historical_sync_data;
+  /*
+   * Bit i is set if the neighbor listens on a proposed channel whenever the
+   * LSBs of its wake-up counter equal i. Refreshed after each feedback.
+   */
+  uint16_t rendezvous_mask;
 #if CSL_CHANNEL_SELECTOR_WITH_D_UCB
   ufix22_t discounted_pulls[CSL_CHANNELS_COUNT];
   ufix22_t discounted_rewards[CSL_CHANNELS_COUNT];
@@ -76,6 +81,9 @@ typedef struct csl_nbr {
   uint32_t time_step;
   csl_nbr_sw_ucb_window_entry_t
       window[CSL_CHANNEL_SELECTOR_SW_UCB_WINDOW_SIZE];
+  /* pulls and rewards per channel within the window */
+  uint16_t pulls[CSL_CHANNELS_COUNT];
+  uint16_t rewards[CSL_CHANNELS_COUNT];
 #endif /* CSL_CHANNEL_SELECTOR_WITH_SW_UCB */
 #endif /* CSL_COMPLIANT */
 } csl_nbr_t;
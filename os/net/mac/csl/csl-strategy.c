@@ -234,7 +234,7 @@ read_piggyback(const uint8_t *data,
                            - (WAKE_UP_COUNTER_INTERVAL / 2);
     csl_nbr->sync_data.his_wake_up_counter_at_t = wake_up_counter_parse(data);
     data += WAKE_UP_COUNTER_LEN;
-    CSL_CHANNEL_SELECTOR.init(csl_nbr);
+    csl_channel_selector_init(csl_nbr, akes_nbr_get_addr(entry));
     break;
   case AKES_HELLOACK_IDENTIFIER:
   case AKES_HELLOACK_P_IDENTIFIER:
@@ -249,7 +249,7 @@ read_piggyback(const uint8_t *data,
     data += sizeof(q);
     phi_2 = csl_get_phase(csl_get_sfd_timestamp_of_last_payload_frame());
     csl_nbr->drift = AKES_NBR_UNINITIALIZED_DRIFT;
-    CSL_CHANNEL_SELECTOR.init(csl_nbr);
+    csl_channel_selector_init(csl_nbr, akes_nbr_get_addr(entry));
     break;
   case AKES_ACK_IDENTIFIER:
     csl_nbr = csl_nbr_get(entry->permanent);
@@ -179,10 +179,31 @@ on_unicast_transmitted(bool successful, uint_fast8_t burst_index)
       - (WAKE_UP_COUNTER_INTERVAL - csl_state.transmit.acknowledgment_phase);
 }
 /*---------------------------------------------------------------------------*/
+static bool
+predict_rendezvous(const linkaddr_t *addr, rtimer_clock_t *rendezvous)
+{
+  struct csl_synchronizer_compliant_data *sync_data;
+#if LLSEC802154_USES_FRAME_COUNTER
+  akes_nbr_entry_t *entry = akes_nbr_get_entry(addr);
+  if(!entry || !entry->permanent) {
+    return false;
+  }
+  sync_data = &csl_nbr_get(entry->permanent)->sync_data;
+#else /* LLSEC802154_USES_FRAME_COUNTER */
+  sync_data = nbr_table_get_from_lladdr(sync_data_table, addr);
+  if(!sync_data) {
+    return false;
+  }
+#endif /* LLSEC802154_USES_FRAME_COUNTER */
+  *rendezvous = wake_up_counter_shift_to_future(sync_data->t);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
 const struct csl_synchronizer csl_synchronizer_compliant = {
   init,
   schedule,
-  on_unicast_transmitted
+  on_unicast_transmitted,
+  predict_rendezvous
 };
 /*---------------------------------------------------------------------------*/
 
@@ -60,6 +60,23 @@ init(void)
 {
 }
 /*---------------------------------------------------------------------------*/
+static int32_t
+get_compensation(int32_t drift, rtimer_clock_t ticks_since_last_sync)
+{
+  if(drift == AKES_NBR_UNINITIALIZED_DRIFT) {
+    return 0;
+  }
+  return ((int64_t)drift * (int64_t)ticks_since_last_sync) / csl_drift_unit;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+skips_wake_up(const csl_nbr_t *csl_nbr, wake_up_counter_t wuc)
+{
+  /* skip wake ups on channels that were not proposed */
+  return !(csl_nbr->rendezvous_mask
+           & (1 << (wuc.u8[0] & (CSL_CHANNELS_COUNT - 1))));
+}
+/*---------------------------------------------------------------------------*/
 static int
 schedule(void)
 {
@@ -105,14 +122,8 @@ schedule(void)
     positive_uncertainty += CSL_POSITIVE_SYNC_GUARD_TIME;
 
     /* compensate for clock drift if known */
-    int32_t compensation;
-    if(drift == AKES_NBR_UNINITIALIZED_DRIFT) {
-      compensation = 0;
-    } else {
-      compensation = ((int64_t)drift * (int64_t)ticks_since_last_sync)
-                     / csl_drift_unit;
-      LOG_DBG("compensated ticks: %" PRIi32 "\n", compensation);
-    }
+    int32_t compensation = get_compensation(drift, ticks_since_last_sync);
+    LOG_DBG("compensated ticks: %" PRIi32 "\n", compensation);
 
     /* set variables */
     csl_state.transmit.wake_up_sequence_start =
@@ -122,23 +133,16 @@ schedule(void)
     while(!csl_can_schedule_wake_up_sequence()) {
       csl_state.transmit.wake_up_sequence_start += WAKE_UP_COUNTER_INTERVAL;
     }
-    uint_fast16_t proposed_channels =
-        CSL_CHANNEL_SELECTOR.propose_channels(csl_nbr);
-    while(1) {
-      csl_state.transmit.receivers_wake_up_counter.u32 =
-          sync_data->his_wake_up_counter_at_t.u32
-          + wake_up_counter_round_increments(
-              (csl_state.transmit.wake_up_sequence_start
-               - compensation
-               + negative_uncertainty)
-              - sync_data->t);
-      uint_fast8_t forecast_channel_index =
-          csl_forecast_channel_index(
-              csl_state.transmit.receivers_wake_up_counter,
-              packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
-      if(proposed_channels & (1 << forecast_channel_index)) {
-        break;
-      }
+    csl_state.transmit.receivers_wake_up_counter.u32 =
+        sync_data->his_wake_up_counter_at_t.u32
+        + wake_up_counter_round_increments(
+            (csl_state.transmit.wake_up_sequence_start
+             - compensation
+             + negative_uncertainty)
+            - sync_data->t);
+    while(skips_wake_up(csl_nbr,
+                        csl_state.transmit.receivers_wake_up_counter)) {
+      csl_state.transmit.receivers_wake_up_counter.u32++;
       csl_state.transmit.wake_up_sequence_start += WAKE_UP_COUNTER_INTERVAL;
     }
     csl_state.transmit.remaining_wake_up_frames =
@@ -201,10 +205,37 @@ on_unicast_transmitted(bool successful, uint_fast8_t burst_index)
   csl_nbr->sync_data = new_sync_data;
 }
 /*---------------------------------------------------------------------------*/
+static bool
+predict_rendezvous(const linkaddr_t *addr, rtimer_clock_t *rendezvous)
+{
+  akes_nbr_entry_t *entry = akes_nbr_get_entry(addr);
+  if(!entry || !entry->permanent) {
+    return false;
+  }
+  const csl_nbr_t *csl_nbr = csl_nbr_get(entry->permanent);
+  const struct csl_synchronizer_splo_data *const sync_data =
+      &csl_nbr->sync_data;
+
+  int32_t compensation = get_compensation(csl_nbr->drift,
+                                          RTIMER_NOW() - sync_data->t);
+  *rendezvous = wake_up_counter_shift_to_future(sync_data->t + compensation);
+  wake_up_counter_t wuc;
+  wuc.u32 = sync_data->his_wake_up_counter_at_t.u32
+            + wake_up_counter_round_increments(*rendezvous
+                                               - compensation
+                                               - sync_data->t);
+  while(skips_wake_up(csl_nbr, wuc)) {
+    wuc.u32++;
+    *rendezvous += WAKE_UP_COUNTER_INTERVAL;
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
 const struct csl_synchronizer csl_synchronizer_splo = {
   init,
   schedule,
-  on_unicast_transmitted
+  on_unicast_transmitted,
+  predict_rendezvous
 };
 /*---------------------------------------------------------------------------*/
 #endif /* !CSL_COMPLIANT */
@@ -42,6 +42,8 @@
 #define CSL_SYNCHRONIZER_H_
 
 #include "contiki.h"
+#include "net/linkaddr.h"
+#include "sys/rtimer.h"
 #include <stdbool.h>
 
 #ifdef CSL_SYNCHRONIZER_CONF
@@ -60,6 +62,10 @@ struct csl_synchronizer {
 
   /** Updates synchronization data after a unicast transmission */
   void (* on_unicast_transmitted)(bool successful, uint_fast8_t burst_index);
+
+  /** Predicts when a transmission to a receiver can start */
+  bool (* predict_rendezvous)(const linkaddr_t *addr,
+                              rtimer_clock_t *rendezvous);
 };
 
 extern const struct csl_synchronizer CSL_SYNCHRONIZER;
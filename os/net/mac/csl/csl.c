@@ -223,6 +223,23 @@ csl_forecast_channel_index(wake_up_counter_t wuc, const linkaddr_t *addr)
   return xored & (CSL_CHANNELS_COUNT - 1);
 }
 /*---------------------------------------------------------------------------*/
+uint_fast16_t
+csl_forecast_rendezvous_mask(uint_fast16_t channels, const linkaddr_t *addr)
+{
+  uint_fast8_t xored = 0;
+  for(size_t i = 0; i < LINKADDR_SIZE; i++) {
+    xored ^= addr->u8[i];
+  }
+
+  uint_fast16_t mask = 0;
+  for(uint_fast8_t i = 0; i < CSL_CHANNELS_COUNT; i++) {
+    if(channels & (1 << ((i ^ xored) & (CSL_CHANNELS_COUNT - 1)))) {
+      mask |= 1 << i;
+    }
+  }
+  return mask;
+}
+/*---------------------------------------------------------------------------*/
 wake_up_counter_t
 csl_get_wake_up_counter(rtimer_clock_t t)
 {
@@ -1472,6 +1489,15 @@ send(mac_callback_t sent, void *ptr)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+bool
+frame_queue_predict_rendezvous(const linkaddr_t *addr,
+                               rtimer_clock_t *rendezvous)
+{
+  return CSL_SYNCHRONIZER.predict_rendezvous(addr, rendezvous);
+}
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+/*---------------------------------------------------------------------------*/
 /** This function is never called as we operate in polling mode throughout */
 static void
 input(void)
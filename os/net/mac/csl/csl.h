@@ -310,6 +310,17 @@ typedef union {
 uint_fast8_t csl_forecast_channel_index(wake_up_counter_t wuc,
                                         const linkaddr_t *addr);
 
+/**
+ * \brief          Computes at which wake ups a receiver listens on any of
+ *                 the specified channels.
+ * \param channels Bitmap of channel indices.
+ * \param addr     The receiver's address.
+ * \return         Bitmap with bit i set if the receiver listens on one of
+ *                 the channels when the LSBs of its wake-up counter equal i.
+ */
+uint_fast16_t csl_forecast_rendezvous_mask(uint_fast16_t channels,
+                                           const linkaddr_t *addr);
+
 /**
  * \brief Computes the wake-up counter at time \c t.
  */
@@ -92,6 +92,17 @@
 #define CSMA_MAX_FRAME_RETRIES 7
 #endif
 
+/* The maximum number of frames that are sent back-to-back to the same
+   neighbor after a single backoff. All but the last frame of such a
+   burst have their frame pending bit set if PACKETBUF_CONF_WITH_PENDING
+   is enabled. Limiting the burst length keeps the other neighbor queues
+   from starving. */
+#ifdef CSMA_CONF_BURST_LENGTH
+#define CSMA_BURST_LENGTH CSMA_CONF_BURST_LENGTH
+#else
+#define CSMA_BURST_LENGTH 1
+#endif
+
 /* Packet metadata */
 struct qbuf_metadata {
   mac_callback_t sent;
@@ -106,6 +117,7 @@ struct neighbor_queue {
   struct ctimer transmit_timer;
   uint8_t transmissions;
   uint8_t collisions;
+  uint8_t burst_index;
   LIST_STRUCT(packet_queue);
 };
 
@@ -136,6 +148,10 @@ MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
 MEMB(packet_memb, struct packet_queue, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
 LIST(neighbor_list);
+#if CSMA_BURST_LENGTH > 1
+/* The neighbor whose next packet is due without backoff */
+static struct neighbor_queue *bursting_neighbor;
+#endif /* CSMA_BURST_LENGTH > 1 */
 
 static void packet_sent(struct neighbor_queue *n,
     struct packet_queue *q,
@@ -170,6 +186,15 @@ backoff_period(void)
 #endif /* CONTIKI_TARGET_COOJA */
 }
 /*---------------------------------------------------------------------------*/
+#if CSMA_BURST_LENGTH > 1
+static bool
+continues_burst(struct neighbor_queue *n)
+{
+  return n->burst_index + 1 < CSMA_BURST_LENGTH
+         && !linkaddr_cmp(&n->addr, &linkaddr_null);
+}
+#endif /* CSMA_BURST_LENGTH > 1 */
+/*---------------------------------------------------------------------------*/
 static int
 send_one_packet(struct neighbor_queue *n, struct packet_queue *q)
 {
@@ -274,8 +299,14 @@ transmit_from_queue(void *ptr)
 {
   struct neighbor_queue *n = ptr;
   if(n) {
-    struct packet_queue *q = list_head(n->packet_queue);
-    if(q != NULL) {
+#if CSMA_BURST_LENGTH > 1
+    do {
+      bursting_neighbor = NULL;
+#endif /* CSMA_BURST_LENGTH > 1 */
+      struct packet_queue *q = list_head(n->packet_queue);
+      if(q == NULL) {
+        return;
+      }
       LOG_INFO("preparing packet for ");
       LOG_INFO_LLADDR(&n->addr);
       LOG_INFO_(", seqno %u, tx %u, queue %d\n",
@@ -283,8 +314,15 @@ transmit_from_queue(void *ptr)
         n->transmissions, list_length(n->packet_queue));
       /* Send first packet in the neighbor queue */
       queuebuf_to_packetbuf(q->buf);
+#if CSMA_BURST_LENGTH > 1 && PACKETBUF_WITH_PENDING
+      /* Announce if the next packet follows immediately */
+      packetbuf_set_attr(PACKETBUF_ATTR_PENDING,
+                         list_item_next(q) != NULL && continues_burst(n));
+#endif /* CSMA_BURST_LENGTH > 1 && PACKETBUF_WITH_PENDING */
       send_one_packet(n, q);
-    }
+#if CSMA_BURST_LENGTH > 1
+    } while(bursting_neighbor == n);
+#endif /* CSMA_BURST_LENGTH > 1 */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -294,6 +332,7 @@ schedule_transmission(struct neighbor_queue *n)
   clock_time_t delay;
   int backoff_exponent; /* BE in IEEE 802.15.4 */
 
+  n->burst_index = 0;
   backoff_exponent = MIN(n->collisions + CSMA_MIN_BE, CSMA_MAX_BE);
 
   /* Compute max delay as per IEEE 802.15.4: 2^BE-1 backoff periods  */
@@ -324,6 +363,14 @@ free_packet(struct neighbor_queue *n, struct packet_queue *p, int status)
       /* There is a next packet. We reset current tx information */
       n->transmissions = 0;
       n->collisions = 0;
+#if CSMA_BURST_LENGTH > 1
+      if(status == MAC_TX_OK && continues_burst(n)) {
+        /* Send the next packet right after the sent callback */
+        n->burst_index++;
+        bursting_neighbor = n;
+        return;
+      }
+#endif /* CSMA_BURST_LENGTH > 1 */
       /* Schedule next transmissions */
       schedule_transmission(n);
     } else {
@@ -475,6 +522,7 @@ csma_output_packet(mac_callback_t sent, void *ptr)
       linkaddr_copy(&n->addr, addr);
       n->transmissions = 0;
       n->collisions = 0;
+      n->burst_index = 0;
       /* Init packet queue for this neighbor */
       LIST_STRUCT_INIT(n, packet_queue);
       /* Add neighbor to the neighbor list */
@@ -96,17 +96,72 @@
 #define BACKOFF_PERIOD (CLOCK_SECOND / WAKE_UP_COUNTER_RATE)
 #endif /* FRAME_QUEUE_CONF_BACKOFF_PERIOD */
 
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+struct candidate {
+  frame_queue_entry_t *fqe;
+  linkaddr_t receiver;
+  rtimer_clock_t rendezvous;
+  bool is_predictable;
+};
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+
+/*
+ * maximum number of queued unicast data frames per receiver, i.e., per final
+ * destination in SMOR since forwarders are only selected once admitted.
+ * Command frames are only subject to MAX_COMMAND_FRAMES.
+ */
+#ifdef FRAME_QUEUE_CONF_MAX_FRAMES_PER_NEIGHBOR
+#define MAX_FRAMES_PER_NEIGHBOR FRAME_QUEUE_CONF_MAX_FRAMES_PER_NEIGHBOR
+#else /* FRAME_QUEUE_CONF_MAX_FRAMES_PER_NEIGHBOR */
+#define MAX_FRAMES_PER_NEIGHBOR QUEUEBUF_NUM
+#endif /* FRAME_QUEUE_CONF_MAX_FRAMES_PER_NEIGHBOR */
+
+/* maximum number of queued unicast data frames */
+#ifdef FRAME_QUEUE_CONF_MAX_DATA_FRAMES
+#define MAX_DATA_FRAMES FRAME_QUEUE_CONF_MAX_DATA_FRAMES
+#else /* FRAME_QUEUE_CONF_MAX_DATA_FRAMES */
+#define MAX_DATA_FRAMES QUEUEBUF_NUM
+#endif /* FRAME_QUEUE_CONF_MAX_DATA_FRAMES */
+
+/* maximum number of queued command frames */
+#ifdef FRAME_QUEUE_CONF_MAX_COMMAND_FRAMES
+#define MAX_COMMAND_FRAMES FRAME_QUEUE_CONF_MAX_COMMAND_FRAMES
+#else /* FRAME_QUEUE_CONF_MAX_COMMAND_FRAMES */
+#define MAX_COMMAND_FRAMES QUEUEBUF_NUM
+#endif /* FRAME_QUEUE_CONF_MAX_COMMAND_FRAMES */
+
+/* maximum number of queued broadcast data frames */
+#ifdef FRAME_QUEUE_CONF_MAX_BROADCAST_FRAMES
+#define MAX_BROADCAST_FRAMES FRAME_QUEUE_CONF_MAX_BROADCAST_FRAMES
+#else /* FRAME_QUEUE_CONF_MAX_BROADCAST_FRAMES */
+#define MAX_BROADCAST_FRAMES QUEUEBUF_NUM
+#endif /* FRAME_QUEUE_CONF_MAX_BROADCAST_FRAMES */
+
 struct csmaca_status {
   clock_time_t next_attempt;
   bool is_active;
   uint8_t transmissions;
   uint8_t collisions;
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+  /* prediction made during the current pick */
+  rtimer_clock_t rendezvous;
+  bool is_predicted;
+  bool is_predictable;
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
 };
 
+static const size_t class_quotas[FRAME_QUEUE_CLASS_COUNT] = {
+  MAX_DATA_FRAMES,
+  MAX_COMMAND_FRAMES,
+  MAX_BROADCAST_FRAMES
+};
 LIST(frame_queue_list);
 MEMB(frame_queue_memb, frame_queue_entry_t, QUEUEBUF_NUM);
 static struct csmaca_status broadcast_csmaca_status;
 NBR_TABLE(struct csmaca_status, unicast_csmaca_statuses);
+#if FRAME_QUEUE_WITH_STATS
+struct frame_queue_stats frame_queue_stats;
+#endif /* FRAME_QUEUE_WITH_STATS */
 
 /*---------------------------------------------------------------------------*/
 void
@@ -136,6 +191,9 @@ get_csmaca_status(const linkaddr_t *addr)
         return NULL;
       }
       csmaca_status->is_active = false;
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+      csmaca_status->is_predicted = false;
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
     }
     /* lock while having pending frames */
     nbr_table_lock(unicast_csmaca_statuses, csmaca_status);
@@ -202,6 +260,91 @@ release_csmaca_status(struct csmaca_status *csmaca_status)
   }
 }
 /*---------------------------------------------------------------------------*/
+static frame_queue_class_t
+get_class(bool is_cmd_frame, const linkaddr_t *receiver)
+{
+  if(is_cmd_frame) {
+    return FRAME_QUEUE_CLASS_COMMAND;
+  }
+  if(linkaddr_cmp(receiver, &linkaddr_null)) {
+    return FRAME_QUEUE_CLASS_BROADCAST;
+  }
+  return FRAME_QUEUE_CLASS_DATA;
+}
+/*---------------------------------------------------------------------------*/
+size_t
+frame_queue_count_class(frame_queue_class_t class)
+{
+  size_t count = 0;
+  for(frame_queue_entry_t *fqe = frame_queue_head();
+      fqe;
+      fqe = frame_queue_next(fqe)) {
+    if(get_class(queuebuf_holds_cmd_frame(fqe->qb),
+                 queuebuf_addr(fqe->qb, PACKETBUF_ADDR_RECEIVER))
+       == class) {
+      count++;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+size_t
+frame_queue_count_receiver(const linkaddr_t *addr)
+{
+  size_t count = 0;
+  for(frame_queue_entry_t *fqe = frame_queue_head();
+      fqe;
+      fqe = frame_queue_next(fqe)) {
+    if(linkaddr_cmp(addr, queuebuf_addr(fqe->qb, PACKETBUF_ADDR_RECEIVER))) {
+      count++;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static size_t
+count_data_frames(const linkaddr_t *addr)
+{
+  size_t count = 0;
+  for(frame_queue_entry_t *fqe = frame_queue_head();
+      fqe;
+      fqe = frame_queue_next(fqe)) {
+    if(!queuebuf_holds_cmd_frame(fqe->qb)
+       && linkaddr_cmp(addr, queuebuf_addr(fqe->qb, PACKETBUF_ADDR_RECEIVER))) {
+      count++;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+is_admissible(void)
+{
+  const linkaddr_t *receiver = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
+  bool is_cmd_frame = packetbuf_holds_cmd_frame();
+  /* an AKES command frame must not be held off by queued data frames */
+  if(!is_cmd_frame
+     && !linkaddr_cmp(receiver, &linkaddr_null)
+     && (count_data_frames(receiver) >= MAX_FRAMES_PER_NEIGHBOR)) {
+    LOG_WARN("quota of ");
+    LOG_WARN_LLADDR(receiver);
+    LOG_WARN_(" is used up\n");
+#if FRAME_QUEUE_WITH_STATS
+    frame_queue_stats.rejected_by_neighbor_quota++;
+#endif /* FRAME_QUEUE_WITH_STATS */
+    return false;
+  }
+  frame_queue_class_t class = get_class(is_cmd_frame, receiver);
+  if(frame_queue_count_class(class) >= class_quotas[class]) {
+    LOG_WARN("quota of class %i is used up\n", class);
+#if FRAME_QUEUE_WITH_STATS
+    frame_queue_stats.rejected_by_class_quota++;
+#endif /* FRAME_QUEUE_WITH_STATS */
+    return false;
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
 bool
 frame_queue_add(mac_callback_t sent, void *ptr)
 {
@@ -209,9 +352,16 @@ frame_queue_add(mac_callback_t sent, void *ptr)
     packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS,
                        MAX_RETRANSMISSIONS + 1);
   }
+  if(!is_admissible()) {
+    mac_call_sent_callback(sent, ptr, MAC_TX_QUEUE_FULL, 0);
+    return false;
+  }
   frame_queue_entry_t *new_fqe = memb_alloc(&frame_queue_memb);
   if(!new_fqe) {
     LOG_ERR("buffer is full\n");
+#if FRAME_QUEUE_WITH_STATS
+    frame_queue_stats.rejected_by_full_pool++;
+#endif /* FRAME_QUEUE_WITH_STATS */
     mac_call_sent_callback(sent, ptr, MAC_TX_QUEUE_FULL, 0);
     return false;
   }
@@ -226,12 +376,19 @@ frame_queue_add(mac_callback_t sent, void *ptr)
   new_fqe->qb = queuebuf_new_from_packetbuf();
   if(!new_fqe->qb) {
     LOG_ERR("queuebuf is full\n");
+#if FRAME_QUEUE_WITH_STATS
+    frame_queue_stats.rejected_by_full_pool++;
+#endif /* FRAME_QUEUE_WITH_STATS */
     memb_free(&frame_queue_memb, new_fqe);
     mac_call_sent_callback(sent, ptr, MAC_TX_QUEUE_FULL, 0);
     return false;
   }
   new_fqe->ptr = ptr;
   new_fqe->sent = sent;
+#if FRAME_QUEUE_WITH_STATS
+  new_fqe->enqueued_at = clock_time();
+  frame_queue_stats.enqueued++;
+#endif /* FRAME_QUEUE_WITH_STATS */
 #if FRAME_QUEUE_BROADCASTS_AS_UNICASTS
   new_fqe->neighbor_bitmap = 0;
   assert(AKES_NBR_MAX <= (sizeof(new_fqe->neighbor_bitmap) * 8));
@@ -247,23 +404,100 @@ remove_entry(frame_queue_entry_t *fqe, int status, int num_tx)
 {
   mac_callback_t sent = fqe->sent;
   void *ptr = fqe->ptr;
+#if FRAME_QUEUE_WITH_STATS
+  frame_queue_stats.dequeued++;
+  frame_queue_stats.total_delay += clock_time() - fqe->enqueued_at;
+#endif /* FRAME_QUEUE_WITH_STATS */
   queuebuf_free(fqe->qb);
   list_remove(frame_queue_list, fqe);
   memb_free(&frame_queue_memb, fqe);
   mac_call_sent_callback(sent, ptr, status, num_tx);
 }
 /*---------------------------------------------------------------------------*/
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+static void
+forget_predictions(void)
+{
+  broadcast_csmaca_status.is_predicted = false;
+  for(struct csmaca_status *csmaca_status =
+          nbr_table_head(unicast_csmaca_statuses);
+      csmaca_status;
+      csmaca_status = nbr_table_next(unicast_csmaca_statuses,
+                                     csmaca_status)) {
+    csmaca_status->is_predicted = false;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static bool
+predict_rendezvous(struct csmaca_status *csmaca_status,
+                   const linkaddr_t *receiver,
+                   rtimer_clock_t *rendezvous)
+{
+  /*
+   * Predict only once per pick so that all frames to the same receiver
+   * compare equal and thus remain in FIFO order
+   */
+  if(!csmaca_status->is_predicted) {
+    csmaca_status->is_predictable =
+        frame_queue_predict_rendezvous(receiver, &csmaca_status->rendezvous);
+    csmaca_status->is_predicted = true;
+  }
+  *rendezvous = csmaca_status->rendezvous;
+  return csmaca_status->is_predictable;
+}
+/*---------------------------------------------------------------------------*/
+static void
+consider(struct candidate *best,
+         frame_queue_entry_t *fqe,
+         const linkaddr_t *receiver,
+         struct csmaca_status *csmaca_status)
+{
+  if(best->fqe && !best->is_predictable) {
+    /* an older frame is sent right away */
+    return;
+  }
+
+  rtimer_clock_t rendezvous = 0;
+  bool is_predictable = receiver
+#if AKES_MAC_ENABLED
+                        && !(queuebuf_holds_cmd_frame(fqe->qb)
+                             && akes_mac_is_hello_helloack_or_ack(
+                                 queuebuf_get_dispatch_byte(fqe->qb)))
+#endif /* AKES_MAC_ENABLED */
+                        && predict_rendezvous(csmaca_status,
+                                              receiver,
+                                              &rendezvous);
+  if(best->fqe
+     && (!is_predictable
+         || !RTIMER_CLOCK_LT(rendezvous, best->rendezvous))) {
+    /* only an earlier rendezvous justifies overtaking older frames */
+    return;
+  }
+
+  best->fqe = fqe;
+  best->is_predictable = is_predictable;
+  best->rendezvous = rendezvous;
+  if(receiver) {
+    linkaddr_copy(&best->receiver, receiver);
+  }
+}
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+/*---------------------------------------------------------------------------*/
 frame_queue_entry_t *
 frame_queue_pick(void)
 {
   clock_time_t now = clock_time();
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+  struct candidate best = { NULL };
+  forget_predictions();
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
   for(frame_queue_entry_t *fqe = frame_queue_head();
       fqe;
       fqe = frame_queue_next(fqe)) {
 #if FRAME_QUEUE_BROADCASTS_AS_UNICASTS
     if(fqe->is_broadcast_as_unicast) {
       /* find a permanent neighbor that has not received this frame, yet */
-      const struct csmaca_status *csmaca_status = NULL;
+      struct csmaca_status *csmaca_status = NULL;
       for(akes_nbr_entry_t *entry = akes_nbr_head(AKES_NBR_PERMANENT);
           entry;
           entry = akes_nbr_next(entry, AKES_NBR_PERMANENT)) {
@@ -277,9 +511,13 @@ frame_queue_pick(void)
         if(CLOCK_LT(now, csmaca_status->next_attempt)) {
           continue;
         }
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+        consider(&best, fqe, akes_nbr_get_addr(entry), csmaca_status);
+#else /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
         queuebuf_to_packetbuf(fqe->qb);
         packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, akes_nbr_get_addr(entry));
         return fqe;
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
       }
       if(!csmaca_status) {
         queuebuf_to_packetbuf(fqe->qb);
@@ -292,7 +530,7 @@ frame_queue_pick(void)
 
 #ifdef SMOR
     const linkaddr_t *lost_forwarder;
-    const struct csmaca_status *csmaca_status =
+    struct csmaca_status *csmaca_status =
         get_soonest_csmaca_status(fqe, &lost_forwarder);
     if(lost_forwarder) {
       queuebuf_to_packetbuf(fqe->qb);
@@ -303,7 +541,7 @@ frame_queue_pick(void)
     }
     assert(csmaca_status);
 #else /* SMOR */
-    const struct csmaca_status *csmaca_status =
+    struct csmaca_status *csmaca_status =
         get_csmaca_status(queuebuf_addr(fqe->qb, PACKETBUF_ADDR_RECEIVER));
     if(!csmaca_status) {
       LOG_ERR("could not get CSMA-CA status\n");
@@ -318,12 +556,45 @@ frame_queue_pick(void)
       continue;
     }
 
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+#ifdef SMOR
+    /* SMOR chooses among forwarders later on */
+    consider(&best, fqe, NULL, NULL);
+#else /* SMOR */
+    consider(&best,
+             fqe,
+             queuebuf_addr(fqe->qb, PACKETBUF_ADDR_RECEIVER),
+             csmaca_status);
+#endif /* SMOR */
+#else /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
     queuebuf_to_packetbuf(fqe->qb);
     return fqe;
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+  }
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+  if(best.fqe) {
+    queuebuf_to_packetbuf(best.fqe->qb);
+#if FRAME_QUEUE_BROADCASTS_AS_UNICASTS
+    if(best.fqe->is_broadcast_as_unicast) {
+      packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &best.receiver);
+    }
+#endif /* FRAME_QUEUE_BROADCASTS_AS_UNICASTS */
+    return best.fqe;
   }
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+#if FRAME_QUEUE_WITH_STATS
+clock_time_t
+frame_queue_get_average_delay(void)
+{
+  return frame_queue_stats.dequeued
+         ? frame_queue_stats.total_delay / frame_queue_stats.dequeued
+         : 0;
+}
+#endif /* FRAME_QUEUE_WITH_STATS */
+/*---------------------------------------------------------------------------*/
 frame_queue_entry_t *
 frame_queue_head(void)
 {
@@ -42,7 +42,9 @@
 #include "net/linkaddr.h"
 #include "net/mac/mac.h"
 #include "sys/clock.h"
+#include "sys/rtimer.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef FRAME_QUEUE_CONF_BROADCASTS_AS_UNICASTS
@@ -58,6 +60,19 @@
 #define FRAME_QUEUE_MAX_FORWARDERS (2)
 #endif /* FRAME_QUEUE_CONF_MAX_FORWARDERS */
 
+#ifdef FRAME_QUEUE_CONF_WITH_EARLIEST_RENDEZVOUS_FIRST
+#define FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST \
+  FRAME_QUEUE_CONF_WITH_EARLIEST_RENDEZVOUS_FIRST
+#else /* FRAME_QUEUE_CONF_WITH_EARLIEST_RENDEZVOUS_FIRST */
+#define FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST 0
+#endif /* FRAME_QUEUE_CONF_WITH_EARLIEST_RENDEZVOUS_FIRST */
+
+#ifdef FRAME_QUEUE_CONF_WITH_STATS
+#define FRAME_QUEUE_WITH_STATS FRAME_QUEUE_CONF_WITH_STATS
+#else /* FRAME_QUEUE_CONF_WITH_STATS */
+#define FRAME_QUEUE_WITH_STATS 0
+#endif /* FRAME_QUEUE_CONF_WITH_STATS */
+
 #ifdef SMOR
 typedef struct frame_queue_forwarder_t {
   linkaddr_t addr;
@@ -70,6 +85,9 @@ typedef struct frame_queue_entry {
   struct queuebuf *qb;
   mac_callback_t sent;
   void *ptr;
+#if FRAME_QUEUE_WITH_STATS
+  clock_time_t enqueued_at;
+#endif /* FRAME_QUEUE_WITH_STATS */
 #if FRAME_QUEUE_BROADCASTS_AS_UNICASTS
   uint32_t neighbor_bitmap;
   bool is_broadcast_as_unicast;
@@ -79,6 +97,32 @@ typedef struct frame_queue_entry {
 #endif /* FRAME_QUEUE_BROADCASTS_AS_UNICASTS */
 } frame_queue_entry_t;
 
+typedef enum {
+  FRAME_QUEUE_CLASS_DATA = 0,
+  FRAME_QUEUE_CLASS_COMMAND,
+  FRAME_QUEUE_CLASS_BROADCAST,
+  FRAME_QUEUE_CLASS_COUNT
+} frame_queue_class_t;
+
+#if FRAME_QUEUE_WITH_STATS
+struct frame_queue_stats {
+  /** Number of frames that entered the queue */
+  uint32_t enqueued;
+  /** Number of frames that left the queue */
+  uint32_t dequeued;
+  /** Sum of the times that these frames spent in the queue */
+  uint32_t total_delay;
+  /** Number of frames rejected since their receiver reached its quota */
+  uint32_t rejected_by_neighbor_quota;
+  /** Number of frames rejected since their class reached its quota */
+  uint32_t rejected_by_class_quota;
+  /** Number of frames rejected since the queuebuf pool was exhausted */
+  uint32_t rejected_by_full_pool;
+};
+
+extern struct frame_queue_stats frame_queue_stats;
+#endif /* FRAME_QUEUE_WITH_STATS */
+
 /**
  * \brief Initializes.
  */
@@ -91,14 +135,55 @@ bool frame_queue_is_backing_off(const linkaddr_t *addr);
 
 /**
  * \brief Buffers outgoing frames.
+ *
+ *        Frames to a receiver or of a class that has used up its quota are
+ *        rejected with MAC_TX_QUEUE_FULL, leaving room for others. In SMOR,
+ *        the per-receiver quota applies per final destination.
  */
 bool frame_queue_add(mac_callback_t sent, void *ptr);
 
 /**
  * \brief Selects the next frame to transmit.
+ *
+ *        With FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST, this prefers the
+ *        frame whose receiver is predicted to wake up first. Frames without
+ *        a prediction never overtake older frames.
  */
 frame_queue_entry_t *frame_queue_pick(void);
 
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+/**
+ * \brief            Predicts when a transmission to a receiver can start.
+ * \param addr       The receiver's address.
+ * \param rendezvous Set to the predicted start of the transmission.
+ * \return           false if no prediction is possible, e.g., since the
+ *                   receiver's wake-up times are unknown.
+ * \note             This function is implemented by the MAC protocol.
+ */
+bool frame_queue_predict_rendezvous(const linkaddr_t *addr,
+                                    rtimer_clock_t *rendezvous);
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+
+#if FRAME_QUEUE_WITH_STATS
+/**
+ * \brief Returns the average time that frames spent in the queue.
+ */
+clock_time_t frame_queue_get_average_delay(void);
+#endif /* FRAME_QUEUE_WITH_STATS */
+
+/**
+ * \brief Returns the number of queued frames of a class.
+ */
+size_t frame_queue_count_class(frame_queue_class_t class);
+
+/**
+ * \brief Returns the number of queued frames to a receiver.
+ *
+ *        Passing linkaddr_null counts the queued broadcast frames. In SMOR,
+ *        the receiver is the final destination rather than the next hop.
+ */
+size_t frame_queue_count_receiver(const linkaddr_t *addr);
+
 /**
  * \brief Returns the first entry in the queue.
  */
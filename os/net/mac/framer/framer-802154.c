@@ -111,7 +111,11 @@ framer_802154_setup_params(packetbuf_attr_t (*get_attr)(uint8_t type),
 
   /* Build the FCF. */
   params->fcf.frame_type = get_attr(PACKETBUF_ATTR_FRAME_TYPE);
+#if PACKETBUF_WITH_PENDING
+  params->fcf.frame_pending = get_attr(PACKETBUF_ATTR_PENDING) ? 1 : 0;
+#else /* PACKETBUF_WITH_PENDING */
   params->fcf.frame_pending = 0;
+#endif /* PACKETBUF_WITH_PENDING */
   if(dest_is_broadcast) {
     params->fcf.ack_required = 0;
 #if FRAME802154_VERSION == FRAME802154_IEEE802154_2015
@@ -216,6 +220,9 @@ parse(void)
   if(hdr_len && packetbuf_hdrreduce(hdr_len)) {
     packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, frame.fcf.frame_type);
     packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, frame.fcf.ack_required);
+#if PACKETBUF_WITH_PENDING
+    packetbuf_set_attr(PACKETBUF_ATTR_PENDING, frame.fcf.frame_pending);
+#endif /* PACKETBUF_WITH_PENDING */
 
     if(frame.fcf.dest_addr_mode) {
       if(frame.dest_pid != frame802154_get_pan_id() &&
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup llsec802154
+ * @{
+ *
+ * \file
+ *         Table of recently computed one-time passwords of POTR frames.
+ */
+
+#include "net/mac/otp-table.h"
+#include <string.h>
+
+#if OTP_TABLE_SIZE
+struct entry {
+  bool is_used;
+  uint8_t key[AES_128_KEY_LENGTH];
+  uint8_t nonce[CCM_STAR_NONCE_LENGTH];
+  uint8_t a;
+  uint8_t otp_len;
+  uint8_t otp[OTP_TABLE_MAX_OTP_LEN];
+};
+
+static struct entry entries[OTP_TABLE_SIZE];
+static uint_fast8_t next_index;
+static uint32_t current_window;
+#endif /* OTP_TABLE_SIZE */
+#if OTP_TABLE_WITH_STATS
+struct otp_table_stats otp_table_stats;
+#define STATS_INC(field) (otp_table_stats.field++)
+#else /* OTP_TABLE_WITH_STATS */
+#define STATS_INC(field)
+#endif /* OTP_TABLE_WITH_STATS */
+
+/*---------------------------------------------------------------------------*/
+#if OTP_TABLE_SIZE
+static struct entry *
+lookup(const uint8_t key[static AES_128_KEY_LENGTH],
+       const uint8_t nonce[static CCM_STAR_NONCE_LENGTH],
+       uint8_t a,
+       uint_fast8_t otp_len)
+{
+  for(uint_fast8_t i = 0; i < OTP_TABLE_SIZE; i++) {
+    /*
+     * Key buffers get rewritten and reused when keys are installed or
+     * freed, hence compare the keys themselves, and in constant time
+     */
+    if(entries[i].is_used
+       && (entries[i].a == a)
+       && (entries[i].otp_len == otp_len)
+       && !memcmp(entries[i].nonce, nonce, CCM_STAR_NONCE_LENGTH)
+       && otp_table_equals(entries[i].key, key, AES_128_KEY_LENGTH)) {
+      return entries + i;
+    }
+  }
+  return NULL;
+}
+#endif /* OTP_TABLE_SIZE */
+/*---------------------------------------------------------------------------*/
+bool
+otp_table_compute(uint32_t window,
+                  const uint8_t key[static AES_128_KEY_LENGTH],
+                  const uint8_t nonce[static CCM_STAR_NONCE_LENGTH],
+                  uint8_t a,
+                  uint8_t *otp, uint_fast8_t otp_len)
+{
+#if OTP_TABLE_SIZE
+  if(otp_len > OTP_TABLE_MAX_OTP_LEN) {
+    return false;
+  }
+  if(window != current_window) {
+    otp_table_flush();
+    current_window = window;
+  }
+  struct entry *entry = lookup(key, nonce, a, otp_len);
+  if(entry) {
+    STATS_INC(hits);
+    memcpy(otp, entry->otp, otp_len);
+    return true;
+  }
+#endif /* OTP_TABLE_SIZE */
+
+  STATS_INC(misses);
+  if(!CCM_STAR.set_key(key)
+     || !CCM_STAR.aead(nonce, NULL, 0, &a, 1, otp, otp_len, false)) {
+    return false;
+  }
+
+#if OTP_TABLE_SIZE
+  entry = entries + next_index;
+  next_index = (next_index + 1) % OTP_TABLE_SIZE;
+  entry->is_used = true;
+  memcpy(entry->key, key, AES_128_KEY_LENGTH);
+  memcpy(entry->nonce, nonce, CCM_STAR_NONCE_LENGTH);
+  entry->a = a;
+  entry->otp_len = otp_len;
+  memcpy(entry->otp, otp, otp_len);
+#endif /* OTP_TABLE_SIZE */
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+bool
+otp_table_equals(const uint8_t *expected, const uint8_t *received, size_t len)
+{
+  /* no early exit so as to not leak the position of the first mismatch */
+  uint_fast8_t diff = 0;
+  for(size_t i = 0; i < len; i++) {
+    diff |= expected[i] ^ received[i];
+  }
+  return !diff;
+}
+/*---------------------------------------------------------------------------*/
+void
+otp_table_flush(void)
+{
+#if OTP_TABLE_SIZE
+  memset(entries, 0, sizeof(entries));
+  next_index = 0;
+#endif /* OTP_TABLE_SIZE */
+}
+/*---------------------------------------------------------------------------*/
+
+/** @} */
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup llsec802154
+ * @{
+ *
+ * \file
+ *         Table of recently computed one-time passwords (OTPs) of POTR
+ *         frames, which spares recomputing them when similar wake-up
+ *         frames are received repeatedly within a wake up.
+ */
+
+#ifndef OTP_TABLE_H_
+#define OTP_TABLE_H_
+
+#include "contiki.h"
+#include "lib/ccm-star.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* number of cached OTPs; 0 disables caching */
+#ifdef OTP_TABLE_CONF_SIZE
+#define OTP_TABLE_SIZE OTP_TABLE_CONF_SIZE
+#else /* OTP_TABLE_CONF_SIZE */
+#define OTP_TABLE_SIZE 0
+#endif /* OTP_TABLE_CONF_SIZE */
+
+#ifdef OTP_TABLE_CONF_MAX_OTP_LEN
+#define OTP_TABLE_MAX_OTP_LEN OTP_TABLE_CONF_MAX_OTP_LEN
+#else /* OTP_TABLE_CONF_MAX_OTP_LEN */
+#define OTP_TABLE_MAX_OTP_LEN 4
+#endif /* OTP_TABLE_CONF_MAX_OTP_LEN */
+
+#ifdef OTP_TABLE_CONF_WITH_STATS
+#define OTP_TABLE_WITH_STATS OTP_TABLE_CONF_WITH_STATS
+#else /* OTP_TABLE_CONF_WITH_STATS */
+#define OTP_TABLE_WITH_STATS 0
+#endif /* OTP_TABLE_CONF_WITH_STATS */
+
+#if OTP_TABLE_WITH_STATS
+struct otp_table_stats {
+  uint32_t hits;
+  uint32_t misses;
+};
+
+extern struct otp_table_stats otp_table_stats;
+#endif /* OTP_TABLE_WITH_STATS */
+
+/**
+ * \brief         Computes the CCM* MIC of a single byte of associated data.
+ * \param window  Identifies the current wake up. Cached OTPs of other wake
+ *                ups are discarded.
+ * \param key     The key. Cached OTPs are looked up by the key's contents,
+ *                and CCM_STAR.set_key() is only called on a cache miss.
+ * \param nonce   The nonce to use.
+ * \param a       The associated data.
+ * \param otp     Where to store the OTP.
+ * \param otp_len Length of the OTP.
+ * \return        True on success.
+ */
+bool otp_table_compute(uint32_t window,
+                       const uint8_t key[static AES_128_KEY_LENGTH],
+                       const uint8_t nonce[static CCM_STAR_NONCE_LENGTH],
+                       uint8_t a,
+                       uint8_t *otp, uint_fast8_t otp_len);
+
+/**
+ * \brief Compares a received with an expected OTP in constant time.
+ */
+bool otp_table_equals(const uint8_t *expected,
+                      const uint8_t *received,
+                      size_t len);
+
+/**
+ * \brief Discards all cached OTPs.
+ */
+void otp_table_flush(void);
+
+#endif /* OTP_TABLE_H_ */
+
+/** @} */
@@ -314,6 +314,30 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Keep the unicast neighbors with non-empty queues in a ready list, which
+ * shared links to the broadcast address serve in deficit round-robin
+ * order. Otherwise, all neighbors are scanned in neighbor table order */
+#ifdef TSCH_QUEUE_CONF_WITH_READY_LIST
+#define TSCH_QUEUE_WITH_READY_LIST TSCH_QUEUE_CONF_WITH_READY_LIST
+#else
+#define TSCH_QUEUE_WITH_READY_LIST 0
+#endif
+
+/* Default number of consecutive shared-slot packets per round-robin turn.
+ * Can be changed per neighbor with tsch_queue_set_nbr_quantum */
+#ifdef TSCH_QUEUE_CONF_DRR_QUANTUM
+#define TSCH_QUEUE_DRR_QUANTUM TSCH_QUEUE_CONF_DRR_QUANTUM
+#else
+#define TSCH_QUEUE_DRR_QUANTUM 1
+#endif
+
+/* Record how long packets stay in each neighbor queue */
+#ifdef TSCH_QUEUE_CONF_WITH_DELAY_STATS
+#define TSCH_QUEUE_WITH_DELAY_STATS TSCH_QUEUE_CONF_WITH_DELAY_STATS
+#else
+#define TSCH_QUEUE_WITH_DELAY_STATS 0
+#endif
+
 /******** Configuration: scheduling  *******/
 
 /* Initializes TSCH with a 6TiSCH minimal schedule */
@@ -353,6 +377,21 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep a per-slotframe bitmap of occupied timeslots, so that the next
+ * active link is found with bit scans rather than by walking all links */
+#ifdef TSCH_SCHEDULE_CONF_WITH_BITMAP
+#define TSCH_SCHEDULE_WITH_BITMAP TSCH_SCHEDULE_CONF_WITH_BITMAP
+#else
+#define TSCH_SCHEDULE_WITH_BITMAP 0
+#endif
+
+/* Max slotframe length when TSCH_SCHEDULE_WITH_BITMAP is set */
+#ifdef TSCH_SCHEDULE_CONF_MAX_SLOTFRAME_LENGTH
+#define TSCH_SCHEDULE_MAX_SLOTFRAME_LENGTH TSCH_SCHEDULE_CONF_MAX_SLOTFRAME_LENGTH
+#else
+#define TSCH_SCHEDULE_MAX_SLOTFRAME_LENGTH 512
+#endif
+
 /* To include Sixtop Implementation */
 #ifdef TSCH_CONF_WITH_SIXTOP
 #define TSCH_WITH_SIXTOP TSCH_CONF_WITH_SIXTOP
@@ -75,6 +75,61 @@ NBR_TABLE(struct tsch_neighbor, tsch_neighbors);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+#if TSCH_QUEUE_WITH_READY_LIST
+/* Unicast neighbors whose queue was non-empty when last looked at. The
+ * process context only appends to it while holding the TSCH lock. The slot
+ * operation removes neighbors whose queue turns out empty and rotates
+ * neighbors whose round-robin turn is over. */
+static struct tsch_neighbor *ready_head;
+static struct tsch_neighbor *ready_tail;
+
+/*---------------------------------------------------------------------------*/
+static void
+ready_list_append(struct tsch_neighbor *n)
+{
+  n->next_ready = NULL;
+  if(ready_tail == NULL) {
+    ready_head = n;
+  } else {
+    ready_tail->next_ready = n;
+  }
+  ready_tail = n;
+  n->is_ready = 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Unlinks n, which follows prev (NULL if n is the head) */
+static void
+ready_list_unlink(struct tsch_neighbor *prev, struct tsch_neighbor *n)
+{
+  if(prev == NULL) {
+    ready_head = n->next_ready;
+  } else {
+    prev->next_ready = n->next_ready;
+  }
+  if(ready_tail == n) {
+    ready_tail = prev;
+  }
+  n->next_ready = NULL;
+  n->is_ready = 0;
+  n->drr_deficit = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+ready_list_remove(struct tsch_neighbor *n)
+{
+  struct tsch_neighbor *prev = NULL;
+  struct tsch_neighbor *curr = ready_head;
+  while(curr != NULL) {
+    if(curr == n) {
+      ready_list_unlink(prev, curr);
+      return;
+    }
+    prev = curr;
+    curr = curr->next_ready;
+  }
+}
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
+
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
@@ -97,6 +152,9 @@ tsch_queue_add_nbr(const linkaddr_t *addr)
         ringbufindex_init(&n->tx_ringbuf, TSCH_QUEUE_NUM_PER_NEIGHBOR);
         n->is_broadcast = linkaddr_cmp(addr, &tsch_eb_address)
           || linkaddr_cmp(addr, &tsch_broadcast_address);
+#if TSCH_QUEUE_WITH_READY_LIST
+        n->drr_quantum = TSCH_QUEUE_DRR_QUANTUM;
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
         tsch_queue_backoff_reset(n);
       }
       tsch_release_lock();
@@ -212,6 +270,11 @@ tsch_queue_remove_nbr(struct tsch_neighbor *n)
 {
   if(n != NULL) {
     if(tsch_get_lock()) {
+#if TSCH_QUEUE_WITH_READY_LIST
+      if(n->is_ready) {
+        ready_list_remove(n);
+      }
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
 
       tsch_release_lock();
 
@@ -257,11 +320,24 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
             p->ret = MAC_TX_DEFERRED;
             p->transmissions = 0;
             p->max_transmissions = max_transmissions;
+#if TSCH_QUEUE_WITH_DELAY_STATS
+            p->enqueue_time = clock_time();
+#endif /* TSCH_QUEUE_WITH_DELAY_STATS */
             /* Add to ringbuf (actual add committed through atomic operation) */
             n->tx_array[put_index] = p;
             ringbufindex_put(&n->tx_ringbuf);
             LOG_DBG("packet is added put_index %u, packet %p\n",
                    put_index, p);
+#if TSCH_QUEUE_WITH_READY_LIST
+            /* The slot operation only unlists neighbors it finds with an
+             * empty queue, which this one no longer has */
+            if(!n->is_ready && !n->is_broadcast && tsch_get_lock()) {
+              if(!n->is_ready) {
+                ready_list_append(n);
+              }
+              tsch_release_lock();
+            }
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
             return p;
           } else {
             memb_free(&packet_memb, p);
@@ -372,6 +448,17 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
     }
   }
 
+#if TSCH_QUEUE_WITH_DELAY_STATS
+  if(!in_queue) {
+    clock_time_t delay = clock_time() - p->enqueue_time;
+    n->delay_stats.total += delay;
+    if(delay > n->delay_stats.max) {
+      n->delay_stats.max = delay;
+    }
+    n->delay_stats.count++;
+  }
+#endif /* TSCH_QUEUE_WITH_DELAY_STATS */
+
   return in_queue;
 }
 /*---------------------------------------------------------------------------*/
@@ -463,6 +550,43 @@ tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr, struct tsch_link *li
 struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
+#if TSCH_QUEUE_WITH_READY_LIST
+  if(!tsch_is_locked()) {
+    struct tsch_neighbor *prev = NULL;
+    struct tsch_neighbor *curr_nbr = ready_head;
+    while(curr_nbr != NULL) {
+      struct tsch_neighbor *next_nbr = curr_nbr->next_ready;
+      if(ringbufindex_empty(&curr_nbr->tx_ringbuf)) {
+        /* Nothing left to send */
+        ready_list_unlink(prev, curr_nbr);
+      } else {
+        if(curr_nbr->tx_links_count == 0) {
+          /* Only look up for neighbors we do not have a tx link to */
+          struct tsch_packet *p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
+          if(p != NULL) {
+            if(curr_nbr->drr_deficit == 0) {
+              /* Start a new turn */
+              curr_nbr->drr_deficit = curr_nbr->drr_quantum;
+            }
+            if(curr_nbr->drr_deficit <= 1) {
+              /* Turn over, go to the back of the list */
+              ready_list_unlink(prev, curr_nbr);
+              ready_list_append(curr_nbr);
+            } else {
+              curr_nbr->drr_deficit--;
+            }
+            if(n != NULL) {
+              *n = curr_nbr;
+            }
+            return p;
+          }
+        }
+        prev = curr_nbr;
+      }
+      curr_nbr = next_nbr;
+    }
+  }
+#else /* TSCH_QUEUE_WITH_READY_LIST */
   if(!tsch_is_locked()) {
     struct tsch_neighbor *curr_nbr = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
     struct tsch_packet *p = NULL;
@@ -480,9 +604,39 @@ tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link
       curr_nbr = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, curr_nbr);
     }
   }
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+#if TSCH_QUEUE_WITH_READY_LIST
+/* Sets how many shared-slot packets a neighbor may send per turn */
+void
+tsch_queue_set_nbr_quantum(struct tsch_neighbor *n, uint8_t quantum)
+{
+  if(n != NULL && quantum > 0) {
+    n->drr_quantum = quantum;
+  }
+}
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
+/*---------------------------------------------------------------------------*/
+#if TSCH_QUEUE_WITH_DELAY_STATS
+/* Returns the queueing delay statistics of a neighbor */
+const struct tsch_queue_delay_stats *
+tsch_queue_get_nbr_delay_stats(const struct tsch_neighbor *n)
+{
+  return n != NULL ? &n->delay_stats : NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Resets the queueing delay statistics of a neighbor */
+void
+tsch_queue_reset_nbr_delay_stats(struct tsch_neighbor *n)
+{
+  if(n != NULL) {
+    memset(&n->delay_stats, 0, sizeof(n->delay_stats));
+  }
+}
+#endif /* TSCH_QUEUE_WITH_DELAY_STATS */
+/*---------------------------------------------------------------------------*/
 /* May the neighbor transmit over a shared link? */
 int
 tsch_queue_backoff_expired(const struct tsch_neighbor *n)
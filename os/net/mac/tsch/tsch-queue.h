@@ -46,6 +46,7 @@
 #include "lib/ringbufindex.h"
 #include "net/linkaddr.h"
 #include "net/mac/mac.h"
+#include "net/mac/tsch/tsch-conf.h"
 
 /***** External Variables *****/
 
@@ -163,6 +164,27 @@ struct tsch_packet *tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr,
  * \return The packet if any, else NULL
  */
 struct tsch_packet *tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link);
+#if TSCH_QUEUE_WITH_READY_LIST
+/**
+ * \brief Set the weight of a neighbor in the round-robin service of shared links
+ * \param n The neighbor queue
+ * \param quantum The number of consecutive packets the neighbor may send per turn
+ */
+void tsch_queue_set_nbr_quantum(struct tsch_neighbor *n, uint8_t quantum);
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
+#if TSCH_QUEUE_WITH_DELAY_STATS
+/**
+ * \brief Get the queueing delay statistics of a neighbor
+ * \param n The neighbor queue
+ * \return The statistics of the packets that left the queue after being sent or dropped
+ */
+const struct tsch_queue_delay_stats *tsch_queue_get_nbr_delay_stats(const struct tsch_neighbor *n);
+/**
+ * \brief Reset the queueing delay statistics of a neighbor
+ * \param n The neighbor queue
+ */
+void tsch_queue_reset_nbr_delay_stats(struct tsch_neighbor *n);
+#endif /* TSCH_QUEUE_WITH_DELAY_STATS */
 /**
  * \brief Is the neighbor backoff timer expired?
  * \param n The neighbor queue
@@ -68,6 +68,82 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_BITMAP
+/*---------------------------------------------------------------------------*/
+static void
+occupancy_set(struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  sf->occupancy[timeslot / 32] |= (uint32_t)1 << (timeslot % 32);
+}
+/*---------------------------------------------------------------------------*/
+static void
+occupancy_clear(struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  sf->occupancy[timeslot / 32] &= ~((uint32_t)1 << (timeslot % 32));
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the first occupied timeslot in [from, to), or to if there is none */
+static uint16_t
+occupancy_find(const struct tsch_slotframe *sf, uint16_t from, uint16_t to)
+{
+  while(from < to) {
+    uint32_t bits = sf->occupancy[from / 32] >> (from % 32);
+    if(bits != 0) {
+      from += __builtin_ctzl((unsigned long)bits);
+      return from < to ? from : to;
+    }
+    from = (from | 31) + 1;
+  }
+  return to;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of timeslots from timeslot to the next occupied
+ * timeslot (a full slotframe if timeslot is the only one), or 0 if the
+ * slotframe has no links */
+static uint16_t
+occupancy_time_to_next(const struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  uint16_t next = occupancy_find(sf, timeslot + 1, sf->size.val);
+  if(next < sf->size.val) {
+    return next - timeslot;
+  }
+  next = occupancy_find(sf, 0, timeslot + 1);
+  if(next <= timeslot) {
+    return sf->size.val + next - timeslot;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Inserts a link after all links with a lower or equal timeslot */
+static void
+insert_link_sorted(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  struct tsch_link *prev = NULL;
+  struct tsch_link *curr = list_head(sf->links_list);
+  while(curr != NULL && curr->timeslot <= l->timeslot) {
+    prev = curr;
+    curr = list_item_next(curr);
+  }
+  list_insert(sf->links_list, prev, l);
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the first link with a timeslot not lower than the given one */
+static struct tsch_link *
+first_link_at(struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  struct tsch_link *l = sf->lookup_hint;
+  if(l == NULL || l->timeslot > timeslot) {
+    /* The slotframe wrapped around since the last lookup */
+    l = list_head(sf->links_list);
+  }
+  while(l != NULL && l->timeslot < timeslot) {
+    l = list_item_next(l);
+  }
+  sf->lookup_hint = l;
+  return l;
+}
+#endif /* TSCH_SCHEDULE_WITH_BITMAP */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -76,6 +152,14 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
     return NULL;
   }
 
+#if TSCH_SCHEDULE_WITH_BITMAP
+  if(size > TSCH_SCHEDULE_MAX_SLOTFRAME_LENGTH) {
+    LOG_ERR("! add_slotframe size %u exceeds %u\n",
+            size, TSCH_SCHEDULE_MAX_SLOTFRAME_LENGTH);
+    return NULL;
+  }
+#endif /* TSCH_SCHEDULE_WITH_BITMAP */
+
   if(tsch_schedule_get_slotframe_by_handle(handle)) {
     /* A slotframe with this handle already exists */
     return NULL;
@@ -88,6 +172,10 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       sf->handle = handle;
       TSCH_ASN_DIVISOR_INIT(sf->size, size);
       LIST_STRUCT_INIT(sf, links_list);
+#if TSCH_SCHEDULE_WITH_BITMAP
+      memset(sf->occupancy, 0, sizeof(sf->occupancy));
+      sf->lookup_hint = NULL;
+#endif /* TSCH_SCHEDULE_WITH_BITMAP */
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
     }
@@ -248,8 +336,6 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
       } else {
         static int current_link_handle = 0;
         struct tsch_neighbor *n;
-        /* Add the link to the slotframe */
-        list_add(slotframe->links_list, l);
         /* Initialize link */
         l->handle = current_link_handle++;
         l->link_options = link_options;
@@ -262,6 +348,13 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+        /* Add the link to the slotframe */
+#if TSCH_SCHEDULE_WITH_BITMAP
+        insert_link_sorted(slotframe, l);
+        occupancy_set(slotframe, timeslot);
+#else /* TSCH_SCHEDULE_WITH_BITMAP */
+        list_add(slotframe->links_list, l);
+#endif /* TSCH_SCHEDULE_WITH_BITMAP */
 
         LOG_INFO("add_link sf=%u opt=%s type=%s ts=%u ch=%u addr=",
                  slotframe->handle,
@@ -314,7 +407,21 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
       LOG_INFO_LLADDR(&l->addr);
       LOG_INFO_("\n");
 
+#if TSCH_SCHEDULE_WITH_BITMAP
+      if(slotframe->lookup_hint == l) {
+        slotframe->lookup_hint = NULL;
+      }
+#endif /* TSCH_SCHEDULE_WITH_BITMAP */
       list_remove(slotframe->links_list, l);
+#if TSCH_SCHEDULE_WITH_BITMAP
+      {
+        struct tsch_link *first = first_link_at(slotframe, l->timeslot);
+        if(first == NULL || first->timeslot != l->timeslot) {
+          /* That was the last link in this timeslot */
+          occupancy_clear(slotframe, l->timeslot);
+        }
+      }
+#endif /* TSCH_SCHEDULE_WITH_BITMAP */
       memb_free(&link_memb, l);
 
       /* Release the lock before we update the neighbor (will take the lock) */
@@ -430,6 +537,58 @@ default_tsch_link_comparator(struct tsch_link *a, struct tsch_link *b)
   return a;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Updates the best and backup links with a link occurring in time_to_timeslot timeslots */
+static void
+consider_link(struct tsch_link *l, uint16_t time_to_timeslot,
+              struct tsch_link **curr_best, uint16_t *time_to_curr_best,
+              struct tsch_link **curr_backup)
+{
+  if(*curr_best == NULL || time_to_timeslot < *time_to_curr_best) {
+    *time_to_curr_best = time_to_timeslot;
+    *curr_best = l;
+    *curr_backup = NULL;
+  } else if(time_to_timeslot == *time_to_curr_best) {
+    struct tsch_link *new_best = NULL;
+    /* Two links are overlapping, we need to select one of them.
+     * By standard: prioritize Tx links first, second by lowest handle */
+    if(((*curr_best)->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+      /* Both or neither links have Tx, select the one with lowest handle */
+      if(l->slotframe_handle != (*curr_best)->slotframe_handle) {
+        if(l->slotframe_handle < (*curr_best)->slotframe_handle) {
+          new_best = l;
+        }
+      } else {
+        /* compare the link against the current best link and return the newly selected one */
+        new_best = TSCH_LINK_COMPARATOR(*curr_best, l);
+      }
+    } else {
+      /* Select the link that has the Tx option */
+      if(l->link_options & LINK_OPTION_TX) {
+        new_best = l;
+      }
+    }
+
+    /* Maintain backup_link */
+    /* Check if 'l' best can be used as backup */
+    if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+      if(*curr_backup == NULL || l->slotframe_handle < (*curr_backup)->slotframe_handle) {
+        *curr_backup = l;
+      }
+    }
+    /* Check if curr_best can be used as backup */
+    if(new_best != *curr_best && ((*curr_best)->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+      if(*curr_backup == NULL || (*curr_best)->slotframe_handle < (*curr_backup)->slotframe_handle) {
+        *curr_backup = *curr_best;
+      }
+    }
+
+    /* Maintain curr_best */
+    if(new_best != NULL) {
+      *curr_best = new_best;
+    }
+  }
+}
 /*---------------------------------------------------------------------------*/
 /* Returns the next active link after a given ASN, and a backup link (for the same ASN, with Rx flag) */
 struct tsch_link *
@@ -448,59 +607,31 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_WITH_BITMAP
+      uint16_t time_to_timeslot = occupancy_time_to_next(sf, timeslot);
+      /* Only the links of the earliest occupied timeslot are candidates */
+      if(time_to_timeslot != 0
+         && (curr_best == NULL || time_to_timeslot <= time_to_curr_best)) {
+        uint16_t next_timeslot = (timeslot + time_to_timeslot) % sf->size.val;
+        struct tsch_link *l = first_link_at(sf, next_timeslot);
+        while(l != NULL && l->timeslot == next_timeslot) {
+          consider_link(l, time_to_timeslot,
+                        &curr_best, &time_to_curr_best, &curr_backup);
+          l = list_item_next(l);
+        }
+      }
+#else /* TSCH_SCHEDULE_WITH_BITMAP */
       struct tsch_link *l = list_head(sf->links_list);
       while(l != NULL) {
         uint16_t time_to_timeslot =
           l->timeslot > timeslot ?
           l->timeslot - timeslot :
           sf->size.val + l->timeslot - timeslot;
-        if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
-          time_to_curr_best = time_to_timeslot;
-          curr_best = l;
-          curr_backup = NULL;
-        } else if(time_to_timeslot == time_to_curr_best) {
-          struct tsch_link *new_best = NULL;
-          /* Two links are overlapping, we need to select one of them.
-           * By standard: prioritize Tx links first, second by lowest handle */
-          if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
-            /* Both or neither links have Tx, select the one with lowest handle */
-            if(l->slotframe_handle != curr_best->slotframe_handle) {
-              if(l->slotframe_handle < curr_best->slotframe_handle) {
-                new_best = l;
-              }
-            } else {
-              /* compare the link against the current best link and return the newly selected one */
-              new_best = TSCH_LINK_COMPARATOR(curr_best, l);
-            }
-          } else {
-            /* Select the link that has the Tx option */
-            if(l->link_options & LINK_OPTION_TX) {
-              new_best = l;
-            }
-          }
-
-          /* Maintain backup_link */
-          /* Check if 'l' best can be used as backup */
-          if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-            if(curr_backup == NULL || l->slotframe_handle < curr_backup->slotframe_handle) {
-              curr_backup = l;
-            }
-          }
-          /* Check if curr_best can be used as backup */
-          if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-            if(curr_backup == NULL || curr_best->slotframe_handle < curr_backup->slotframe_handle) {
-              curr_backup = curr_best;
-            }
-          }
-
-          /* Maintain curr_best */
-          if(new_best != NULL) {
-            curr_best = new_best;
-          }
-        }
-
+        consider_link(l, time_to_timeslot,
+                      &curr_best, &time_to_curr_best, &curr_backup);
         l = list_item_next(l);
       }
+#endif /* TSCH_SCHEDULE_WITH_BITMAP */
       sf = list_item_next(sf);
     }
     if(time_offset != NULL) {
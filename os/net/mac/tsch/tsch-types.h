@@ -91,6 +91,13 @@ struct tsch_slotframe {
   struct tsch_asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+#if TSCH_SCHEDULE_WITH_BITMAP
+  /* One bit per timeslot, set if the timeslot has at least one link.
+   * links_list is then kept sorted by timeslot */
+  uint32_t occupancy[(TSCH_SCHEDULE_MAX_SLOTFRAME_LENGTH + 31) / 32];
+  /* First link of the timeslot that was looked up last */
+  struct tsch_link *lookup_hint;
+#endif /* TSCH_SCHEDULE_WITH_BITMAP */
 };
 
 /** \brief TSCH packet information */
@@ -103,6 +110,16 @@ struct tsch_packet {
   uint8_t ret; /* status -- MAC return code */
   uint8_t header_len; /* length of header and header IEs (needed for link-layer security) */
   uint8_t tsch_sync_ie_offset; /* Offset within the frame used for quick update of EB ASN and join priority */
+#if TSCH_QUEUE_WITH_DELAY_STATS
+  clock_time_t enqueue_time; /* when the packet was added to its queue */
+#endif /* TSCH_QUEUE_WITH_DELAY_STATS */
+};
+
+/** \brief Queueing delay of the packets that left a neighbor queue */
+struct tsch_queue_delay_stats {
+  uint32_t total; /* sum of all delays, in clock ticks */
+  clock_time_t max; /* longest delay, in clock ticks */
+  uint16_t count; /* number of packets */
 };
 
 /** \brief TSCH neighbor information */
@@ -118,6 +135,15 @@ struct tsch_neighbor {
   struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PER_NEIGHBOR];
   /* Circular buffer of pointers to packet. */
   struct ringbufindex tx_ringbuf;
+#if TSCH_QUEUE_WITH_READY_LIST
+  struct tsch_neighbor *next_ready; /* next neighbor in the ready list */
+  uint8_t is_ready; /* is this neighbor in the ready list? */
+  uint8_t drr_quantum; /* shared-slot packets per round-robin turn */
+  uint8_t drr_deficit; /* shared-slot packets left in the current turn */
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
+#if TSCH_QUEUE_WITH_DELAY_STATS
+  struct tsch_queue_delay_stats delay_stats;
+#endif /* TSCH_QUEUE_WITH_DELAY_STATS */
 };
 
 /** \brief TSCH timeslot timing elements. Used to index timeslot timing
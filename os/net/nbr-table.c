@@ -70,6 +70,41 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_LLADDR_INDEX
+/* The hash index is an open-addressing table with linear probing. Its size
+ * is the smallest power of two that is at least twice the number of
+ * neighbors, which keeps the load factor at or below 50%. */
+#if NBR_TABLE_MAX_NEIGHBORS <= 8
+#define LLADDR_INDEX_SIZE 16
+#elif NBR_TABLE_MAX_NEIGHBORS <= 16
+#define LLADDR_INDEX_SIZE 32
+#elif NBR_TABLE_MAX_NEIGHBORS <= 32
+#define LLADDR_INDEX_SIZE 64
+#elif NBR_TABLE_MAX_NEIGHBORS <= 64
+#define LLADDR_INDEX_SIZE 128
+#elif NBR_TABLE_MAX_NEIGHBORS <= 128
+#define LLADDR_INDEX_SIZE 256
+#elif NBR_TABLE_MAX_NEIGHBORS <= 256
+#define LLADDR_INDEX_SIZE 512
+#elif NBR_TABLE_MAX_NEIGHBORS <= 512
+#define LLADDR_INDEX_SIZE 1024
+#elif NBR_TABLE_MAX_NEIGHBORS <= 1024
+#define LLADDR_INDEX_SIZE 2048
+#elif NBR_TABLE_MAX_NEIGHBORS <= 2048
+#define LLADDR_INDEX_SIZE 4096
+#else
+#error "NBR_TABLE_MAX_NEIGHBORS is too big for the link-layer address index"
+#endif
+#define LLADDR_INDEX_MASK (LLADDR_INDEX_SIZE - 1)
+/* Each slot holds a neighbor index plus one, zero marks an empty slot */
+#if NBR_TABLE_MAX_NEIGHBORS < 255
+typedef uint8_t lladdr_index_slot_t;
+#else
+typedef uint16_t lladdr_index_slot_t;
+#endif
+static lladdr_index_slot_t lladdr_index[LLADDR_INDEX_SIZE];
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
+
 /*---------------------------------------------------------------------------*/
 static void remove_key(nbr_table_key_t *key, bool do_free);
 /*---------------------------------------------------------------------------*/
@@ -115,16 +150,108 @@ key_from_item(const nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_WITH_LLADDR_INDEX
+/* Get the home slot of a link-layer address in the hash index */
+static unsigned
+lladdr_index_hash(const linkaddr_t *lladdr)
+{
+  unsigned hash;
+  uint_fast8_t i;
+
+  /* One-at-a-time hash, which mixes well even when link-layer addresses only
+   * differ in their last byte */
+  hash = 0;
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    hash += lladdr->u8[i];
+    hash += hash << 10;
+    hash ^= hash >> 6;
+  }
+  hash += hash << 3;
+  hash ^= hash >> 11;
+  hash += hash << 15;
+  return hash & LLADDR_INDEX_MASK;
+}
+/*---------------------------------------------------------------------------*/
+/* Look up the neighbor index of a link-layer address in the hash index */
+static int
+lladdr_index_lookup(const linkaddr_t *lladdr)
+{
+  unsigned slot;
+
+  for(slot = lladdr_index_hash(lladdr);
+      lladdr_index[slot];
+      slot = (slot + 1) & LLADDR_INDEX_MASK) {
+    int index = lladdr_index[slot] - 1;
+    if(linkaddr_cmp(lladdr, &key_from_index(index)->lladdr)) {
+      return index;
+    }
+  }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+/* Add a neighbor to the hash index. Its link-layer address must be set. */
+static void
+lladdr_index_insert(int index)
+{
+  unsigned slot;
+
+  slot = lladdr_index_hash(&key_from_index(index)->lladdr);
+  while(lladdr_index[slot]) {
+    slot = (slot + 1) & LLADDR_INDEX_MASK;
+  }
+  lladdr_index[slot] = index + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a neighbor from the hash index */
+static void
+lladdr_index_remove(int index)
+{
+  unsigned hole;
+  unsigned slot;
+  unsigned home;
+
+  /* Find the slot of the neighbor */
+  hole = lladdr_index_hash(&key_from_index(index)->lladdr);
+  while(lladdr_index[hole] != index + 1) {
+    if(!lladdr_index[hole]) {
+      return;
+    }
+    hole = (hole + 1) & LLADDR_INDEX_MASK;
+  }
+  lladdr_index[hole] = 0;
+
+  /* Shift back subsequent entries of the probe sequence so that lookups need
+   * no tombstones */
+  for(slot = (hole + 1) & LLADDR_INDEX_MASK;
+      lladdr_index[slot];
+      slot = (slot + 1) & LLADDR_INDEX_MASK) {
+    home = lladdr_index_hash(&key_from_index(lladdr_index[slot] - 1)->lladdr);
+    /* Move the entry unless its home slot lies cyclically in (hole, slot] */
+    if(((slot - home) & LLADDR_INDEX_MASK)
+       >= ((slot - hole) & LLADDR_INDEX_MASK)) {
+      lladdr_index[hole] = lladdr_index[slot];
+      lladdr_index[slot] = 0;
+      hole = slot;
+    }
+  }
+}
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
+#if !NBR_TABLE_WITH_LLADDR_INDEX
   nbr_table_key_t *key;
+#endif /* !NBR_TABLE_WITH_LLADDR_INDEX */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_LLADDR_INDEX
+  return lladdr_index_lookup(lladdr);
+#else /* NBR_TABLE_WITH_LLADDR_INDEX */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -133,6 +260,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     key = list_item_next(key);
   }
   return -1;
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
 }
 /*---------------------------------------------------------------------------*/
 /* Get bit from "used" or "locked" bitmap */
@@ -183,6 +311,9 @@ remove_key(nbr_table_key_t *key, bool do_free)
   locked_map[index_from_key(key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, key);
+#if NBR_TABLE_WITH_LLADDR_INDEX
+  lladdr_index_remove(index_from_key(key));
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
   if(do_free) {
     /* Release the memory */
     memb_free(&neighbor_addr_mem, key);
@@ -430,6 +561,9 @@ nbr_table_add_lladdr(const nbr_table_t *table, const linkaddr_t *lladdr,
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_WITH_LLADDR_INDEX
+    lladdr_index_insert(index);
+#endif /* NBR_TABLE_WITH_LLADDR_INDEX */
   }
 
   /* Get item in the current table */
@@ -55,6 +55,15 @@ typedef enum {
 
 #define NBR_TABLE_MAX_NEIGHBORS NBR_TABLE_CONF_MAX_NEIGHBORS
 
+/* Maintain a hash index over the link-layer addresses of all neighbors so
+ * that nbr_table_get_from_lladdr() and nbr_table_add_lladdr() need not walk
+ * the whole key list. Costs 2 to 4 bytes of RAM per neighbor. */
+#ifdef NBR_TABLE_CONF_WITH_LLADDR_INDEX
+#define NBR_TABLE_WITH_LLADDR_INDEX NBR_TABLE_CONF_WITH_LLADDR_INDEX
+#else /* NBR_TABLE_CONF_WITH_LLADDR_INDEX */
+#define NBR_TABLE_WITH_LLADDR_INDEX 0
+#endif /* NBR_TABLE_CONF_WITH_LLADDR_INDEX */
+
 #ifdef NBR_TABLE_CONF_GC_GET_WORST
 #define NBR_TABLE_GC_GET_WORST NBR_TABLE_CONF_GC_GET_WORST
 #else /* NBR_TABLE_CONF_GC_GET_WORST */
@@ -51,6 +51,7 @@
 
 static struct packetbuf temp;
 struct packetbuf *packetbuf = &temp;
+static uint16_t generation;
 
 #define DEBUG 0
 #if DEBUG
@@ -68,6 +69,7 @@ packetbuf_clear(void)
   packetbuf->bufptr = 0;
   packetbuf->hdrlen = 0;
   packetbuf_attr_clear();
+  generation++;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -107,6 +109,7 @@ packetbuf_hdralloc(int size)
     packetbuf->data[i + size] = packetbuf->data[i];
   }
   packetbuf->hdrlen += size;
+  generation++;
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -119,6 +122,7 @@ packetbuf_hdrreduce(int size)
 
   packetbuf->bufptr += size;
   packetbuf->datalen -= size;
+  generation++;
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -127,6 +131,13 @@ packetbuf_set_datalen(uint16_t len)
 {
   PRINTF("packetbuf_set_len: len %d\n", len);
   packetbuf->datalen = len;
+  generation++;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+packetbuf_generation(void)
+{
+  return generation;
 }
 /*---------------------------------------------------------------------------*/
 void *
@@ -149,6 +149,18 @@ uint16_t packetbuf_remaininglen(void);
  */
 void packetbuf_set_datalen(uint16_t len);
 
+/**
+ * \brief      Get a counter that changes when the packetbuf is modified
+ * \return     The current modification count
+ *
+ *             The counter is incremented whenever the contents of
+ *             the packetbuf are replaced, or its header or data
+ *             lengths change. Writes through packetbuf_dataptr() or
+ *             packetbuf_hdrptr() are not tracked.
+ *
+ */
+uint16_t packetbuf_generation(void);
+
 /**
  * \brief      Copy from external data into the packetbuf
  * \param from A pointer to the data from which to copy
@@ -70,14 +70,15 @@ struct queuebuf {
     int swap_id;
   };
 #endif
+  struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
+  struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
 };
 
-/* The actual queuebuf data */
+/* The actual frame, which may be shared by several queuebufs */
 struct queuebuf_data {
   uint8_t data[PACKETBUF_SIZE];
   uint16_t len;
-  struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
-  struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
+  uint8_t refs;
 };
 
 MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
@@ -126,16 +127,18 @@ LIST(queuebuf_list);
 #define PRINTF(...)
 #endif
 
-#ifdef QUEUEBUF_CONF_STATS
-#define QUEUEBUF_STATS QUEUEBUF_CONF_STATS
-#else
-#define QUEUEBUF_STATS 0
-#endif /* QUEUEBUF_CONF_STATS */
-
 #if QUEUEBUF_STATS
 uint8_t queuebuf_len, queuebuf_max_len;
+uint32_t queuebuf_copied_bytes;
 #endif /* QUEUEBUF_STATS */
 
+#if !WITH_SWAP
+/* The frame that packetbuf held when it was offered for sharing */
+static struct queuebuf_data *offered;
+static const struct packetbuf *offered_packetbuf;
+static uint16_t offered_generation;
+#endif /* !WITH_SWAP */
+
 #if WITH_SWAP
 /*---------------------------------------------------------------------------*/
 static void
@@ -276,6 +279,28 @@ queuebuf_load_to_ram(struct queuebuf *b)
 {
   return b->ram_ptr;
 }
+/*---------------------------------------------------------------------------*/
+/* Checks if packetbuf still holds the offered frame, unmodified */
+static bool
+packetbuf_holds_offered(const struct queuebuf_data *d)
+{
+  return d != NULL
+         && d == offered
+         && packetbuf == offered_packetbuf
+         && packetbuf_generation() == offered_generation
+         && packetbuf_hdrlen() == 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+release_data(struct queuebuf_data *d)
+{
+  if(--d->refs == 0) {
+    if(d == offered) {
+      offered = NULL;
+    }
+    memb_free(&buframmem, d);
+  }
+}
 #endif /* WITH_SWAP */
 /*---------------------------------------------------------------------------*/
 void
@@ -310,6 +335,7 @@ queuebuf_new_from_packetbuf(void)
 #endif /* QUEUEBUF_DEBUG */
 {
   struct queuebuf *buf;
+  bool shared = false;
 
   struct queuebuf_data *buframptr;
   buf = memb_alloc(&bufmem);
@@ -320,8 +346,8 @@ queuebuf_new_from_packetbuf(void)
     buf->line = line;
     buf->time = clock_time();
 #endif /* QUEUEBUF_DEBUG */
-    buf->ram_ptr = memb_alloc(&buframmem);
 #if WITH_SWAP
+    buf->ram_ptr = memb_alloc(&buframmem);
     /* If the allocation failed, store the qbuf in swap files */
     if(buf->ram_ptr != NULL) {
       buf->location = IN_RAM;
@@ -333,6 +359,14 @@ queuebuf_new_from_packetbuf(void)
       buframptr = &tmpdata;
     }
 #else
+    if(packetbuf_holds_offered(offered)) {
+      /* Share the frame instead of copying it */
+      buf->ram_ptr = offered;
+      offered->refs++;
+      shared = true;
+    } else {
+      buf->ram_ptr = memb_alloc(&buframmem);
+    }
     if(buf->ram_ptr == NULL) {
       PRINTF("queuebuf_new_from_packetbuf: could not queuebuf data\n");
       memb_free(&bufmem, buf);
@@ -341,8 +375,14 @@ queuebuf_new_from_packetbuf(void)
     buframptr = buf->ram_ptr;
 #endif
 
-    buframptr->len = packetbuf_copyto(buframptr->data);
-    packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+    if(!shared) {
+      buframptr->refs = 1;
+      buframptr->len = packetbuf_copyto(buframptr->data);
+#if QUEUEBUF_STATS
+      queuebuf_copied_bytes += buframptr->len;
+#endif /* QUEUEBUF_STATS */
+    }
+    packetbuf_attr_copyto(buf->attrs, buf->addrs);
 
 #if WITH_SWAP
     if(buf->location == IN_CFS) {
@@ -371,21 +411,31 @@ queuebuf_new_from_packetbuf(void)
 void
 queuebuf_update_attr_from_packetbuf(struct queuebuf *buf)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
-  packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
-#if WITH_SWAP
-  if(buf->location == IN_CFS) {
-    queuebuf_flush_tmpdata();
-  }
-#endif
+  packetbuf_attr_copyto(buf->attrs, buf->addrs);
 }
 /*---------------------------------------------------------------------------*/
 void
 queuebuf_update_from_packetbuf(struct queuebuf *buf)
 {
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
-  packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+#if !WITH_SWAP
+  if(buframptr->refs > 1) {
+    /* Copy on write */
+    struct queuebuf_data *copy = memb_alloc(&buframmem);
+    if(copy == NULL) {
+      PRINTF("queuebuf_update_from_packetbuf: could not queuebuf data\n");
+      return;
+    }
+    buframptr->refs--;
+    copy->refs = 1;
+    buf->ram_ptr = buframptr = copy;
+  }
+#endif /* !WITH_SWAP */
+  packetbuf_attr_copyto(buf->attrs, buf->addrs);
   buframptr->len = packetbuf_copyto(buframptr->data);
+#if QUEUEBUF_STATS
+  queuebuf_copied_bytes += buframptr->len;
+#endif /* QUEUEBUF_STATS */
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
     queuebuf_flush_tmpdata();
@@ -404,7 +454,7 @@ queuebuf_free(struct queuebuf *buf)
       queuebuf_remove_from_file(buf->swap_id);
     }
 #else
-    memb_free(&buframmem, buf->ram_ptr);
+    release_data(buf->ram_ptr);
 #endif
     memb_free(&bufmem, buf);
 #if QUEUEBUF_STATS
@@ -422,9 +472,31 @@ queuebuf_to_packetbuf(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
-    packetbuf_copyfrom(buframptr->data, buframptr->len);
-    packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
+#if !WITH_SWAP
+    if(!packetbuf_holds_offered(buframptr))
+#endif /* !WITH_SWAP */
+    {
+      packetbuf_copyfrom(buframptr->data, buframptr->len);
+#if QUEUEBUF_STATS
+      queuebuf_copied_bytes += buframptr->len;
+#endif /* QUEUEBUF_STATS */
+    }
+    packetbuf_attr_copyfrom(b->attrs, b->addrs);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+queuebuf_offer(struct queuebuf *b)
+{
+#if !WITH_SWAP
+  if(b == NULL || !memb_inmemb(&bufmem, b)) {
+    offered = NULL;
+    return;
   }
+  offered = b->ram_ptr;
+  offered_packetbuf = packetbuf;
+  offered_generation = packetbuf_generation();
+#endif /* !WITH_SWAP */
 }
 /*---------------------------------------------------------------------------*/
 void *
@@ -447,15 +519,13 @@ queuebuf_datalen(struct queuebuf *b)
 linkaddr_t *
 queuebuf_addr(struct queuebuf *b, uint8_t type)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
-  return &buframptr->addrs[type - PACKETBUF_ADDR_FIRST].addr;
+  return &b->addrs[type - PACKETBUF_ADDR_FIRST].addr;
 }
 /*---------------------------------------------------------------------------*/
 packetbuf_attr_t
 queuebuf_attr(struct queuebuf *b, uint8_t type)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
-  return buframptr->attrs[type].val;
+  return b->attrs[type].val;
 }
 /*---------------------------------------------------------------------------*/
 bool
@@ -94,6 +94,18 @@
 #define QUEUEBUF_DEBUG 0
 #endif /* QUEUEBUF_CONF_DEBUG */
 
+#ifdef QUEUEBUF_CONF_STATS
+#define QUEUEBUF_STATS QUEUEBUF_CONF_STATS
+#else
+#define QUEUEBUF_STATS 0
+#endif /* QUEUEBUF_CONF_STATS */
+
+#if QUEUEBUF_STATS
+extern uint8_t queuebuf_len, queuebuf_max_len;
+/* Number of frame bytes copied into or out of queuebufs */
+extern uint32_t queuebuf_copied_bytes;
+#endif /* QUEUEBUF_STATS */
+
 struct queuebuf;
 
 void queuebuf_init(void);
@@ -110,6 +122,16 @@ void queuebuf_update_from_packetbuf(struct queuebuf *b);
 void queuebuf_to_packetbuf(struct queuebuf *b);
 void queuebuf_free(struct queuebuf *b);
 
+/*
+ * Declares that packetbuf holds the frame of b. Until packetbuf is
+ * modified, queuebuf_new_from_packetbuf() makes new queuebufs share
+ * that frame instead of copying it, and queuebuf_to_packetbuf(b) only
+ * restores the attributes. Frames are reference counted and freed
+ * together with the last queuebuf that refers to them. Passing NULL
+ * withdraws the offer. Has no effect when swapping is enabled.
+ */
+void queuebuf_offer(struct queuebuf *b);
+
 void *queuebuf_dataptr(struct queuebuf *b);
 int queuebuf_datalen(struct queuebuf *b);
 
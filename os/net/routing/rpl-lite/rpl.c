@@ -43,6 +43,7 @@
 
 #include "net/routing/rpl-lite/rpl.h"
 #include "net/routing/routing.h"
+#include "net/ipv6/uip-sr.h"
 
 /* Log configuration */
 #include "sys/log.h"
@@ -151,6 +152,7 @@ rpl_reset_prefix(rpl_prefix_t *last_prefix)
     uip_ds6_addr_rm(rep);
   }
   curr_instance.dag.prefix_info.length = 0;
+  uip_sr_invalidate_paths();
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -169,6 +171,7 @@ rpl_set_prefix_from_addr(uip_ipaddr_t *addr, unsigned len, uint8_t flags)
   curr_instance.dag.prefix_info.length = len;
   curr_instance.dag.prefix_info.lifetime = RPL_ROUTE_INFINITE_LIFETIME;
   curr_instance.dag.prefix_info.flags = flags;
+  uip_sr_invalidate_paths();
 
   /* Add global address if not already there */
   set_ip_from_prefix(&ipaddr, &curr_instance.dag.prefix_info);
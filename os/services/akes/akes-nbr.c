@@ -213,6 +213,9 @@ delete_nbr_with_lock(akes_nbr_entry_t *entry, akes_nbr_status_t status)
 {
   assert(entry);
   if(status) {
+#if AKES_NBR_WITH_CRYPTO_QUEUE
+    crypto_queue_cancel(&entry->refs[status]->meta->key_derivation);
+#endif /* AKES_NBR_WITH_CRYPTO_QUEUE */
     akes_nbr_free_tentative_metadata(entry->refs[status]->meta);
   }
   if(memb_free(&nbrs_memb, entry->refs[status]) == -1) {
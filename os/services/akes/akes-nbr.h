@@ -43,6 +43,7 @@
 
 #include "contiki.h"
 #include "lib/aes-128.h"
+#include "lib/crypto-queue.h"
 #include "net/linkaddr.h"
 #include "net/mac/anti-replay.h"
 #include "net/mac/llsec802154.h"
@@ -82,6 +83,13 @@
 #define AKES_NBR_WITH_GROUP_KEYS (1)
 #endif /* AKES_NBR_CONF_WITH_GROUP_KEYS */
 
+/* Derives pairwise keys for HELLOACKs via the crypto queue */
+#ifdef AKES_NBR_CONF_WITH_CRYPTO_QUEUE
+#define AKES_NBR_WITH_CRYPTO_QUEUE AKES_NBR_CONF_WITH_CRYPTO_QUEUE
+#else /* AKES_NBR_CONF_WITH_CRYPTO_QUEUE */
+#define AKES_NBR_WITH_CRYPTO_QUEUE (0)
+#endif /* AKES_NBR_CONF_WITH_CRYPTO_QUEUE */
+
 #ifdef AKES_NBR_CONF_WITH_INDICES
 #define AKES_NBR_WITH_INDICES AKES_NBR_CONF_WITH_INDICES
 #else /* AKES_NBR_CONF_WITH_INDICES */
@@ -125,6 +133,11 @@ typedef struct akes_nbr_tentative_t {
   bool was_helloack_sent;
   bool was_cloned;
   uint8_t helloack_transmissions;
+#if AKES_NBR_WITH_CRYPTO_QUEUE
+  crypto_queue_job_t key_derivation;
+  uint8_t secret[AES_128_KEY_LENGTH];
+  uint8_t helloack_challenge[AKES_NBR_CHALLENGE_LEN];
+#endif /* AKES_NBR_WITH_CRYPTO_QUEUE */
 } akes_nbr_tentative_t;
 
 typedef struct akes_nbr_t {
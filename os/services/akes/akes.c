@@ -136,6 +136,10 @@ static void do_broadcast_hello(void *ptr);
 static void on_hello_sent(void *ptr, int status, int transmissions);
 static void on_hello_done(void *ptr);
 static void send_helloack(void *ptr);
+#if AKES_NBR_WITH_CRYPTO_QUEUE
+static void on_pairwise_key_generated(void *ptr, bool successful);
+#endif /* AKES_NBR_WITH_CRYPTO_QUEUE */
+static void send_prepared_helloack(akes_nbr_entry_t *entry);
 static void on_helloack_sent(void *ptr, int status, int transmissions);
 static void on_ack_timeout(void *ptr);
 static void send_ack(akes_nbr_entry_t *entry, bool is_new);
@@ -162,7 +166,8 @@ akes_get_hello_challenge(void)
 static void
 prepare_helloack_or_ack(uint8_t cmd_id,
                         akes_nbr_entry_t *entry,
-                        akes_nbr_status_t status)
+                        akes_nbr_status_t status,
+                        const uint8_t *challenge)
 {
   uint8_t *payload =
       cmd_broker_prepare_command(cmd_id, akes_nbr_get_addr(entry));
@@ -171,8 +176,8 @@ prepare_helloack_or_ack(uint8_t cmd_id,
                      1 + MAX_RETRANSMISSIONS_OF_HELLOACKS_AND_ACKS);
 
   /* write payload */
-  if(status) {
-    akes_nbr_copy_challenge(payload, entry->tentative->challenge);
+  if(challenge) {
+    akes_nbr_copy_challenge(payload, challenge);
     payload += AKES_NBR_CHALLENGE_LEN;
   }
 #if AKES_NBR_WITH_INDICES
@@ -415,6 +420,26 @@ send_helloack(void *ptr)
     akes_nbr_delete(entry, AKES_NBR_TENTATIVE);
     return;
   }
+
+#if AKES_NBR_WITH_CRYPTO_QUEUE
+  /* generate pairwise key in the background */
+  akes_nbr_tentative_t *meta = entry->tentative->meta;
+  const uint8_t *secret =
+      AKES_SCHEME.get_secret_with_hello_sender(akes_nbr_get_addr(entry));
+  if(!secret) {
+    LOG_ERR("no secret with HELLO sender\n");
+    akes_nbr_delete(entry, AKES_NBR_TENTATIVE);
+    return;
+  }
+  akes_nbr_copy_key(meta->secret, secret);
+  akes_nbr_copy_challenge(meta->helloack_challenge,
+                          challenges + AKES_NBR_CHALLENGE_LEN);
+  akes_nbr_copy_key(entry->tentative->tentative_pairwise_key, challenges);
+  crypto_queue_encrypt(&meta->key_derivation,
+                       meta->secret,
+                       entry->tentative->tentative_pairwise_key, 1,
+                       on_pairwise_key_generated, entry);
+#else /* AKES_NBR_WITH_CRYPTO_QUEUE */
   akes_nbr_copy_challenge(entry->tentative->challenge,
                           challenges + AKES_NBR_CHALLENGE_LEN);
 
@@ -422,7 +447,8 @@ send_helloack(void *ptr)
   prepare_helloack_or_ack(
       entry->permanent ? AKES_HELLOACK_P_IDENTIFIER : AKES_HELLOACK_IDENTIFIER,
       entry,
-      AKES_NBR_TENTATIVE);
+      AKES_NBR_TENTATIVE,
+      entry->tentative->challenge);
 
   /* generate pairwise key */
   const uint8_t *secret =
@@ -433,6 +459,38 @@ send_helloack(void *ptr)
     return;
   }
   akes_nbr_copy_key(entry->tentative->tentative_pairwise_key, challenges);
+  send_prepared_helloack(entry);
+#endif /* AKES_NBR_WITH_CRYPTO_QUEUE */
+}
+/*---------------------------------------------------------------------------*/
+#if AKES_NBR_WITH_CRYPTO_QUEUE
+static void
+on_pairwise_key_generated(void *ptr, bool successful)
+{
+  akes_nbr_entry_t *entry = (akes_nbr_entry_t *)ptr;
+  assert(entry
+         && entry->tentative
+         && (entry == akes_nbr_get_entry_of(entry->tentative)));
+
+  if(!successful) {
+    LOG_ERR("AES error\n");
+    akes_nbr_delete(entry, AKES_NBR_TENTATIVE);
+    return;
+  }
+
+  /* write payload */
+  prepare_helloack_or_ack(
+      entry->permanent ? AKES_HELLOACK_P_IDENTIFIER : AKES_HELLOACK_IDENTIFIER,
+      entry,
+      AKES_NBR_TENTATIVE,
+      entry->tentative->meta->helloack_challenge);
+  send_prepared_helloack(entry);
+}
+#endif /* AKES_NBR_WITH_CRYPTO_QUEUE */
+/*---------------------------------------------------------------------------*/
+static void
+send_prepared_helloack(akes_nbr_entry_t *entry)
+{
 #if !WITH_ON_HELLOACK_SENT_CALLBACK
   ctimer_set(&entry->tentative->meta->wait_timer,
              2 * HELLOACK_AND_ACK_DELAY,
@@ -630,7 +688,10 @@ send_ack(akes_nbr_entry_t *entry, bool is_new)
   LOG_INFO_("\n");
   entry->permanent->is_receiving_ack = true;
   leaky_bucket_pour(&ack_bucket);
-  prepare_helloack_or_ack(AKES_ACK_IDENTIFIER, entry, AKES_NBR_PERMANENT);
+  prepare_helloack_or_ack(AKES_ACK_IDENTIFIER,
+                          entry,
+                          AKES_NBR_PERMANENT,
+                          NULL);
   AKES_MAC_STRATEGY.send(on_ack_sent, (void *)is_new);
 }
 /*---------------------------------------------------------------------------*/
@@ -80,6 +80,17 @@
 #define USE_RD_CLIENT 1
 #endif /* LWM2M_ENGINE_CONF_USE_RD_CLIENT */
 
+/* Size of the cached registration payload of the object instances that
+   are registered with lwm2m_engine_add_object() - 0 disables the cache */
+#ifdef LWM2M_ENGINE_CONF_RD_CACHE_SIZE
+#define RD_CACHE_SIZE LWM2M_ENGINE_CONF_RD_CACHE_SIZE
+#else /* LWM2M_ENGINE_CONF_RD_CACHE_SIZE */
+#define RD_CACHE_SIZE 0
+#endif /* LWM2M_ENGINE_CONF_RD_CACHE_SIZE */
+
+#if LWM2M_ENGINE_INDEX_BUCKETS & (LWM2M_ENGINE_INDEX_BUCKETS - 1)
+#error "LWM2M_ENGINE_CONF_INDEX_BUCKETS must be a power of two"
+#endif
 
 #if LWM2M_QUEUE_MODE_ENABLED
  /* Queue Mode is handled using the RD Client and the Q-Mode object */
@@ -147,14 +158,116 @@ COAP_HANDLER(lwm2m_handler, lwm2m_handler_callback);
 LIST(object_list);
 LIST(generic_object_list);
 
+#if LWM2M_ENGINE_INDEX_BUCKETS
+static lwm2m_object_instance_t *instance_index[LWM2M_ENGINE_INDEX_BUCKETS];
+static lwm2m_object_t *object_index[LWM2M_ENGINE_INDEX_BUCKETS];
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
+
+#if RD_CACHE_SIZE
+/* The link-format of all instances in object_list, in list order */
+static char rd_cache[RD_CACHE_SIZE];
+static uint16_t rd_cache_len;
+static bool rd_cache_is_valid;
+#endif /* RD_CACHE_SIZE */
+
+/*---------------------------------------------------------------------------*/
+#if LWM2M_ENGINE_INDEX_BUCKETS
+static lwm2m_object_instance_t **
+get_instance_bucket(uint16_t object_id, uint16_t instance_id)
+{
+  /* consecutive instances of an object go to consecutive buckets */
+  return &instance_index[(object_id * 31u + instance_id)
+                         & (LWM2M_ENGINE_INDEX_BUCKETS - 1)];
+}
+/*---------------------------------------------------------------------------*/
+static lwm2m_object_t **
+get_object_bucket(uint16_t object_id)
+{
+  return &object_index[object_id & (LWM2M_ENGINE_INDEX_BUCKETS - 1)];
+}
+/*---------------------------------------------------------------------------*/
+static lwm2m_object_instance_t *
+get_indexed_instance(uint16_t object_id, uint16_t instance_id)
+{
+  lwm2m_object_instance_t *instance;
+  for(instance = *get_instance_bucket(object_id, instance_id);
+      instance != NULL;
+      instance = instance->bucket_next) {
+    if(instance->object_id == object_id
+       && instance->instance_id == instance_id) {
+      return instance;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_instance(lwm2m_object_instance_t *instance)
+{
+  lwm2m_object_instance_t **bucket;
+
+  bucket = get_instance_bucket(instance->object_id, instance->instance_id);
+  instance->bucket_next = *bucket;
+  *bucket = instance;
+}
+/*---------------------------------------------------------------------------*/
+static void
+unindex_instance(lwm2m_object_instance_t *instance)
+{
+  lwm2m_object_instance_t **prev;
+
+  for(prev = get_instance_bucket(instance->object_id, instance->instance_id);
+      *prev != NULL;
+      prev = &(*prev)->bucket_next) {
+    if(*prev == instance) {
+      *prev = instance->bucket_next;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_object(lwm2m_object_t *object)
+{
+  lwm2m_object_t **bucket;
+
+  bucket = get_object_bucket(object->impl->object_id);
+  object->bucket_next = *bucket;
+  *bucket = object;
+}
+/*---------------------------------------------------------------------------*/
+static void
+unindex_object(lwm2m_object_t *object)
+{
+  lwm2m_object_t **prev;
+
+  if(object->impl == NULL) {
+    return;
+  }
+  for(prev = get_object_bucket(object->impl->object_id);
+      *prev != NULL;
+      prev = &(*prev)->bucket_next) {
+    if(*prev == object) {
+      *prev = object->bucket_next;
+      return;
+    }
+  }
+}
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
 /*---------------------------------------------------------------------------*/
 static lwm2m_object_t *
 get_object(uint16_t object_id)
 {
   lwm2m_object_t *object;
+#if LWM2M_ENGINE_INDEX_BUCKETS
+  for(object = *get_object_bucket(object_id);
+      object != NULL;
+      object = object->bucket_next) {
+#else /* LWM2M_ENGINE_INDEX_BUCKETS */
   for(object = list_head(generic_object_list);
       object != NULL;
       object = object->next) {
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
     if(object->impl && object->impl->object_id == object_id) {
       return object;
     }
@@ -187,13 +300,24 @@ get_instance(uint16_t object_id, uint16_t instance_id, lwm2m_object_t **o)
     *o = NULL;
   }
 
-  for(instance = list_head(object_list);
-      instance != NULL;
-      instance = instance->next) {
-    if(instance->object_id == object_id) {
-      if(instance->instance_id == instance_id ||
-         instance_id == LWM2M_OBJECT_INSTANCE_NONE) {
-        return instance;
+#if LWM2M_ENGINE_INDEX_BUCKETS
+  if(instance_id != LWM2M_OBJECT_INSTANCE_NONE) {
+    instance = get_indexed_instance(object_id, instance_id);
+    if(instance != NULL) {
+      return instance;
+    }
+  } else
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
+  {
+    /* the first instance of an object is the first one in the list */
+    for(instance = list_head(object_list);
+        instance != NULL;
+        instance = instance->next) {
+      if(instance->object_id == object_id) {
+        if(instance->instance_id == instance_id ||
+           instance_id == LWM2M_OBJECT_INSTANCE_NONE) {
+          return instance;
+        }
       }
     }
   }
@@ -391,12 +515,56 @@ void lwm2m_engine_set_opaque_callback(lwm2m_context_t *ctx, lwm2m_write_opaque_c
   current_opaque_callback = cb;
 }
 /*---------------------------------------------------------------------------*/
+#if RD_CACHE_SIZE
+static void
+rd_cache_append(const lwm2m_object_instance_t *instance)
+{
+  int len;
+
+  if(!rd_cache_is_valid) {
+    return;
+  }
+  len = snprintf(&rd_cache[rd_cache_len], sizeof(rd_cache) - rd_cache_len,
+                 rd_cache_len > 0 ? ",</%d/%d>" : "</%d/%d>",
+                 instance->object_id, instance->instance_id);
+  if(len < 0 || (size_t)len >= sizeof(rd_cache) - rd_cache_len) {
+    /* too many instances - the payload will be generated on the fly */
+    rd_cache_is_valid = false;
+    return;
+  }
+  rd_cache_len += len;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+update_rd_cache(void)
+{
+  lwm2m_object_instance_t *instance;
+
+  if(rd_cache_is_valid) {
+    return true;
+  }
+  rd_cache_len = 0;
+  rd_cache_is_valid = true;
+  for(instance = list_head(object_list);
+      instance != NULL && rd_cache_is_valid;
+      instance = instance->next) {
+    rd_cache_append(instance);
+  }
+  return rd_cache_is_valid;
+}
+#endif /* RD_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
 int
 lwm2m_engine_set_rd_data(lwm2m_buffer_t *outbuf, int block)
 {
   /* remember things here - need to lock lwm2m buffer also!!! */
   static lwm2m_object_t *object;
   static lwm2m_object_instance_t *instance;
+#if RD_CACHE_SIZE
+  /* the part of the cache that is yet to be sent */
+  static uint16_t rd_cache_pos;
+  static uint16_t rd_cache_end;
+#endif /* RD_CACHE_SIZE */
   int len;
   /* pick size from outbuf */
   int maxsize = outbuf->size;
@@ -412,19 +580,38 @@ lwm2m_engine_set_rd_data(lwm2m_buffer_t *outbuf, int block)
 
   if(block == 0) {
     LOG_DBG("Starting RD generation\n");
-    /* start with simple object instances */
-    instance = list_head(object_list);
-    object = NULL;
-
-    if(instance == NULL) {
-      /* No simple object instances available */
+#if RD_CACHE_SIZE
+    rd_cache_pos = 0;
+    rd_cache_end = 0;
+    if(update_rd_cache()) {
+      /* simple object instances are copied from the cache */
+      rd_cache_end = rd_cache_len;
+      instance = NULL;
       object = list_head(generic_object_list);
-      if(object == NULL) {
+      if(object != NULL && object->impl != NULL) {
+        instance = object->impl->get_first(NULL);
+      }
+      if(rd_cache_end == 0 && object == NULL) {
         /* No objects of any kind available */
         return 0;
       }
-      if(object->impl != NULL) {
-        instance = object->impl->get_first(NULL);
+    } else
+#endif /* RD_CACHE_SIZE */
+    {
+      /* start with simple object instances */
+      instance = list_head(object_list);
+      object = NULL;
+
+      if(instance == NULL) {
+        /* No simple object instances available */
+        object = list_head(generic_object_list);
+        if(object == NULL) {
+          /* No objects of any kind available */
+          return 0;
+        }
+        if(object->impl != NULL) {
+          instance = object->impl->get_first(NULL);
+        }
       }
     }
 
@@ -438,6 +625,24 @@ lwm2m_engine_set_rd_data(lwm2m_buffer_t *outbuf, int block)
 
   lwm2m_buf_lock_timeout = coap_timer_uptime() + 1000;
 
+#if RD_CACHE_SIZE
+  if(rd_cache_pos < rd_cache_end) {
+    len = MIN(rd_cache_end - rd_cache_pos, maxsize - lwm2m_buf.len);
+    if(len > 0) {
+      memcpy(&lwm2m_buf.buffer[lwm2m_buf.len], &rd_cache[rd_cache_pos], len);
+      lwm2m_buf.len += len;
+      rd_cache_pos += len;
+    }
+    if(lwm2m_buf.len >= maxsize
+       && (rd_cache_pos < rd_cache_end || object != NULL)) {
+      LOG_DBG("**** CoAP MAX BLOCK Reached!!! **** SEND\n");
+      double_buffer_flush(&lwm2m_buf, outbuf, maxsize);
+      /* there will be more - keep lock! */
+      return 1;
+    }
+  }
+#endif /* RD_CACHE_SIZE */
+
   LOG_DBG("Generating RD list:");
   while(instance != NULL || object != NULL) {
     int pos = lwm2m_buf.len;
@@ -508,6 +713,13 @@ lwm2m_engine_init(void)
 {
   list_init(object_list);
   list_init(generic_object_list);
+#if LWM2M_ENGINE_INDEX_BUCKETS
+  memset(instance_index, 0, sizeof(instance_index));
+  memset(object_index, 0, sizeof(object_index));
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
+#if RD_CACHE_SIZE
+  rd_cache_is_valid = false;
+#endif /* RD_CACHE_SIZE */
 
 #ifdef LWM2M_ENGINE_CLIENT_ENDPOINT_NAME
   const char *endpoint = LWM2M_ENGINE_CLIENT_ENDPOINT_NAME;
@@ -1244,22 +1456,34 @@ lwm2m_engine_add_object(lwm2m_object_instance_t *object)
     return 0;
   }
 
-  for(instance = list_head(object_list);
-      instance != NULL;
-      instance = instance->next) {
-    if(object->object_id == instance->object_id) {
-      if(object->instance_id == instance->instance_id) {
-        LOG_DBG("object with id %u/%u already registered\n",
-               instance->object_id, instance->instance_id);
-        return 0;
-      }
+#if LWM2M_ENGINE_INDEX_BUCKETS
+  if(object->instance_id != LWM2M_OBJECT_INSTANCE_NONE) {
+    /* no need to look at the other instances */
+    if(get_indexed_instance(object->object_id, object->instance_id) != NULL) {
+      LOG_DBG("object with id %u/%u already registered\n",
+              object->object_id, object->instance_id);
+      return 0;
+    }
+  } else
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
+  {
+    for(instance = list_head(object_list);
+        instance != NULL;
+        instance = instance->next) {
+      if(object->object_id == instance->object_id) {
+        if(object->instance_id == instance->instance_id) {
+          LOG_DBG("object with id %u/%u already registered\n",
+                 instance->object_id, instance->instance_id);
+          return 0;
+        }
 
-      found++;
-      if(instance->instance_id > max_id) {
-        max_id = instance->instance_id;
-      }
-      if(instance->instance_id < min_id) {
-        min_id = instance->instance_id;
+        found++;
+        if(instance->instance_id > max_id) {
+          max_id = instance->instance_id;
+        }
+        if(instance->instance_id < min_id) {
+          min_id = instance->instance_id;
+        }
       }
     }
   }
@@ -1276,6 +1500,13 @@ lwm2m_engine_add_object(lwm2m_object_instance_t *object)
     }
   }
   list_add(object_list, object);
+#if LWM2M_ENGINE_INDEX_BUCKETS
+  index_instance(object);
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
+#if RD_CACHE_SIZE
+  /* list_add() appends, so the instance is also the last one in the cache */
+  rd_cache_append(object);
+#endif /* RD_CACHE_SIZE */
 #if USE_RD_CLIENT
   lwm2m_rd_client_set_update_rd();
 #endif
@@ -1286,6 +1517,12 @@ void
 lwm2m_engine_remove_object(lwm2m_object_instance_t *object)
 {
   list_remove(object_list, object);
+#if LWM2M_ENGINE_INDEX_BUCKETS
+  unindex_instance(object);
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
+#if RD_CACHE_SIZE
+  rd_cache_is_valid = false;
+#endif /* RD_CACHE_SIZE */
 #if USE_RD_CLIENT
   lwm2m_rd_client_set_update_rd();
 #endif
@@ -1314,6 +1551,9 @@ lwm2m_engine_add_generic_object(lwm2m_object_t *object)
     return 0;
   }
   list_add(generic_object_list, object);
+#if LWM2M_ENGINE_INDEX_BUCKETS
+  index_object(object);
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
 
 #if USE_RD_CLIENT
   lwm2m_rd_client_set_update_rd();
@@ -1326,6 +1566,9 @@ void
 lwm2m_engine_remove_generic_object(lwm2m_object_t *object)
 {
   list_remove(generic_object_list, object);
+#if LWM2M_ENGINE_INDEX_BUCKETS
+  unindex_object(object);
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
 #if USE_RD_CLIENT
   lwm2m_rd_client_set_update_rd();
 #endif
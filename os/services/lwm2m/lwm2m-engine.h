@@ -74,6 +74,14 @@ typedef int
 
 #define LWM2M_OBJECT_INSTANCE_NONE 0xffff
 
+/* Number of buckets of the index of registered objects and instances (a
+   power of two) - 0 disables the index and lookups walk the object lists */
+#ifdef LWM2M_ENGINE_CONF_INDEX_BUCKETS
+#define LWM2M_ENGINE_INDEX_BUCKETS LWM2M_ENGINE_CONF_INDEX_BUCKETS
+#else /* LWM2M_ENGINE_CONF_INDEX_BUCKETS */
+#define LWM2M_ENGINE_INDEX_BUCKETS 0
+#endif /* LWM2M_ENGINE_CONF_INDEX_BUCKETS */
+
 struct lwm2m_object_instance {
   lwm2m_object_instance_t *next;
   uint16_t object_id;
@@ -84,6 +92,10 @@ struct lwm2m_object_instance {
   /* the callback for requests */
   lwm2m_object_instance_callback_t callback;
   lwm2m_resource_dim_callback_t resource_dim_callback;
+#if LWM2M_ENGINE_INDEX_BUCKETS
+  /* next registered instance in the same index bucket */
+  lwm2m_object_instance_t *bucket_next;
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
 };
 
 typedef struct {
@@ -102,6 +114,10 @@ typedef struct lwm2m_object lwm2m_object_t;
 struct lwm2m_object {
   lwm2m_object_t *next;
   const lwm2m_object_impl_t *impl;
+#if LWM2M_ENGINE_INDEX_BUCKETS
+  /* next registered generic object in the same index bucket */
+  lwm2m_object_t *bucket_next;
+#endif /* LWM2M_ENGINE_INDEX_BUCKETS */
 };
 
 lwm2m_object_instance_t *lwm2m_engine_get_instance_buffer(void);
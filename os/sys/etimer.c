@@ -50,6 +50,11 @@
 #include "sys/process.h"
 
 static struct etimer *next_etimer;
+#if ETIMER_WITH_HEAP
+static struct etimer *heap[ETIMER_HEAP_SIZE];
+static uint16_t heap_size;
+static uint32_t next_seq;
+#endif /* ETIMER_WITH_HEAP */
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
 static void
@@ -63,6 +68,122 @@ remove_etimer_from_list(struct etimer *previous, struct etimer *et)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if ETIMER_WITH_HEAP
+static bool
+expires_before(struct etimer *a, struct etimer *b)
+{
+  clock_time_t a_expiration_time = etimer_expiration_time(a);
+  clock_time_t b_expiration_time = etimer_expiration_time(b);
+
+  if(a_expiration_time != b_expiration_time) {
+    return CLOCK_LT(a_expiration_time, b_expiration_time);
+  }
+  /* Like in the list, the timer that was set first comes first */
+  return (int32_t)(a->seq - b->seq) < 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_place(struct etimer *et, uint16_t index)
+{
+  heap[index] = et;
+  et->heap_index = index;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_sift_up(uint16_t index)
+{
+  struct etimer *et = heap[index];
+  uint16_t parent;
+
+  while(index > 0) {
+    parent = (index - 1) / 2;
+    if(!expires_before(et, heap[parent])) {
+      break;
+    }
+    heap_place(heap[parent], index);
+    index = parent;
+  }
+  heap_place(et, index);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_sift_down(uint16_t index)
+{
+  struct etimer *et = heap[index];
+  uint16_t child;
+
+  while((child = 2 * index + 1) < heap_size) {
+    if(child + 1 < heap_size && expires_before(heap[child + 1], heap[child])) {
+      child++;
+    }
+    if(!expires_before(heap[child], et)) {
+      break;
+    }
+    heap_place(heap[child], index);
+    index = child;
+  }
+  heap_place(et, index);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+heap_contains(struct etimer *et)
+{
+  /* Also safe if et is uninitialized */
+  return et->heap_index < heap_size && heap[et->heap_index] == et;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(struct etimer *et)
+{
+  uint16_t index = et->heap_index;
+
+  et->p = PROCESS_NONE;
+  heap_size--;
+  if(index == heap_size) {
+    return;
+  }
+  heap_place(heap[heap_size], index);
+  if(index > 0 && expires_before(heap[index], heap[(index - 1) / 2])) {
+    heap_sift_up(index);
+  } else {
+    heap_sift_down(index);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove_process(struct process *p)
+{
+  uint16_t i;
+  uint16_t j;
+
+  /* Drop the timers of p, then restore the heap property bottom-up */
+  for(i = j = 0; i < heap_size; i++) {
+    if(heap[i]->p == p) {
+      heap[i]->p = PROCESS_NONE;
+    } else {
+      heap_place(heap[i], j++);
+    }
+  }
+  heap_size = j;
+  for(i = heap_size / 2; i-- > 0;) {
+    heap_sift_down(i);
+  }
+}
+#endif /* ETIMER_WITH_HEAP */
+/*---------------------------------------------------------------------------*/
+/* Get the timer that expires first */
+static struct etimer *
+first_etimer(void)
+{
+#if ETIMER_WITH_HEAP
+  if(heap_size > 0
+     && (!next_etimer || expires_before(heap[0], next_etimer))) {
+    return heap[0];
+  }
+#endif /* ETIMER_WITH_HEAP */
+  return next_etimer;
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -74,6 +195,9 @@ PROCESS_THREAD(etimer_process, ev, data)
     struct etimer *previous = NULL;
 
     if(ev == PROCESS_EVENT_EXITED) {
+#if ETIMER_WITH_HEAP
+      heap_remove_process((struct process *)data);
+#endif /* ETIMER_WITH_HEAP */
       while(current) {
         if(current->p == ((struct process *)data)) {
           remove_etimer_from_list(previous, current);
@@ -84,6 +208,22 @@ PROCESS_THREAD(etimer_process, ev, data)
         current = current->next;
       }
     } else if(ev == PROCESS_EVENT_POLL) {
+#if ETIMER_WITH_HEAP
+      /* Merge the timers of the heap and of the list in expiration order */
+      while((current = first_etimer()) && timer_expired(&current->timer)) {
+        if(process_post(current->p, PROCESS_EVENT_TIMER, current)
+           != PROCESS_ERR_OK) {
+          /* retry later */
+          etimer_request_poll();
+          break;
+        }
+        if(heap_contains(current)) {
+          heap_remove(current);
+        } else {
+          remove_etimer_from_list(NULL, current);
+        }
+      }
+#else /* ETIMER_WITH_HEAP */
       while(current && timer_expired(&current->timer)) {
         if(process_post(current->p, PROCESS_EVENT_TIMER, current)
            == PROCESS_ERR_OK) {
@@ -97,6 +237,7 @@ PROCESS_THREAD(etimer_process, ev, data)
         previous = current;
         current = current->next;
       }
+#endif /* ETIMER_WITH_HEAP */
     }
   }
 
@@ -115,12 +256,26 @@ add_timer(struct etimer *et)
   /* remove et from the list */
   etimer_stop(et);
 
-  /* locate insertion point */
+#if ETIMER_WITH_HEAP
+  et->seq = next_seq++;
+  if(heap_size < ETIMER_HEAP_SIZE) {
+    et->p = PROCESS_CURRENT();
+    assert(et->p != PROCESS_NONE);
+    heap_place(et, heap_size++);
+    heap_sift_up(et->heap_index);
+    if(first_etimer() == et) {
+      etimer_request_poll();
+    }
+    return;
+  }
+#endif /* ETIMER_WITH_HEAP */
+
+  /* locate insertion point, after timers that expire at the same time */
   clock_time_t expiration_time = etimer_expiration_time(et);
   struct etimer *current = next_etimer;
   struct etimer *previous = NULL;
   while(current
-        && CLOCK_LT(etimer_expiration_time(current), expiration_time)) {
+        && !CLOCK_LT(expiration_time, etimer_expiration_time(current))) {
     previous = current;
     current = current->next;
   }
@@ -189,13 +344,14 @@ etimer_start_time(struct etimer *et)
 int
 etimer_pending(void)
 {
-  return next_etimer != NULL;
+  return first_etimer() != NULL;
 }
 /*---------------------------------------------------------------------------*/
 clock_time_t
 etimer_next_expiration_time(void)
 {
-  return next_etimer ? etimer_expiration_time(next_etimer) : 0;
+  struct etimer *first = first_etimer();
+  return first ? etimer_expiration_time(first) : 0;
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -205,6 +361,13 @@ etimer_stop(struct etimer *et)
     return;
   }
 
+#if ETIMER_WITH_HEAP
+  if(heap_contains(et)) {
+    heap_remove(et);
+    return;
+  }
+#endif /* ETIMER_WITH_HEAP */
+
   struct etimer *current = next_etimer;
   struct etimer *previous = NULL;
   while(current) {
@@ -221,6 +384,14 @@ etimer_stop(struct etimer *et)
 bool
 etimer_check_ordering(void)
 {
+#if ETIMER_WITH_HEAP
+  for(uint16_t i = 1; i < heap_size; i++) {
+    if(heap[i]->heap_index != i
+       || expires_before(heap[i], heap[(i - 1) / 2])) {
+      return false;
+    }
+  }
+#endif /* ETIMER_WITH_HEAP */
   struct etimer *current = next_etimer;
   while(current && current->next) {
     if(CLOCK_LT(etimer_expiration_time(current->next),
@@ -68,6 +68,25 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+/**
+ * If enabled, pending event timers are kept in a binary min-heap, which
+ * makes setting and stopping a timer O(log n) instead of O(n). Timers
+ * that do not fit into the heap fall back to the sorted list.
+ */
+#ifdef ETIMER_CONF_WITH_HEAP
+#define ETIMER_WITH_HEAP ETIMER_CONF_WITH_HEAP
+#else /* ETIMER_CONF_WITH_HEAP */
+#define ETIMER_WITH_HEAP 0
+#endif /* ETIMER_CONF_WITH_HEAP */
+
+/** Maximum number of event timers in the heap */
+#ifdef ETIMER_CONF_HEAP_SIZE
+#define ETIMER_HEAP_SIZE ETIMER_CONF_HEAP_SIZE
+#else /* ETIMER_CONF_HEAP_SIZE */
+#define ETIMER_HEAP_SIZE 32
+#endif /* ETIMER_CONF_HEAP_SIZE */
 
 /**
  * A timer.
@@ -81,6 +100,11 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_WITH_HEAP
+  uint16_t heap_index;
+  /* Orders timers that expire at the same time */
+  uint32_t seq;
+#endif /* ETIMER_WITH_HEAP */
 };
 
 /**
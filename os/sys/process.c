@@ -65,6 +65,24 @@ static_assert(PROCESS_CONF_NUMEVENTS > 0 && PROCESS_CONF_NUMEVENTS <= 128,
 static_assert(!(PROCESS_CONF_NUMEVENTS & (PROCESS_CONF_NUMEVENTS - 1)),
   "PROCESS_CONF_NUMEVENTS must be a power of 2.");
 
+#if PROCESS_WITH_PRIORITIES
+static_assert(PROCESS_NUMEVENTS_NETWORK > 0
+  && !(PROCESS_NUMEVENTS_NETWORK & (PROCESS_NUMEVENTS_NETWORK - 1)),
+  "PROCESS_CONF_NUMEVENTS_NETWORK must be a power of 2.");
+static_assert(PROCESS_NUMEVENTS_TIMER > 0
+  && !(PROCESS_NUMEVENTS_TIMER & (PROCESS_NUMEVENTS_TIMER - 1)),
+  "PROCESS_CONF_NUMEVENTS_TIMER must be a power of 2.");
+static_assert(PROCESS_CONF_NUMEVENTS + PROCESS_NUMEVENTS_TIMER
+  + PROCESS_NUMEVENTS_NETWORK < 255,
+  "The event queues must hold fewer than 255 events in total.");
+#define QUEUES PROCESS_PRIORITIES
+#else /* PROCESS_WITH_PRIORITIES */
+#define QUEUES 1
+#endif /* PROCESS_WITH_PRIORITIES */
+
+static_assert(PROCESS_BATCH_SIZE > 0,
+  "PROCESS_CONF_BATCH_SIZE must be positive.");
+
 /*
  * A configurable function called after a process poll been requested.
  */
@@ -92,8 +110,34 @@ struct event_data {
   process_event_t ev;
 };
 
-static process_num_events_t nevents, fevent;
+/*
+ * Ring buffer of events. The size is a power of 2.
+ */
+struct event_queue {
+  struct event_data *events;
+  process_num_events_t size;
+  process_num_events_t nevents;
+  process_num_events_t fevent;
+  uint16_t overflows;
+};
+
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
+#if PROCESS_WITH_PRIORITIES
+static struct event_data timer_events[PROCESS_NUMEVENTS_TIMER];
+static struct event_data network_events[PROCESS_NUMEVENTS_NETWORK];
+#endif /* PROCESS_WITH_PRIORITIES */
+
+/* Indexed by priority. */
+static struct event_queue queues[QUEUES] = {
+  { events, PROCESS_CONF_NUMEVENTS, 0, 0, 0 },
+#if PROCESS_WITH_PRIORITIES
+  { timer_events, PROCESS_NUMEVENTS_TIMER, 0, 0, 0 },
+  { network_events, PROCESS_NUMEVENTS_NETWORK, 0, 0, 0 },
+#endif /* PROCESS_WITH_PRIORITIES */
+};
+
+/* Total number of queued events. */
+static process_num_events_t nevents;
 
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
@@ -253,7 +297,7 @@ do_poll(void)
  * listening processes.
  */
 /*---------------------------------------------------------------------------*/
-static void
+static bool
 do_event(void)
 {
   /*
@@ -263,54 +307,67 @@ do_event(void)
    * function for the process. We only process one event at a time and
    * call the poll handlers inbetween.
    */
-  if(nevents > 0) {
-
-    /* There are events that we should deliver. */
-    process_event_t ev = events[fevent].ev;
-    process_data_t data = events[fevent].data;
-    struct process *receiver = events[fevent].p;
-
-    /* Since we have seen the new event, we move pointer upwards
-       and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
-    --nevents;
-
-    /* If this is a broadcast event, we deliver it to all events, in
-       order of their priority. */
-    if(receiver == PROCESS_BROADCAST) {
-      for(struct process *p = process_list; p != NULL; p = p->next) {
-        /* If we have been requested to poll a process, we do this in
-           between processing the broadcast event. */
-        if(poll_requested) {
-          do_poll();
-        }
-        call_process(p, ev, data);
-      }
-    } else {
-      /* This is not a broadcast event, so we deliver it to the
-         specified process. */
-      /* If the event was an INIT event, we should also update the
-         state of the process. */
-      if(ev == PROCESS_EVENT_INIT) {
-        receiver->state = PROCESS_STATE_RUNNING;
-      }
+  if(nevents == 0) {
+    return false;
+  }
 
-      /* Make sure that the process actually is running. */
-      call_process(receiver, ev, data);
+  /* Take the event from the highest-priority queue that is not empty. */
+  struct event_queue *queue = &queues[QUEUES - 1];
+  while(queue->nevents == 0) {
+    queue--;
+  }
+
+  /* There are events that we should deliver. */
+  process_event_t ev = queue->events[queue->fevent].ev;
+  process_data_t data = queue->events[queue->fevent].data;
+  struct process *receiver = queue->events[queue->fevent].p;
+
+  /* Since we have seen the new event, we move pointer upwards
+     and decrease the number of events. */
+  queue->fevent = (queue->fevent + 1) & (queue->size - 1);
+  --queue->nevents;
+  --nevents;
+
+  /* If this is a broadcast event, we deliver it to all events, in
+     order of their priority. */
+  if(receiver == PROCESS_BROADCAST) {
+    for(struct process *p = process_list; p != NULL; p = p->next) {
+      /* If we have been requested to poll a process, we do this in
+         between processing the broadcast event. */
+      if(poll_requested) {
+        do_poll();
+      }
+      call_process(p, ev, data);
     }
+  } else {
+    /* This is not a broadcast event, so we deliver it to the
+       specified process. */
+    /* If the event was an INIT event, we should also update the
+       state of the process. */
+    if(ev == PROCESS_EVENT_INIT) {
+      receiver->state = PROCESS_STATE_RUNNING;
+    }
+
+    /* Make sure that the process actually is running. */
+    call_process(receiver, ev, data);
   }
+  return true;
 }
 /*---------------------------------------------------------------------------*/
 process_num_events_t
 process_run(void)
 {
-  /* Process poll events. */
-  if(poll_requested) {
-    do_poll();
-  }
+  for(unsigned i = 0; i < PROCESS_BATCH_SIZE; i++) {
+    /* Process poll events. */
+    if(poll_requested) {
+      do_poll();
+    }
 
-  /* Process one event from the queue */
-  do_event();
+    /* Process one event from the queue */
+    if(!do_event()) {
+      break;
+    }
+  }
 
   return nevents + poll_requested;
 }
@@ -321,10 +378,32 @@ process_nevents(void)
   return nevents + poll_requested;
 }
 /*---------------------------------------------------------------------------*/
+static uint8_t
+event_priority(struct process *p, process_event_t ev)
+{
+#if PROCESS_WITH_PRIORITIES
+  if(p == PROCESS_BROADCAST) {
+    return PROCESS_PRIORITY_APPLICATION;
+  }
+  if(ev == PROCESS_EVENT_TIMER && p->priority < PROCESS_PRIORITY_TIMER) {
+    return PROCESS_PRIORITY_TIMER;
+  }
+  return p->priority;
+#else /* PROCESS_WITH_PRIORITIES */
+  return 0;
+#endif /* PROCESS_WITH_PRIORITIES */
+}
+/*---------------------------------------------------------------------------*/
 int
-process_post(struct process *p, process_event_t ev, process_data_t data)
+process_post_with_priority(struct process *p, process_event_t ev,
+                           process_data_t data, uint8_t priority)
 {
-  if(nevents == PROCESS_CONF_NUMEVENTS) {
+  struct event_queue *queue = &queues[priority < QUEUES ? priority : 0];
+
+  if(queue->nevents == queue->size) {
+    if(queue->overflows != UINT16_MAX) {
+      queue->overflows++;
+    }
     LOG_WARN("Cannot post event %d to %s from %s because the queue is full\n",
              ev,
              p == PROCESS_BROADCAST ? "<broadcast>" : PROCESS_NAME_STRING(p),
@@ -338,10 +417,11 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
           nevents);
 
   process_num_events_t snum =
-    (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
-  events[snum].ev = ev;
-  events[snum].data = data;
-  events[snum].p = p;
+    (process_num_events_t)(queue->fevent + queue->nevents) & (queue->size - 1);
+  queue->events[snum].ev = ev;
+  queue->events[snum].data = data;
+  queue->events[snum].p = p;
+  ++queue->nevents;
   ++nevents;
 
 #if PROCESS_CONF_STATS
@@ -353,6 +433,35 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
   return PROCESS_ERR_OK;
 }
 /*---------------------------------------------------------------------------*/
+int
+process_post(struct process *p, process_event_t ev, process_data_t data)
+{
+  return process_post_with_priority(p, ev, data, event_priority(p, ev));
+}
+/*---------------------------------------------------------------------------*/
+void
+process_set_priority(struct process *p, uint8_t priority)
+{
+#if PROCESS_WITH_PRIORITIES
+  p->priority = priority < PROCESS_PRIORITIES
+                ? priority : PROCESS_PRIORITY_APPLICATION;
+#endif /* PROCESS_WITH_PRIORITIES */
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+process_overflows(uint8_t priority)
+{
+  return queues[priority < QUEUES ? priority : 0].overflows;
+}
+/*---------------------------------------------------------------------------*/
+void
+process_reset_overflows(void)
+{
+  for(size_t i = 0; i < QUEUES; i++) {
+    queues[i].overflows = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
 void
 process_post_synch(struct process *p, process_event_t ev, process_data_t data)
 {
@@ -90,6 +90,52 @@ typedef uint8_t       process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/*
+ * Events can optionally be queued in separate FIFOs per priority
+ * class. Network processing is dispatched before timer events, which
+ * are in turn dispatched before application events. Within a class,
+ * events keep their posting order.
+ */
+#ifdef PROCESS_CONF_WITH_PRIORITIES
+#define PROCESS_WITH_PRIORITIES PROCESS_CONF_WITH_PRIORITIES
+#else
+#define PROCESS_WITH_PRIORITIES 0
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
+
+/* Capacity of the network event queue. Must be a power of 2. */
+#ifdef PROCESS_CONF_NUMEVENTS_NETWORK
+#define PROCESS_NUMEVENTS_NETWORK PROCESS_CONF_NUMEVENTS_NETWORK
+#else
+#define PROCESS_NUMEVENTS_NETWORK 8
+#endif /* PROCESS_CONF_NUMEVENTS_NETWORK */
+
+/* Capacity of the timer event queue. Must be a power of 2. */
+#ifdef PROCESS_CONF_NUMEVENTS_TIMER
+#define PROCESS_NUMEVENTS_TIMER PROCESS_CONF_NUMEVENTS_TIMER
+#else
+#define PROCESS_NUMEVENTS_TIMER 16
+#endif /* PROCESS_CONF_NUMEVENTS_TIMER */
+
+/*
+ * Maximum number of queued events that process_run() dispatches
+ * before returning. Poll handlers still run between events.
+ */
+#ifdef PROCESS_CONF_BATCH_SIZE
+#define PROCESS_BATCH_SIZE PROCESS_CONF_BATCH_SIZE
+#else
+#define PROCESS_BATCH_SIZE 1
+#endif /* PROCESS_CONF_BATCH_SIZE */
+
+/**
+ * \name Event priorities
+ * @{
+ */
+#define PROCESS_PRIORITY_APPLICATION  0
+#define PROCESS_PRIORITY_TIMER        1
+#define PROCESS_PRIORITY_NETWORK      2
+#define PROCESS_PRIORITIES            3
+/** @} */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -326,6 +372,9 @@ struct process {
   struct pt pt;
   uint8_t state;
   bool needspoll;
+#if PROCESS_WITH_PRIORITIES
+  uint8_t priority;
+#endif /* PROCESS_WITH_PRIORITIES */
 };
 
 /**
@@ -367,6 +416,63 @@ void process_start(struct process *p, process_data_t data);
  */
 int process_post(struct process *p, process_event_t ev, process_data_t data);
 
+/**
+ * Post an asynchronous event with an explicit priority.
+ *
+ * This function works like process_post(), but queues the event in
+ * the queue of the given priority class instead of deriving the
+ * class from the receiving process. Without
+ * PROCESS_CONF_WITH_PRIORITIES, the priority is ignored.
+ *
+ * \param p The process to which the event should be posted, or
+ * PROCESS_BROADCAST if the event should be posted to all processes.
+ *
+ * \param ev The event to be posted.
+ *
+ * \param data The auxiliary data to be sent with the event
+ *
+ * \param priority One of the PROCESS_PRIORITY_* values.
+ *
+ * \retval PROCESS_ERR_OK The event could be posted.
+ *
+ * \retval PROCESS_ERR_FULL The event queue was full and the event could
+ * not be posted.
+ */
+int process_post_with_priority(struct process *p, process_event_t ev,
+                               process_data_t data, uint8_t priority);
+
+/**
+ * Set the priority class of a process.
+ *
+ * Events posted to the process with process_post() are queued in the
+ * queue of this class. Timer events are queued with at least timer
+ * priority and broadcast events with application priority. Processes
+ * have application priority by default. Without
+ * PROCESS_CONF_WITH_PRIORITIES, this function has no effect.
+ *
+ * \param p A pointer to the process' process structure.
+ *
+ * \param priority One of the PROCESS_PRIORITY_* values.
+ */
+void process_set_priority(struct process *p, uint8_t priority);
+
+/**
+ * Get the number of events that could not be posted because the
+ * queue of a priority class was full.
+ *
+ * \param priority One of the PROCESS_PRIORITY_* values. Without
+ * PROCESS_CONF_WITH_PRIORITIES, there is a single queue and the
+ * priority is ignored.
+ *
+ * \return The number of dropped events, saturating at UINT16_MAX.
+ */
+uint16_t process_overflows(uint8_t priority);
+
+/**
+ * Reset the overflow counters of all event queues.
+ */
+void process_reset_overflows(void);
+
 /**
  * Post a synchronous event to a process.
  *
@@ -498,7 +604,8 @@ void process_init(void);
  *
  * This function should be called repeatedly from the main() program
  * to actually run the Contiki system. It calls the necessary poll
- * handlers, and processes one event. The function returns the number
+ * handlers, and processes one event, or up to PROCESS_CONF_BATCH_SIZE
+ * events with poll handlers called in between. The function returns the number
  * of events that are waiting in the event queue so that the caller
  * may choose to put the CPU to sleep when there are no pending
  * events.
@@ -52,6 +52,68 @@ static const char *testcases[][3] = {
 
 #define MAXLEN 65536
 
+#define THROUGHPUT_FRAMES 20000
+#define THROUGHPUT_A_LEN 21
+#define THROUGHPUT_M_LEN 96
+
+#define KEY_SWITCHING_NEIGHBORS 100
+#define KEY_SWITCHING_FRAMES 100000
+#define KEY_SWITCHING_M_LEN 32
+
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aes_blocks, "AES-128 blocks");
+UNIT_TEST(aes_blocks)
+{
+  /* FIPS 197, Appendix C.1 */
+  static const char *aes_key = "000102030405060708090a0b0c0d0e0f";
+  static const char *aes_plaintext = "00112233445566778899aabbccddeeff";
+  static const char *aes_ciphertext = "69c4e0d86a7b0430d8cdb78070b4c55a";
+  uint8_t key_bytes[AES_128_KEY_LENGTH];
+  uint8_t plaintext[AES_128_BLOCK_SIZE];
+  uint8_t ciphertext[AES_128_BLOCK_SIZE];
+  uint8_t blocks[3 * AES_128_BLOCK_SIZE];
+  uint8_t counter[AES_128_BLOCK_SIZE];
+  uint8_t i;
+
+  UNIT_TEST_BEGIN();
+
+  hexconv_unhexlify(aes_key, strlen(aes_key), key_bytes, sizeof(key_bytes));
+  hexconv_unhexlify(aes_plaintext, strlen(aes_plaintext),
+                    plaintext, sizeof(plaintext));
+  hexconv_unhexlify(aes_ciphertext, strlen(aes_ciphertext),
+                    ciphertext, sizeof(ciphertext));
+  UNIT_TEST_ASSERT(AES_128.set_key(key_bytes));
+
+  memcpy(blocks, plaintext, sizeof(plaintext));
+  UNIT_TEST_ASSERT(AES_128.encrypt(blocks));
+  UNIT_TEST_ASSERT(!memcmp(blocks, ciphertext, sizeof(ciphertext)));
+
+  for(i = 0; i < 3; i++) {
+    memcpy(blocks + i * AES_128_BLOCK_SIZE, plaintext, sizeof(plaintext));
+  }
+  UNIT_TEST_ASSERT(AES_128.encrypt_blocks(blocks, 3));
+  for(i = 0; i < 3; i++) {
+    UNIT_TEST_ASSERT(!memcmp(blocks + i * AES_128_BLOCK_SIZE,
+                             ciphertext, sizeof(ciphertext)));
+  }
+
+  /* The key stream of a counter that carries into the second-last byte */
+  memset(blocks, 0, sizeof(blocks));
+  memcpy(counter, plaintext, sizeof(plaintext));
+  UNIT_TEST_ASSERT(aes_128_ctr(counter, blocks, sizeof(blocks) - 1));
+  UNIT_TEST_ASSERT(!memcmp(blocks, ciphertext, sizeof(ciphertext)));
+  UNIT_TEST_ASSERT(counter[14] == 0xef && counter[15] == 0x02);
+  memcpy(ciphertext, plaintext, sizeof(plaintext));
+  ciphertext[14] = 0xef;
+  ciphertext[15] = 0x01;
+  UNIT_TEST_ASSERT(AES_128.encrypt(ciphertext));
+  UNIT_TEST_ASSERT(!memcmp(blocks + 2 * AES_128_BLOCK_SIZE,
+                           ciphertext, AES_128_BLOCK_SIZE - 1));
+  UNIT_TEST_ASSERT(blocks[sizeof(blocks) - 1] == 0);
+
+  UNIT_TEST_END();
+}
+
 /*---------------------------------------------------------------------------*/
 UNIT_TEST_REGISTER(aesccm_encrypt, "AES-CCM encryption");
 UNIT_TEST(aesccm_encrypt)
@@ -170,6 +232,114 @@ UNIT_TEST(aesccm_decrypt)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aesccm_throughput, "AES-CCM throughput");
+UNIT_TEST(aesccm_throughput)
+{
+  static uint8_t key_bytes[16];
+  static uint8_t nonce_bytes[13];
+  static uint8_t frame[THROUGHPUT_A_LEN + THROUGHPUT_M_LEN + MICLEN];
+  uint32_t i;
+  clock_time_t start;
+  clock_time_t duration;
+
+  UNIT_TEST_BEGIN();
+
+  hexconv_unhexlify(key, strlen(key), key_bytes, sizeof(key_bytes));
+  hexconv_unhexlify(nonce, strlen(nonce), nonce_bytes, sizeof(nonce_bytes));
+  UNIT_TEST_ASSERT(CCM_STAR.set_key(key_bytes));
+
+  start = clock_time();
+  for(i = 0; i < THROUGHPUT_FRAMES; i++) {
+    UNIT_TEST_ASSERT(CCM_STAR.aead(nonce_bytes,
+                                   frame + THROUGHPUT_A_LEN, THROUGHPUT_M_LEN,
+                                   frame, THROUGHPUT_A_LEN,
+                                   frame + THROUGHPUT_A_LEN + THROUGHPUT_M_LEN,
+                                   MICLEN,
+                                   true));
+  }
+  duration = clock_time() - start;
+  printf("TEST: tables %u, %u + %u byte frames: %lu bytes/s\n",
+         AES_128_CONF_WITH_TABLES,
+         THROUGHPUT_A_LEN, THROUGHPUT_M_LEN,
+         (unsigned long)((uint64_t)THROUGHPUT_FRAMES
+                         * (THROUGHPUT_A_LEN + THROUGHPUT_M_LEN)
+                         * CLOCK_SECOND / MAX(duration, 1)));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static bool
+secure_short_frame(const uint8_t key_bytes[static 16],
+                   const uint8_t nonce_bytes[static 13],
+                   uint8_t frame[static THROUGHPUT_A_LEN + KEY_SWITCHING_M_LEN + MICLEN])
+{
+  memset(frame, 0, THROUGHPUT_A_LEN + KEY_SWITCHING_M_LEN);
+  return CCM_STAR.set_key(key_bytes)
+         && CCM_STAR.aead(nonce_bytes,
+                          frame + THROUGHPUT_A_LEN, KEY_SWITCHING_M_LEN,
+                          frame, THROUGHPUT_A_LEN,
+                          frame + THROUGHPUT_A_LEN + KEY_SWITCHING_M_LEN,
+                          MICLEN,
+                          true);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(key_switching, "AES-CCM key switching");
+UNIT_TEST(key_switching)
+{
+  static const uint8_t neighbor_counts[] = { 1, 10, KEY_SWITCHING_NEIGHBORS };
+  static uint8_t keys[KEY_SWITCHING_NEIGHBORS][16];
+  static uint8_t macs[KEY_SWITCHING_NEIGHBORS][MICLEN];
+  static uint8_t nonce_bytes[13];
+  static uint8_t frame[THROUGHPUT_A_LEN + KEY_SWITCHING_M_LEN + MICLEN];
+  uint32_t i;
+  uint8_t j;
+  clock_time_t start;
+  clock_time_t duration;
+
+  UNIT_TEST_BEGIN();
+
+  hexconv_unhexlify(nonce, strlen(nonce), nonce_bytes, sizeof(nonce_bytes));
+  for(i = 0; i < KEY_SWITCHING_NEIGHBORS; i++) {
+    for(j = 0; j < 16; j++) {
+      keys[i][j] = random_rand();
+    }
+    UNIT_TEST_ASSERT(secure_short_frame(keys[i], nonce_bytes, frame));
+    memcpy(macs[i], frame + THROUGHPUT_A_LEN + KEY_SWITCHING_M_LEN, MICLEN);
+  }
+
+  for(j = 0; j < CC_ARRAY_LENGTH(neighbor_counts); j++) {
+    /* Secure frames to the neighbors in turn */
+    start = clock_time();
+    for(i = 0; i < KEY_SWITCHING_FRAMES; i++) {
+      UNIT_TEST_ASSERT(secure_short_frame(keys[i % neighbor_counts[j]],
+                                          nonce_bytes, frame));
+    }
+    duration = clock_time() - start;
+    printf("TEST: key cache %u, %u neighbors: %lu frames/s\n",
+           AES_128_CONF_KEY_CACHE_SIZE,
+           neighbor_counts[j],
+           (unsigned long)((uint64_t)KEY_SWITCHING_FRAMES
+                           * CLOCK_SECOND / MAX(duration, 1)));
+  }
+
+  /* Cached and evicted keys still yield the same MICs */
+  for(i = KEY_SWITCHING_NEIGHBORS; i--;) {
+    UNIT_TEST_ASSERT(secure_short_frame(keys[i], nonce_bytes, frame));
+    UNIT_TEST_ASSERT(!memcmp(macs[i],
+                             frame + THROUGHPUT_A_LEN + KEY_SWITCHING_M_LEN,
+                             MICLEN));
+  }
+
+  /* A key that is replaced in place takes effect */
+  memcpy(keys[0], keys[1], sizeof(keys[0]));
+  UNIT_TEST_ASSERT(secure_short_frame(keys[0], nonce_bytes, frame));
+  UNIT_TEST_ASSERT(!memcmp(macs[1],
+                           frame + THROUGHPUT_A_LEN + KEY_SWITCHING_M_LEN,
+                           MICLEN));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -177,8 +347,20 @@ PROCESS_THREAD(test_process, ev, data)
   printf("Run unit-test\n");
   printf("---\n");
 
+  UNIT_TEST_RUN(aes_blocks);
   UNIT_TEST_RUN(aesccm_encrypt);
   UNIT_TEST_RUN(aesccm_decrypt);
+  UNIT_TEST_RUN(aesccm_throughput);
+  UNIT_TEST_RUN(key_switching);
+
+  if(!UNIT_TEST_PASSED(aes_blocks)
+     || !UNIT_TEST_PASSED(aesccm_encrypt)
+     || !UNIT_TEST_PASSED(aesccm_decrypt)
+     || !UNIT_TEST_PASSED(aesccm_throughput)
+     || !UNIT_TEST_PASSED(key_switching)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
 
   printf("=check-me= DONE\n");
   printf("---\n");
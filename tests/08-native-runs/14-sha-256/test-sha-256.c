@@ -32,11 +32,16 @@
 #include "unit-test.h"
 #include "lib/sha-256.h"
 #include "lib/hexconv.h"
+#include "lib/random.h"
 #include "sys/cc.h"
 #include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 
+#define THROUGHPUT_LEN 4096
+#define THROUGHPUT_ROUNDS 2000
+#define HMAC_ROUNDS 200000
+
 PROCESS(test_process, "test");
 AUTOSTART_PROCESSES(&test_process);
 
@@ -538,6 +543,120 @@ UNIT_TEST(sha_256_hmac_interleaved)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(sha_256_hmac_context, "SHA-256 HMAC with context");
+UNIT_TEST(sha_256_hmac_context)
+{
+  UNIT_TEST_BEGIN();
+
+  for(size_t i = 0; i < CC_ARRAY_LENGTH(hmacs); i++) {
+    sha_256_hmac_context_t context;
+    uint8_t hmac[SHA_256_DIGEST_LENGTH];
+    UNIT_TEST_ASSERT(sha_256_hmac_context_init(&context,
+                                               hmacs[i].key,
+                                               hmacs[i].keylen));
+    /* the context can be used repeatedly */
+    for(size_t j = 0; j < 2; j++) {
+      UNIT_TEST_ASSERT(sha_256_hmac_with_context(&context,
+                                                 hmacs[i].data,
+                                                 hmacs[i].datalen,
+                                                 hmac));
+      UNIT_TEST_ASSERT(!memcmp(hmac, hmacs[i].hmac, sizeof(hmac)));
+    }
+    sha_256_hmac_context_start(&context);
+    sha_256_hmac_update(hmacs[i].data, hmacs[i].datalen / 2);
+    sha_256_hmac_update(hmacs[i].data + hmacs[i].datalen / 2,
+                        hmacs[i].datalen - (hmacs[i].datalen / 2));
+    UNIT_TEST_ASSERT(sha_256_hmac_context_finish(&context, hmac));
+    UNIT_TEST_ASSERT(!memcmp(hmac, hmacs[i].hmac, sizeof(hmac)));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(sha_256_drivers, "SHA-256 driver vs. software");
+UNIT_TEST(sha_256_drivers)
+{
+  static uint8_t data[1000];
+  uint8_t expected_digest[SHA_256_DIGEST_LENGTH];
+  uint8_t digest[SHA_256_DIGEST_LENGTH];
+
+  UNIT_TEST_BEGIN();
+
+  for(size_t i = 0; i < sizeof(data); i++) {
+    data[i] = random_rand();
+  }
+  for(size_t len = 0; len <= sizeof(data); len += 37) {
+    /* sha_256_driver.hash would go through SHA_256 */
+    sha_256_driver.init();
+    sha_256_driver.update(data, len);
+    UNIT_TEST_ASSERT(sha_256_driver.finalize(expected_digest));
+    /* split the data to cover partial and multi-block updates */
+    SHA_256.init();
+    SHA_256.update(data, len / 3);
+    SHA_256.update(data + len / 3, len - len / 3);
+    UNIT_TEST_ASSERT(SHA_256.finalize(digest));
+    UNIT_TEST_ASSERT(!memcmp(digest, expected_digest, sizeof(digest)));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+per_second(uint32_t n, clock_time_t duration)
+{
+  return (uint64_t)n * CLOCK_SECOND / MAX(duration, 1);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(sha_256_throughput, "SHA-256 throughput");
+UNIT_TEST(sha_256_throughput)
+{
+  static uint8_t data[THROUGHPUT_LEN];
+  static const struct {
+    const char *name;
+    const struct sha_256_driver *driver;
+  } drivers[] = {
+    { "software", &sha_256_driver },
+    { "SHA_256", &SHA_256 },
+  };
+  static const uint8_t key[32];
+  sha_256_hmac_context_t context;
+  uint8_t digest[SHA_256_DIGEST_LENGTH];
+  clock_time_t start;
+
+  UNIT_TEST_BEGIN();
+
+  for(size_t i = 0; i < CC_ARRAY_LENGTH(drivers); i++) {
+    start = clock_time();
+    for(uint32_t j = 0; j < THROUGHPUT_ROUNDS; j++) {
+      drivers[i].driver->init();
+      drivers[i].driver->update(data, sizeof(data));
+      UNIT_TEST_ASSERT(drivers[i].driver->finalize(digest));
+    }
+    printf("TEST: %s, %u byte messages: %lu bytes/s\n",
+           drivers[i].name,
+           THROUGHPUT_LEN,
+           per_second(THROUGHPUT_ROUNDS * THROUGHPUT_LEN,
+                      clock_time() - start));
+  }
+
+  /* HMACs of short messages, as in HKDF-Expand */
+  start = clock_time();
+  for(uint32_t j = 0; j < HMAC_ROUNDS; j++) {
+    UNIT_TEST_ASSERT(sha_256_hmac(key, sizeof(key), data, 33, digest));
+  }
+  printf("TEST: HMAC without context: %lu HMACs/s\n",
+         per_second(HMAC_ROUNDS, clock_time() - start));
+  start = clock_time();
+  UNIT_TEST_ASSERT(sha_256_hmac_context_init(&context, key, sizeof(key)));
+  for(uint32_t j = 0; j < HMAC_ROUNDS; j++) {
+    UNIT_TEST_ASSERT(sha_256_hmac_with_context(&context, data, 33, digest));
+  }
+  printf("TEST: HMAC with context: %lu HMACs/s\n",
+         per_second(HMAC_ROUNDS, clock_time() - start));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 UNIT_TEST_REGISTER(sha_256_hkdf, "SHA-256 HKDF");
 UNIT_TEST(sha_256_hkdf)
 {
@@ -605,6 +724,9 @@ PROCESS_THREAD(test_process, ev, data)
   UNIT_TEST_RUN(sha_256_hmac_stepwise);
   UNIT_TEST_RUN(sha_256_hmac_checkpoint);
   UNIT_TEST_RUN(sha_256_hmac_interleaved);
+  UNIT_TEST_RUN(sha_256_hmac_context);
+  UNIT_TEST_RUN(sha_256_drivers);
+  UNIT_TEST_RUN(sha_256_throughput);
   UNIT_TEST_RUN(sha_256_hkdf);
   UNIT_TEST_RUN(sha_256_hkdf_shorthand);
   UNIT_TEST_RUN(sha_256_hkdf_max);
@@ -616,6 +738,9 @@ PROCESS_THREAD(test_process, ev, data)
      || !UNIT_TEST_PASSED(sha_256_hmac_stepwise)
      || !UNIT_TEST_PASSED(sha_256_hmac_checkpoint)
      || !UNIT_TEST_PASSED(sha_256_hmac_interleaved)
+     || !UNIT_TEST_PASSED(sha_256_hmac_context)
+     || !UNIT_TEST_PASSED(sha_256_drivers)
+     || !UNIT_TEST_PASSED(sha_256_throughput)
      || !UNIT_TEST_PASSED(sha_256_hkdf)
      || !UNIT_TEST_PASSED(sha_256_hkdf_shorthand)
      || !UNIT_TEST_PASSED(sha_256_hkdf_max)) {
@@ -30,11 +30,64 @@
 
 #include "contiki.h"
 #include "unit-test.h"
+#include <stdint.h>
 #include <stdio.h>
 
+#define MANY_TIMERS (ETIMER_HEAP_SIZE + 16)
+#define BENCHMARK_OPERATIONS 100000
+#define DISPATCH_GROUPS 4
+
 PROCESS(test_process, "test");
 AUTOSTART_PROCESSES(&test_process);
 
+static struct etimer timers[MANY_TIMERS];
+static uint32_t seed = 1;
+static size_t dispatch_group;
+static size_t dispatch_index;
+static bool dispatch_in_order;
+
+/*---------------------------------------------------------------------------*/
+static uint16_t
+pseudo_random(void)
+{
+  seed = seed * 1103515245 + 12345;
+  return seed >> 16;
+}
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+random_interval(void)
+{
+  return CLOCK_SECOND + pseudo_random() % (60 * CLOCK_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+next_expiration_is_first(size_t count)
+{
+  size_t i;
+  clock_time_t next = etimer_next_expiration_time();
+
+  for(i = 0; i < count; i++) {
+    if(!etimer_expired(&timers[i])
+       && CLOCK_LT(etimer_expiration_time(&timers[i]), next)) {
+      return false;
+    }
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_expired_timers(void)
+{
+  size_t i;
+  clock_time_t start = clock_time() - 10 * CLOCK_SECOND;
+
+  /* Spread over the heap and the list, with DISPATCH_GROUPS distinct
+     expiration times and in the order of their index */
+  for(i = 0; i < MANY_TIMERS; i++) {
+    etimer_set(&timers[i], CLOCK_SECOND + i % DISPATCH_GROUPS);
+    etimer_adjust(&timers[i], (int)(start - etimer_start_time(&timers[i])));
+  }
+}
 /*---------------------------------------------------------------------------*/
 UNIT_TEST_REGISTER(expiration, "expiration");
 UNIT_TEST(expiration)
@@ -78,6 +131,94 @@ UNIT_TEST(ordering)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(many, "many timers");
+UNIT_TEST(many)
+{
+  size_t i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Exceed the heap capacity so that some timers end up in the list */
+  for(i = 0; i < MANY_TIMERS; i++) {
+    etimer_set(&timers[i], random_interval());
+  }
+  UNIT_TEST_ASSERT(etimer_check_ordering());
+  UNIT_TEST_ASSERT(next_expiration_is_first(MANY_TIMERS));
+  for(i = 0; i < MANY_TIMERS; i += 3) {
+    etimer_stop(&timers[i]);
+    UNIT_TEST_ASSERT(etimer_expired(&timers[i]));
+  }
+  UNIT_TEST_ASSERT(etimer_check_ordering());
+  UNIT_TEST_ASSERT(next_expiration_is_first(MANY_TIMERS));
+  for(i = 0; i < MANY_TIMERS; i += 2) {
+    etimer_set(&timers[i], random_interval());
+  }
+  UNIT_TEST_ASSERT(etimer_check_ordering());
+  UNIT_TEST_ASSERT(next_expiration_is_first(MANY_TIMERS));
+  for(i = 0; i < MANY_TIMERS; i++) {
+    etimer_stop(&timers[i]);
+  }
+  UNIT_TEST_ASSERT(etimer_check_ordering());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "benchmark");
+UNIT_TEST(benchmark)
+{
+  static const size_t counts[] = { 8, 32, 128 };
+  size_t i;
+  size_t j;
+  uint32_t k;
+  clock_time_t start;
+  clock_time_t set_duration;
+  clock_time_t stop_duration;
+
+  UNIT_TEST_BEGIN();
+
+  printf("Heap: %s\n", ETIMER_WITH_HEAP ? "yes" : "no");
+  for(i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+    if(counts[i] > MANY_TIMERS) {
+      break;
+    }
+    for(j = 0; j < counts[i]; j++) {
+      etimer_set(&timers[j], random_interval());
+    }
+
+    /* Rescheduling a pending timer */
+    start = clock_time();
+    for(k = 0; k < BENCHMARK_OPERATIONS; k++) {
+      etimer_set(&timers[pseudo_random() % counts[i]], random_interval());
+    }
+    set_duration = clock_time() - start;
+
+    /* Stopping a pending timer and starting it again */
+    start = clock_time();
+    for(k = 0; k < BENCHMARK_OPERATIONS; k++) {
+      j = pseudo_random() % counts[i];
+      etimer_stop(&timers[j]);
+      etimer_set(&timers[j], random_interval());
+    }
+    stop_duration = clock_time() - start;
+
+    UNIT_TEST_ASSERT(etimer_check_ordering());
+    UNIT_TEST_ASSERT(next_expiration_is_first(counts[i]));
+    for(j = 0; j < counts[i]; j++) {
+      etimer_stop(&timers[j]);
+    }
+    printf("%u timers: %lu ns per set, %lu ns per stop and set\n",
+           (unsigned)counts[i],
+           (unsigned long)((uint64_t)set_duration
+                           * (1000000000 / CLOCK_SECOND)
+                           / BENCHMARK_OPERATIONS),
+           (unsigned long)((uint64_t)stop_duration
+                           * (1000000000 / CLOCK_SECOND)
+                           / BENCHMARK_OPERATIONS));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -87,9 +228,30 @@ PROCESS_THREAD(test_process, ev, data)
 
   UNIT_TEST_RUN(expiration);
   UNIT_TEST_RUN(ordering);
+  UNIT_TEST_RUN(many);
+  UNIT_TEST_RUN(benchmark);
+
+  /* Timers fire in expiration order and, if they expire at the same time,
+     in the order in which they were set */
+  set_expired_timers();
+  dispatch_in_order = true;
+  for(dispatch_group = 0; dispatch_group < DISPATCH_GROUPS; dispatch_group++) {
+    for(dispatch_index = dispatch_group;
+        dispatch_index < MANY_TIMERS;
+        dispatch_index += DISPATCH_GROUPS) {
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+      if(data != &timers[dispatch_index]) {
+        dispatch_in_order = false;
+      }
+    }
+  }
+  printf("Dispatch order: %s\n", dispatch_in_order ? "success" : "failure");
 
   if(!UNIT_TEST_PASSED(expiration)
-     || !UNIT_TEST_PASSED(ordering)) {
+     || !UNIT_TEST_PASSED(ordering)
+     || !UNIT_TEST_PASSED(many)
+     || !UNIT_TEST_PASSED(benchmark)
+     || !dispatch_in_order) {
     printf("=check-me= FAILED\n");
     printf("---\n");
   }
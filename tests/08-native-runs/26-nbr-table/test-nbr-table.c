@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "unit-test.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define BENCHMARK_LOOKUPS 1000000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+struct test_item {
+  uint16_t id;
+};
+NBR_TABLE(struct test_item, test_table);
+
+/*---------------------------------------------------------------------------*/
+static void
+make_lladdr(linkaddr_t *lladdr, uint16_t id)
+{
+  linkaddr_copy(lladdr, &linkaddr_null);
+  lladdr->u8[0] = 0x02;
+  lladdr->u8[LINKADDR_SIZE - 2] = id >> 8;
+  lladdr->u8[LINKADDR_SIZE - 1] = id & 0xff;
+}
+/*---------------------------------------------------------------------------*/
+static int
+fill_table(uint16_t first_id, uint16_t count)
+{
+  uint16_t id;
+  linkaddr_t lladdr;
+  struct test_item *item;
+
+  for(id = first_id; id < first_id + count; id++) {
+    make_lladdr(&lladdr, id);
+    item = nbr_table_add_lladdr(test_table, &lladdr,
+                                NBR_TABLE_REASON_UNDEFINED, NULL);
+    if(!item) {
+      return 0;
+    }
+    item->id = id;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+lookup_range(uint16_t first_id, uint16_t count)
+{
+  uint16_t id;
+  linkaddr_t lladdr;
+  struct test_item *item;
+
+  for(id = first_id; id < first_id + count; id++) {
+    make_lladdr(&lladdr, id);
+    item = nbr_table_get_from_lladdr(test_table, &lladdr);
+    if(!item
+       || item->id != id
+       || !linkaddr_cmp(nbr_table_get_lladdr(test_table, item), &lladdr)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(lookup, "lookup");
+UNIT_TEST(lookup)
+{
+  linkaddr_t lladdr;
+
+  UNIT_TEST_BEGIN();
+
+  nbr_table_clear();
+  UNIT_TEST_ASSERT(fill_table(0, NBR_TABLE_MAX_NEIGHBORS));
+  UNIT_TEST_ASSERT(lookup_range(0, NBR_TABLE_MAX_NEIGHBORS));
+  make_lladdr(&lladdr, NBR_TABLE_MAX_NEIGHBORS);
+  UNIT_TEST_ASSERT(!nbr_table_get_from_lladdr(test_table, &lladdr));
+  UNIT_TEST_ASSERT(nbr_table_add_lladdr(test_table, NULL,
+                                        NBR_TABLE_REASON_UNDEFINED, NULL));
+  UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_table, NULL));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(replacement, "replacement");
+UNIT_TEST(replacement)
+{
+  nbr_table_key_t *key;
+  struct test_item *item;
+  int count;
+
+  UNIT_TEST_BEGIN();
+
+  nbr_table_clear();
+  UNIT_TEST_ASSERT(fill_table(0, NBR_TABLE_MAX_NEIGHBORS));
+  /* Each further neighbor evicts one of the existing ones */
+  UNIT_TEST_ASSERT(fill_table(NBR_TABLE_MAX_NEIGHBORS,
+                              NBR_TABLE_MAX_NEIGHBORS));
+  UNIT_TEST_ASSERT(lookup_range(NBR_TABLE_MAX_NEIGHBORS,
+                                NBR_TABLE_MAX_NEIGHBORS));
+
+  count = 0;
+  for(key = nbr_table_key_head(); key; key = nbr_table_key_next(key)) {
+    item = nbr_table_get_from_lladdr(test_table, &key->lladdr);
+    UNIT_TEST_ASSERT(item);
+    UNIT_TEST_ASSERT(nbr_table_get_lladdr(test_table, item) == &key->lladdr);
+    count++;
+  }
+  UNIT_TEST_ASSERT(count == NBR_TABLE_MAX_NEIGHBORS);
+
+  nbr_table_clear();
+  UNIT_TEST_ASSERT(!nbr_table_key_head());
+  UNIT_TEST_ASSERT(!nbr_table_get_from_lladdr(test_table,
+                                              &linkaddr_node_addr));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "benchmark");
+UNIT_TEST(benchmark)
+{
+  static const uint16_t sizes[] = { 16, 64, NBR_TABLE_MAX_NEIGHBORS };
+  size_t i;
+  uint32_t j;
+  linkaddr_t lladdr;
+  clock_time_t start;
+  clock_time_t duration;
+  uint32_t found;
+
+  UNIT_TEST_BEGIN();
+
+  printf("Index: %s\n",
+         NBR_TABLE_WITH_LLADDR_INDEX ? "hash" : "list");
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    nbr_table_clear();
+    UNIT_TEST_ASSERT(fill_table(0, sizes[i]));
+    found = 0;
+    start = clock_time();
+    for(j = 0; j < BENCHMARK_LOOKUPS; j++) {
+      make_lladdr(&lladdr, j % sizes[i]);
+      found += nbr_table_get_from_lladdr(test_table, &lladdr) != NULL;
+    }
+    duration = clock_time() - start;
+    UNIT_TEST_ASSERT(found == BENCHMARK_LOOKUPS);
+    printf("%u neighbors: %lu ns per lookup\n",
+           sizes[i],
+           (unsigned long)((uint64_t)duration
+                           * (1000000000 / CLOCK_SECOND)
+                           / BENCHMARK_LOOKUPS));
+  }
+  nbr_table_clear();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  nbr_table_register(test_table, NULL);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(lookup);
+  UNIT_TEST_RUN(replacement);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(lookup)
+     || !UNIT_TEST_PASSED(replacement)
+     || !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "unit-test.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NEXTHOP_COUNT 8
+#define BENCHMARK_PACKETS 20000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static uip_ipaddr_t nexthops[NEXTHOP_COUNT];
+
+/*---------------------------------------------------------------------------*/
+static void
+make_destination(uip_ipaddr_t *addr, uint16_t id)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0, 0, id >> 8, id & 0xff);
+}
+/*---------------------------------------------------------------------------*/
+static int
+add_nexthops(void)
+{
+  uint8_t i;
+  uip_lladdr_t lladdr;
+
+  for(i = 0; i < NEXTHOP_COUNT; i++) {
+    memset(&lladdr, 0, sizeof(lladdr));
+    lladdr.addr[0] = 0x02;
+    lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+    uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0, i + 1);
+    if(!uip_ds6_nbr_add(&nexthops[i], &lladdr, 1, NBR_REACHABLE,
+                        NBR_TABLE_REASON_UNDEFINED, NULL)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+rm_all_routes(void)
+{
+  uip_ds6_route_t *r;
+
+  while((r = uip_ds6_route_head()) != NULL) {
+    uip_ds6_route_rm(r);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+add_routes(uint16_t count)
+{
+  uint16_t id;
+  uip_ipaddr_t addr;
+
+  for(id = 0; id < count; id++) {
+    make_destination(&addr, id);
+    if(!uip_ds6_route_add(&addr, 128, &nexthops[id % NEXTHOP_COUNT])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(longest_match, "longest match");
+UNIT_TEST(longest_match)
+{
+  uip_ipaddr_t prefix;
+  uip_ipaddr_t addr;
+  uip_ds6_route_t *host_route;
+  uip_ds6_route_t *prefix_route;
+  uip_ds6_route_t *default_route;
+
+  UNIT_TEST_BEGIN();
+
+  rm_all_routes();
+  /* Adding a route replaces a matching route with another next hop,
+     so add the more specific route first */
+  make_destination(&addr, 1);
+  host_route = uip_ds6_route_add(&addr, 128, &nexthops[1]);
+  UNIT_TEST_ASSERT(host_route);
+  uip_ip6addr(&prefix, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+  prefix_route = uip_ds6_route_add(&prefix, 64, &nexthops[0]);
+  UNIT_TEST_ASSERT(prefix_route);
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == 2);
+
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&addr) == host_route);
+  UNIT_TEST_ASSERT(uip_ipaddr_cmp(uip_ds6_route_nexthop(host_route),
+                                  &nexthops[1]));
+  make_destination(&addr, 2);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&addr) == prefix_route);
+  uip_ip6addr(&addr, 0xfd01, 0, 0, 0, 0, 0, 0, 1);
+  UNIT_TEST_ASSERT(!uip_ds6_route_lookup(&addr));
+
+  /* a zero-length prefix is never matched */
+  uip_ip6addr(&prefix, 0, 0, 0, 0, 0, 0, 0, 0);
+  default_route = uip_ds6_route_add(&prefix, 0, &nexthops[2]);
+  UNIT_TEST_ASSERT(default_route);
+  UNIT_TEST_ASSERT(!uip_ds6_route_lookup(&addr));
+  make_destination(&addr, 2);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&addr) == prefix_route);
+  uip_ds6_route_rm(default_route);
+
+  uip_ds6_route_rm(host_route);
+  make_destination(&addr, 1);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&addr) == prefix_route);
+  uip_ds6_route_rm(prefix_route);
+  UNIT_TEST_ASSERT(!uip_ds6_route_lookup(&addr));
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(rm_by_nexthop, "remove by next hop");
+UNIT_TEST(rm_by_nexthop)
+{
+  uint16_t id;
+  uip_ipaddr_t addr;
+  uip_ds6_route_t *r;
+
+  UNIT_TEST_BEGIN();
+
+  rm_all_routes();
+  UNIT_TEST_ASSERT(add_routes(1000));
+  uip_ds6_route_rm_by_nexthop(&nexthops[0]);
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes()
+                   == 1000 - 1000 / NEXTHOP_COUNT);
+  for(id = 0; id < 1000; id++) {
+    make_destination(&addr, id);
+    r = uip_ds6_route_lookup(&addr);
+    if(id % NEXTHOP_COUNT) {
+      UNIT_TEST_ASSERT(r && uip_ipaddr_cmp(&r->ipaddr, &addr));
+    } else {
+      UNIT_TEST_ASSERT(!r);
+    }
+  }
+  rm_all_routes();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "benchmark");
+UNIT_TEST(benchmark)
+{
+  static const uint16_t sizes[] = { 100, 1000, 10000 };
+  size_t i;
+  uint32_t j;
+  uint32_t seed;
+  uip_ipaddr_t addr;
+  uip_ds6_route_t *r;
+  clock_time_t start;
+  clock_time_t duration;
+  uint32_t forwarded;
+
+  UNIT_TEST_BEGIN();
+
+  printf("Route index: %s\n", UIP_DS6_ROUTE_WITH_INDEX ? "yes" : "no");
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    rm_all_routes();
+    UNIT_TEST_ASSERT(add_routes(sizes[i]));
+    forwarded = 0;
+    seed = 1;
+    start = clock_time();
+    for(j = 0; j < BENCHMARK_PACKETS; j++) {
+      /* Pick pseudo-random destinations to defeat the move-to-front cache */
+      seed = seed * 1103515245 + 12345;
+      make_destination(&addr, (seed >> 16) % sizes[i]);
+      r = uip_ds6_route_lookup(&addr);
+      forwarded += r != NULL && uip_ds6_route_nexthop(r) != NULL;
+    }
+    duration = clock_time() - start;
+    UNIT_TEST_ASSERT(forwarded == BENCHMARK_PACKETS);
+    printf("%u routes: %lu packets/s\n",
+           sizes[i],
+           (unsigned long)((uint64_t)BENCHMARK_PACKETS * CLOCK_SECOND
+                           / (duration ? duration : 1)));
+  }
+  rm_all_routes();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  if(!add_nexthops()) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  UNIT_TEST_RUN(longest_match);
+  UNIT_TEST_RUN(rm_by_nexthop);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(longest_match)
+     || !UNIT_TEST_PASSED(rm_by_nexthop)
+     || !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/ipv6/uipbuf.h"
+#include "net/routing/routing.h"
+#include "unit-test.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CHAIN_COUNT 8
+#define CHAIN_DEPTH 64
+#define PAYLOAD_LEN 16
+#define BENCHMARK_PACKETS 100000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static uip_ipaddr_t root_ipaddr;
+
+/*---------------------------------------------------------------------------*/
+static void
+make_node_addr(uip_ipaddr_t *addr, uint8_t chain, uint8_t depth)
+{
+  uint16_t id = chain * CHAIN_DEPTH + depth + 1;
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0, 0, id >> 8, id & 0xff);
+}
+/*---------------------------------------------------------------------------*/
+static int
+build_tree(void)
+{
+  uint8_t chain;
+  uint8_t depth;
+  uip_ipaddr_t child;
+  uip_ipaddr_t parent;
+
+  for(chain = 0; chain < CHAIN_COUNT; chain++) {
+    uip_ipaddr_copy(&parent, &root_ipaddr);
+    for(depth = 0; depth < CHAIN_DEPTH; depth++) {
+      make_node_addr(&child, chain, depth);
+      if(!uip_sr_update_node(NULL, &child, &parent, 3600)) {
+        return 0;
+      }
+      uip_ipaddr_copy(&parent, &child);
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send_to(const uip_ipaddr_t *dest)
+{
+  uipbuf_clear();
+  memset(UIP_IP_BUF, 0, UIP_IPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &root_ipaddr);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, dest);
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  return NETSTACK_ROUTING.ext_header_update();
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_srh(uint8_t chain, uint8_t first_hop_depth, uint8_t seg_left)
+{
+  uip_ipaddr_t first_hop;
+  struct uip_routing_hdr *rh_hdr;
+
+  rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
+  make_node_addr(&first_hop, chain, first_hop_depth);
+  return UIP_IP_BUF->proto == UIP_PROTO_ROUTING
+         && rh_hdr->seg_left == seg_left
+         && uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &first_hop);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(path, "path");
+UNIT_TEST(path)
+{
+  uip_ipaddr_t dest;
+
+  UNIT_TEST_BEGIN();
+
+  make_node_addr(&dest, 0, 2);
+  UNIT_TEST_ASSERT(send_to(&dest));
+  UNIT_TEST_ASSERT(check_srh(0, 0, 2));
+
+  make_node_addr(&dest, 3, CHAIN_DEPTH - 1);
+  UNIT_TEST_ASSERT(send_to(&dest));
+  UNIT_TEST_ASSERT(check_srh(3, 0, CHAIN_DEPTH - 1));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(parent_change, "parent change");
+UNIT_TEST(parent_change)
+{
+  uip_ipaddr_t node;
+  uip_ipaddr_t parent;
+  uip_ipaddr_t dest;
+
+  UNIT_TEST_BEGIN();
+
+  /* Warm up the path caches, then attach the third node to the root */
+  make_node_addr(&dest, 1, 3);
+  UNIT_TEST_ASSERT(send_to(&dest));
+  UNIT_TEST_ASSERT(check_srh(1, 0, 3));
+  make_node_addr(&node, 1, 2);
+  UNIT_TEST_ASSERT(uip_sr_update_node(NULL, &node, &root_ipaddr, 3600));
+  UNIT_TEST_ASSERT(send_to(&dest));
+  UNIT_TEST_ASSERT(check_srh(1, 2, 1));
+
+  /* Restore the original parent */
+  make_node_addr(&parent, 1, 1);
+  UNIT_TEST_ASSERT(uip_sr_update_node(NULL, &node, &parent, 3600));
+  UNIT_TEST_ASSERT(send_to(&dest));
+  UNIT_TEST_ASSERT(check_srh(1, 0, 3));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(expiry, "expiry");
+UNIT_TEST(expiry)
+{
+  uip_ipaddr_t parent;
+  uip_ipaddr_t dest;
+
+  UNIT_TEST_BEGIN();
+
+  /* Warm up the path cache, then let the node expire and remove it */
+  make_node_addr(&dest, 5, CHAIN_DEPTH - 1);
+  make_node_addr(&parent, 5, CHAIN_DEPTH - 2);
+  UNIT_TEST_ASSERT(send_to(&dest));
+  UNIT_TEST_ASSERT(check_srh(5, 0, CHAIN_DEPTH - 1));
+  uip_sr_expire_parent(NULL, &dest, &parent);
+  uip_sr_periodic(UIP_SR_REMOVAL_DELAY);
+  uip_sr_periodic(1);
+  UNIT_TEST_ASSERT(uip_sr_get_node(NULL, &dest) == NULL);
+
+  /* Re-add it elsewhere, possibly in the memory of the removed node */
+  make_node_addr(&parent, 5, 0);
+  UNIT_TEST_ASSERT(uip_sr_update_node(NULL, &dest, &parent, 3600));
+  UNIT_TEST_ASSERT(send_to(&dest));
+  UNIT_TEST_ASSERT(check_srh(5, 0, 1));
+
+  /* Restore the original parent */
+  make_node_addr(&parent, 5, CHAIN_DEPTH - 2);
+  UNIT_TEST_ASSERT(uip_sr_update_node(NULL, &dest, &parent, 3600));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(free_all, "free all");
+UNIT_TEST(free_all)
+{
+  uip_ipaddr_t node;
+  uip_ipaddr_t dest;
+
+  UNIT_TEST_BEGIN();
+
+  /* Warm up the path cache, then rebuild a shorter path */
+  make_node_addr(&dest, 2, 3);
+  UNIT_TEST_ASSERT(send_to(&dest));
+  UNIT_TEST_ASSERT(check_srh(2, 0, 3));
+  uip_sr_free_all();
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == 0);
+  make_node_addr(&node, 2, 1);
+  UNIT_TEST_ASSERT(uip_sr_update_node(NULL, &node, &root_ipaddr, 3600));
+  UNIT_TEST_ASSERT(uip_sr_update_node(NULL, &dest, &node, 3600));
+  UNIT_TEST_ASSERT(send_to(&dest));
+  UNIT_TEST_ASSERT(check_srh(2, 1, 1));
+
+  /* Restore the original tree */
+  uip_sr_free_all();
+  UNIT_TEST_ASSERT(build_tree());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "benchmark");
+UNIT_TEST(benchmark)
+{
+  static const uint8_t depths[] = { 8, 32, CHAIN_DEPTH };
+  size_t i;
+  uint32_t j;
+  uip_ipaddr_t dest;
+  clock_time_t start;
+  clock_time_t duration;
+  uint32_t inserted;
+
+  UNIT_TEST_BEGIN();
+
+  printf("Node index: %s\n", UIP_SR_WITH_INDEX ? "yes" : "no");
+  for(i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+    inserted = 0;
+    start = clock_time();
+    for(j = 0; j < BENCHMARK_PACKETS; j++) {
+      make_node_addr(&dest, j % CHAIN_COUNT, depths[i] - 1);
+      inserted += send_to(&dest) && UIP_IP_BUF->proto == UIP_PROTO_ROUTING;
+    }
+    duration = clock_time() - start;
+    UNIT_TEST_ASSERT(inserted == BENCHMARK_PACKETS);
+    printf("depth %u: %lu ns per SRH\n",
+           depths[i],
+           (unsigned long)((uint64_t)duration
+                           * (1000000000 / CLOCK_SECOND)
+                           / BENCHMARK_PACKETS));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  if(NETSTACK_ROUTING.root_start()
+     || !NETSTACK_ROUTING.get_root_ipaddr(&root_ipaddr)
+     || !build_tree()) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  UNIT_TEST_RUN(path);
+  UNIT_TEST_RUN(parent_change);
+  UNIT_TEST_RUN(expiry);
+  UNIT_TEST_RUN(free_all);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(path)
+     || !UNIT_TEST_PASSED(parent_change)
+     || !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
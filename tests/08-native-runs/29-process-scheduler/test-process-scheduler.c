@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define BURST (PROCESS_CONF_NUMEVENTS - 4)
+#define BENCHMARK_EVENTS 100000
+#define BENCHMARK_BURST 16
+
+PROCESS(sink_process, "sink");
+PROCESS(network_process, "network");
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static process_event_t load_event;
+static process_event_t ping_event;
+static bool busy;
+static unsigned sink_count;
+static unsigned sink_target;
+static bool pinged;
+static unsigned events_before_ping;
+static clock_time_t ping_time;
+static clock_time_t ping_latency;
+
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == load_event);
+    if(busy) {
+      /* Simulate application processing of about one clock tick. */
+      clock_time_t start = clock_time();
+      while(clock_time() == start);
+    }
+    if(++sink_count == sink_target) {
+      process_poll(&test_process);
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(network_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == ping_event);
+    events_before_ping = sink_count;
+    ping_latency = clock_time() - ping_time;
+    pinged = true;
+    process_poll(&test_process);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+reset_sink(unsigned target, bool is_busy)
+{
+  sink_count = 0;
+  sink_target = target;
+  busy = is_busy;
+  pinged = false;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(latency, "latency under load");
+UNIT_TEST(latency)
+{
+  unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  reset_sink(BURST, true);
+  for(i = 0; i < BURST; i++) {
+    UNIT_TEST_ASSERT(process_post(&sink_process, load_event, NULL)
+                     == PROCESS_ERR_OK);
+  }
+  ping_time = clock_time();
+  UNIT_TEST_ASSERT(process_post(&network_process, ping_event, NULL)
+                   == PROCESS_ERR_OK);
+  PT_YIELD_UNTIL(&unit_test_pt, pinged && sink_count == sink_target);
+
+  printf("%u queued application events, ping dispatched after %u of them, "
+         "latency %lu ms\n",
+         BURST, events_before_ping,
+         (unsigned long)(ping_latency * 1000 / CLOCK_SECOND));
+#if PROCESS_WITH_PRIORITIES
+  UNIT_TEST_ASSERT(events_before_ping == 0);
+#else /* PROCESS_WITH_PRIORITIES */
+  UNIT_TEST_ASSERT(events_before_ping == BURST);
+#endif /* PROCESS_WITH_PRIORITIES */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(overflow, "overflow");
+UNIT_TEST(overflow)
+{
+  unsigned posted;
+
+  UNIT_TEST_BEGIN();
+
+  reset_sink(0, false);
+  process_reset_overflows();
+  UNIT_TEST_ASSERT(process_overflows(PROCESS_PRIORITY_APPLICATION) == 0);
+  for(posted = 0;
+      process_post(&sink_process, load_event, NULL) == PROCESS_ERR_OK;
+      posted++);
+  UNIT_TEST_ASSERT(posted <= PROCESS_CONF_NUMEVENTS);
+  UNIT_TEST_ASSERT(process_overflows(PROCESS_PRIORITY_APPLICATION) == 1);
+
+  /* Network events have their own queue. */
+#if PROCESS_WITH_PRIORITIES
+  UNIT_TEST_ASSERT(process_post(&network_process, ping_event, NULL)
+                   == PROCESS_ERR_OK);
+  UNIT_TEST_ASSERT(process_overflows(PROCESS_PRIORITY_NETWORK) == 0);
+#else /* PROCESS_WITH_PRIORITIES */
+  UNIT_TEST_ASSERT(process_post(&network_process, ping_event, NULL)
+                   == PROCESS_ERR_FULL);
+  UNIT_TEST_ASSERT(process_overflows(PROCESS_PRIORITY_APPLICATION) == 2);
+  pinged = true;
+#endif /* PROCESS_WITH_PRIORITIES */
+
+  sink_target = posted;
+  PT_YIELD_UNTIL(&unit_test_pt, pinged && sink_count == sink_target);
+  process_reset_overflows();
+  UNIT_TEST_ASSERT(process_overflows(PROCESS_PRIORITY_APPLICATION) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "benchmark");
+UNIT_TEST(benchmark)
+{
+  static unsigned posted;
+  static clock_time_t start;
+  unsigned i;
+
+  UNIT_TEST_BEGIN();
+
+  reset_sink(BENCHMARK_BURST, false);
+  start = clock_time();
+  for(posted = 0; posted < BENCHMARK_EVENTS; posted += BENCHMARK_BURST) {
+    sink_count = 0;
+    for(i = 0; i < BENCHMARK_BURST; i++) {
+      process_post(&sink_process, load_event, NULL);
+    }
+    PT_YIELD_UNTIL(&unit_test_pt, sink_count == sink_target);
+  }
+  printf("%u events dispatched in %lu ms (batch size %u)\n",
+         posted,
+         (unsigned long)((clock_time() - start) * 1000 / CLOCK_SECOND),
+         PROCESS_BATCH_SIZE);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  load_event = process_alloc_event();
+  ping_event = process_alloc_event();
+  process_start(&sink_process, NULL);
+  process_start(&network_process, NULL);
+  process_set_priority(&network_process, PROCESS_PRIORITY_NETWORK);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(latency);
+  UNIT_TEST_RUN(overflow);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(latency)
+     || !UNIT_TEST_PASSED(overflow)
+     || !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
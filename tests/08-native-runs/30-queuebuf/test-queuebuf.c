@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "unit-test.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FRAME_LEN 100
+#define IP_PACKET_LEN 1280
+#define FRAGMENT_PAYLOAD_LEN 96
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/*---------------------------------------------------------------------------*/
+static void
+fill_packetbuf(uint16_t len, uint8_t seed)
+{
+  uint16_t i;
+
+  packetbuf_clear();
+  for(i = 0; i < len; i++) {
+    ((uint8_t *)packetbuf_dataptr())[i] = seed + i;
+  }
+  packetbuf_set_datalen(len);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS, 3);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+holds_frame(const uint8_t *data, uint16_t len, uint8_t seed)
+{
+  uint16_t i;
+
+  for(i = 0; i < len; i++) {
+    if(data[i] != (uint8_t)(seed + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(sharing, "sharing");
+UNIT_TEST(sharing)
+{
+  struct queuebuf *upper;
+  struct queuebuf *mac;
+
+  UNIT_TEST_BEGIN();
+
+  fill_packetbuf(FRAME_LEN, 1);
+  upper = queuebuf_new_from_packetbuf();
+  UNIT_TEST_ASSERT(upper != NULL);
+  queuebuf_offer(upper);
+
+  /* Attributes are set per queuebuf, the frame is shared */
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 7);
+  mac = queuebuf_new_from_packetbuf();
+  UNIT_TEST_ASSERT(mac != NULL);
+  UNIT_TEST_ASSERT(queuebuf_dataptr(mac) == queuebuf_dataptr(upper));
+  UNIT_TEST_ASSERT(queuebuf_attr(mac, PACKETBUF_ATTR_MAC_SEQNO) == 7);
+  UNIT_TEST_ASSERT(queuebuf_attr(upper, PACKETBUF_ATTR_MAC_SEQNO) == 0);
+
+  /* The frame outlives the queuebuf that created it */
+  queuebuf_offer(NULL);
+  queuebuf_free(upper);
+  UNIT_TEST_ASSERT(queuebuf_datalen(mac) == FRAME_LEN);
+  UNIT_TEST_ASSERT(holds_frame(queuebuf_dataptr(mac), FRAME_LEN, 1));
+  queuebuf_free(mac);
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(modification, "modification");
+UNIT_TEST(modification)
+{
+  struct queuebuf *upper;
+  struct queuebuf *mac;
+
+  UNIT_TEST_BEGIN();
+
+  fill_packetbuf(FRAME_LEN, 2);
+  upper = queuebuf_new_from_packetbuf();
+  queuebuf_offer(upper);
+  UNIT_TEST_ASSERT(packetbuf_hdralloc(4));
+  mac = queuebuf_new_from_packetbuf();
+  UNIT_TEST_ASSERT(mac != NULL);
+  UNIT_TEST_ASSERT(queuebuf_dataptr(mac) != queuebuf_dataptr(upper));
+  UNIT_TEST_ASSERT(queuebuf_datalen(mac) == FRAME_LEN + 4);
+
+  /* Restoring after a modification copies the frame back */
+  queuebuf_to_packetbuf(upper);
+  UNIT_TEST_ASSERT(packetbuf_hdrlen() == 0);
+  UNIT_TEST_ASSERT(packetbuf_datalen() == FRAME_LEN);
+  UNIT_TEST_ASSERT(holds_frame(packetbuf_dataptr(), FRAME_LEN, 2));
+  queuebuf_offer(NULL);
+  queuebuf_free(upper);
+  queuebuf_free(mac);
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(restore, "restore");
+UNIT_TEST(restore)
+{
+  struct queuebuf *upper;
+  uint32_t copied;
+
+  UNIT_TEST_BEGIN();
+
+  fill_packetbuf(FRAME_LEN, 3);
+  upper = queuebuf_new_from_packetbuf();
+  queuebuf_offer(upper);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 9);
+  copied = queuebuf_copied_bytes;
+  queuebuf_to_packetbuf(upper);
+  UNIT_TEST_ASSERT(queuebuf_copied_bytes == copied);
+  UNIT_TEST_ASSERT(packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO) == 0);
+  UNIT_TEST_ASSERT(packetbuf_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS) == 3);
+  UNIT_TEST_ASSERT(holds_frame(packetbuf_dataptr(), FRAME_LEN, 3));
+
+  /* Once the offer is withdrawn, restoring copies the frame */
+  queuebuf_offer(NULL);
+  queuebuf_to_packetbuf(upper);
+  UNIT_TEST_ASSERT(queuebuf_copied_bytes == copied + FRAME_LEN);
+  queuebuf_free(upper);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+forward_fragmented_packet(bool offer)
+{
+  struct queuebuf *mac[(IP_PACKET_LEN / FRAGMENT_PAYLOAD_LEN) + 1];
+  uint32_t start = queuebuf_copied_bytes;
+  unsigned fragments = 0;
+  uint16_t sent;
+
+  /* Mimics the fragmentation in sicslowpan.c and a queueing MAC layer */
+  for(sent = 0; sent < IP_PACKET_LEN; sent += FRAGMENT_PAYLOAD_LEN) {
+    fill_packetbuf(MIN(FRAGMENT_PAYLOAD_LEN, IP_PACKET_LEN - sent) + 5,
+                   fragments);
+    struct queuebuf *q = queuebuf_new_from_packetbuf();
+    if(offer) {
+      queuebuf_offer(q);
+    }
+    packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, fragments + 1);
+    mac[fragments++] = queuebuf_new_from_packetbuf();
+    queuebuf_to_packetbuf(q);
+    queuebuf_offer(NULL);
+    queuebuf_free(q);
+  }
+
+  /* Transmit each fragment once */
+  while(fragments--) {
+    queuebuf_to_packetbuf(mac[fragments]);
+    packetbuf_hdralloc(9);
+    queuebuf_free(mac[fragments]);
+  }
+  return queuebuf_copied_bytes - start;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(copy_bytes, "copy bytes");
+UNIT_TEST(copy_bytes)
+{
+  uint32_t copying;
+  uint32_t sharing;
+
+  UNIT_TEST_BEGIN();
+
+  copying = forward_fragmented_packet(false);
+  sharing = forward_fragmented_packet(true);
+  printf("bytes copied per forwarded %u-byte packet: %lu without sharing, "
+         "%lu with sharing\n",
+         IP_PACKET_LEN, (unsigned long)copying, (unsigned long)sharing);
+  UNIT_TEST_ASSERT(sharing * 2 == copying);
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(sharing);
+  UNIT_TEST_RUN(modification);
+  UNIT_TEST_RUN(restore);
+  UNIT_TEST_RUN(copy_bytes);
+
+  if(!UNIT_TEST_PASSED(sharing)
+     || !UNIT_TEST_PASSED(modification)
+     || !UNIT_TEST_PASSED(restore)
+     || !UNIT_TEST_PASSED(copy_bytes)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
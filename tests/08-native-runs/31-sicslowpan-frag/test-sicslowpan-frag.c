@@ -0,0 +1,587 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/sicslowpan.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/mac/llsec802154.h"
+#include "net/mac/mac.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "unit-test.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_PAYLOAD 100
+#define MAX_FRAMES 64
+#define MAX_DATAGRAMS 8
+#define DATAGRAM_LEN 320
+/* Security level of injected frames */
+#define SECURITY_LEVEL 5
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+struct frame {
+  linkaddr_t receiver;
+#if LLSEC802154_USES_AUX_HEADER
+  uint8_t security_level;
+#endif /* LLSEC802154_USES_AUX_HEADER */
+  uint16_t len;
+  uint8_t data[MAX_PAYLOAD];
+};
+
+struct datagram {
+  linkaddr_t sender;
+  uint16_t len;
+  uint8_t data[UIP_BUFSIZE];
+  size_t frame_count;
+  struct frame frames[MAX_FRAMES / 2];
+};
+
+static struct frame sent[MAX_FRAMES];
+static size_t sent_count;
+static struct datagram datagrams[MAX_DATAGRAMS];
+static unsigned delivered;
+static unsigned delivered_intact;
+static uint32_t lcg_state = 1;
+
+/*---------------------------------------------------------------------------*/
+static void
+mac_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+mac_send(mac_callback_t sent_callback, void *ptr)
+{
+  if(sent_count < MAX_FRAMES && packetbuf_totlen() <= MAX_PAYLOAD) {
+    linkaddr_copy(&sent[sent_count].receiver,
+                  packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+#if LLSEC802154_USES_AUX_HEADER
+    sent[sent_count].security_level =
+        packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL);
+#endif /* LLSEC802154_USES_AUX_HEADER */
+    sent[sent_count].len = packetbuf_totlen();
+    memcpy(sent[sent_count].data, packetbuf_hdrptr(), packetbuf_totlen());
+    sent_count++;
+  }
+  mac_call_sent_callback(sent_callback, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+mac_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mac_max_payload(void)
+{
+  return MAX_PAYLOAD;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver test_mac_driver = {
+  "test-mac",
+  mac_init,
+  mac_send,
+  mac_input,
+  mac_on,
+  mac_off,
+  mac_max_payload,
+};
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(void)
+{
+  uint8_t index = UIP_IP_BUF->srcipaddr.u8[15];
+
+  delivered++;
+  if(index < MAX_DATAGRAMS
+     && uip_len == datagrams[index].len
+     && !memcmp(uip_buf, datagrams[index].data, uip_len)) {
+    delivered_intact++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+output_callback(int mac_status)
+{
+}
+/*---------------------------------------------------------------------------*/
+NETSTACK_SNIFFER(sniffer, input_callback, output_callback);
+/*---------------------------------------------------------------------------*/
+static uint32_t
+random_next(void)
+{
+  lcg_state = lcg_state * 1103515245 + 12345;
+  return lcg_state >> 16;
+}
+/*---------------------------------------------------------------------------*/
+/* Fragments a UDP datagram from sender index to dest, with extension
+   headers starting with proto, and keeps the fragments as received
+   frames */
+static bool
+generate_with_headers(uint8_t index, const uip_ipaddr_t *dest, uint16_t len,
+                      uint8_t proto, const uint8_t *ext_hdrs,
+                      uint16_t ext_len)
+{
+  struct datagram *d = &datagrams[index];
+  struct uip_udp_hdr *udp = (struct uip_udp_hdr *)UIP_IP_PAYLOAD(ext_len);
+  uint16_t i;
+
+  memset(&d->sender, 0, sizeof(d->sender));
+  d->sender.u8[0] = 0x02;
+  d->sender.u8[LINKADDR_SIZE - 1] = index + 1;
+  d->len = len;
+
+  memset(uip_buf, 0, UIP_IPUDPH_LEN + ext_len);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[0] = (len - UIP_IPH_LEN) >> 8;
+  UIP_IP_BUF->len[1] = (len - UIP_IPH_LEN) & 0xff;
+  UIP_IP_BUF->proto = proto;
+  UIP_IP_BUF->ttl = 64;
+  /* An IID that is not derived from any link-layer address */
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfd00, 0, 0, 0, 0, 0, 0x100, index);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, dest);
+  memcpy(UIP_IP_PAYLOAD(0), ext_hdrs, ext_len);
+  udp->srcport = UIP_HTONS(0x1234);
+  udp->destport = UIP_HTONS(0x4321);
+  udp->udplen = UIP_HTONS(len - UIP_IPH_LEN - ext_len);
+  udp->udpchksum = UIP_HTONS(0xabcd);
+  for(i = UIP_IPUDPH_LEN + ext_len; i < len; i++) {
+    uip_buf[i] = index + i;
+  }
+  memcpy(d->data, uip_buf, len);
+  uip_len = len;
+
+  sent_count = 0;
+  if(!sicslowpan_driver.output(&linkaddr_node_addr)
+     || sent_count > MAX_FRAMES / 2) {
+    return false;
+  }
+  d->frame_count = sent_count;
+  memcpy(d->frames, sent, sent_count * sizeof(sent[0]));
+  sent_count = 0;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+generate(uint8_t index, const uip_ipaddr_t *dest, uint16_t len)
+{
+  return generate_with_headers(index, dest, len, UIP_PROTO_UDP, NULL, 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+inject(const struct frame *f, const linkaddr_t *sender)
+{
+  packetbuf_clear();
+  memcpy(packetbuf_dataptr(), f->data, f->len);
+  packetbuf_set_datalen(f->len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, sender);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+#if LLSEC802154_USES_AUX_HEADER
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL, SECURITY_LEVEL);
+#endif /* LLSEC802154_USES_AUX_HEADER */
+  sicslowpan_driver.input();
+}
+/*---------------------------------------------------------------------------*/
+/* Injects the fragments of the first count datagrams, interleaving the
+   datagrams and shuffling the fragments of each datagram */
+static void
+inject_interleaved(uint8_t count, bool shuffle)
+{
+  size_t order[MAX_DATAGRAMS][MAX_FRAMES / 2];
+  size_t next[MAX_DATAGRAMS] = { 0 };
+  bool pending = true;
+
+  for(uint8_t d = 0; d < count; d++) {
+    size_t n = datagrams[d].frame_count;
+    for(size_t i = 0; i < n; i++) {
+      order[d][i] = i;
+    }
+    for(size_t i = n - 1; shuffle && i > 0; i--) {
+      size_t j = random_next() % (i + 1);
+      size_t tmp = order[d][i];
+      order[d][i] = order[d][j];
+      order[d][j] = tmp;
+    }
+  }
+
+  while(pending) {
+    pending = false;
+    for(uint8_t d = 0; d < count; d++) {
+      if(next[d] < datagrams[d].frame_count) {
+        inject(&datagrams[d].frames[order[d][next[d]++]], &datagrams[d].sender);
+        pending = true;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+await_reassembly_timeout(void)
+{
+  clock_time_t end = clock_time() + CLOCK_SECOND / 8;
+
+  while(clock_time() < end);
+  delivered = delivered_intact = 0;
+}
+/*---------------------------------------------------------------------------*/
+static const uip_ipaddr_t *
+my_address(void)
+{
+  return &uip_ds6_get_global(ADDR_PREFERRED)->ipaddr;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(in_order, "in order");
+UNIT_TEST(in_order)
+{
+  UNIT_TEST_BEGIN();
+
+  await_reassembly_timeout();
+  UNIT_TEST_ASSERT(generate(0, my_address(), UIP_LINK_MTU));
+  UNIT_TEST_ASSERT(datagrams[0].frame_count > 1);
+  inject_interleaved(1, false);
+  UNIT_TEST_ASSERT(delivered == 1);
+  UNIT_TEST_ASSERT(delivered_intact == 1);
+
+  /* Duplicate fragments of a reassembled datagram are not delivered */
+  inject(&datagrams[0].frames[1], &datagrams[0].sender);
+  UNIT_TEST_ASSERT(delivered == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(out_of_order, "out of order");
+UNIT_TEST(out_of_order)
+{
+  size_t i;
+
+  UNIT_TEST_BEGIN();
+
+  await_reassembly_timeout();
+  UNIT_TEST_ASSERT(generate(0, my_address(), UIP_LINK_MTU));
+
+  /* The first fragment arrives last */
+  for(i = datagrams[0].frame_count; i > 0; i--) {
+    inject(&datagrams[0].frames[i - 1], &datagrams[0].sender);
+  }
+  UNIT_TEST_ASSERT(delivered == 1);
+  UNIT_TEST_ASSERT(delivered_intact == 1);
+
+  /* Shuffled */
+  UNIT_TEST_ASSERT(generate(0, my_address(), UIP_LINK_MTU));
+  inject_interleaved(1, true);
+  UNIT_TEST_ASSERT(delivered == 2);
+  UNIT_TEST_ASSERT(delivered_intact == 2);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(concurrent, "concurrent");
+UNIT_TEST(concurrent)
+{
+  UNIT_TEST_BEGIN();
+
+  await_reassembly_timeout();
+  for(uint8_t d = 0; d < 4; d++) {
+    UNIT_TEST_ASSERT(generate(d, my_address(), DATAGRAM_LEN));
+  }
+  inject_interleaved(4, true);
+  UNIT_TEST_ASSERT(delivered == 4);
+  UNIT_TEST_ASSERT(delivered_intact == 4);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(forwarding, "forwarding");
+UNIT_TEST(forwarding)
+{
+  uip_ipaddr_t dest;
+  uip_ipaddr_t router;
+  uip_lladdr_t router_lladdr;
+  uint16_t original_tag;
+  uint16_t forwarded_tag;
+  size_t i;
+
+  UNIT_TEST_BEGIN();
+
+  await_reassembly_timeout();
+
+  /* Off-link destinations are routed via the default router fd00::1 */
+  uip_ip6addr(&router, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+  memset(&router_lladdr, 0, sizeof(router_lladdr));
+  router_lladdr.addr[0] = 0x02;
+  router_lladdr.addr[sizeof(router_lladdr) - 1] = 0xaa;
+  UNIT_TEST_ASSERT(uip_ds6_nbr_add(&router, &router_lladdr, 1,
+                                   NBR_REACHABLE,
+                                   NBR_TABLE_REASON_UNDEFINED, NULL));
+  uip_ip6addr(&dest, 0xfd01, 0, 0, 0, 0, 0, 0, 1);
+
+  UNIT_TEST_ASSERT(generate(0, &dest, UIP_LINK_MTU));
+  original_tag = (datagrams[0].frames[0].data[2] << 8)
+                 | datagrams[0].frames[0].data[3];
+  inject_interleaved(1, false);
+
+#if SICSLOWPAN_CONF_FRAG_FORWARDING
+  /* Each fragment is forwarded right away, without reassembly */
+  UNIT_TEST_ASSERT(delivered == 0);
+  UNIT_TEST_ASSERT(sent_count >= datagrams[0].frame_count);
+  UNIT_TEST_ASSERT((sent[0].data[0] & 0xf8) == SICSLOWPAN_DISPATCH_FRAG1);
+  UNIT_TEST_ASSERT((((sent[0].data[0] & 0x07) << 8) | sent[0].data[1])
+                   == UIP_LINK_MTU);
+  forwarded_tag = (sent[0].data[2] << 8) | sent[0].data[3];
+  UNIT_TEST_ASSERT(forwarded_tag != original_tag);
+  for(i = 0; i < sent_count; i++) {
+    UNIT_TEST_ASSERT(linkaddr_cmp(&sent[i].receiver,
+                                  (linkaddr_t *)&router_lladdr));
+    UNIT_TEST_ASSERT(((sent[i].data[2] << 8) | sent[i].data[3])
+                     == forwarded_tag);
+#if LLSEC802154_USES_AUX_HEADER
+    /* Forwarded fragments are as secure as the received ones */
+    UNIT_TEST_ASSERT(sent[i].security_level == SECURITY_LEVEL);
+#endif /* LLSEC802154_USES_AUX_HEADER */
+  }
+  /* The last fragment is forwarded as is, except for the tag */
+  UNIT_TEST_ASSERT(sent[sent_count - 1].len
+                   == datagrams[0].frames[datagrams[0].frame_count - 1].len);
+  UNIT_TEST_ASSERT(!memcmp(sent[sent_count - 1].data + 4,
+      datagrams[0].frames[datagrams[0].frame_count - 1].data + 4,
+      sent[sent_count - 1].len - 4));
+#else /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+  (void)original_tag;
+  (void)forwarded_tag;
+  (void)i;
+  UNIT_TEST_ASSERT(delivered == 1);
+  UNIT_TEST_ASSERT(delivered_intact == 1);
+#endif /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+  sent_count = 0;
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Checks that the fragments of datagram 0 were all forwarded to the
+   same next hop, or reassembled if fragment forwarding is disabled */
+static bool
+forwarded(void)
+{
+  size_t i;
+
+#if SICSLOWPAN_CONF_FRAG_FORWARDING
+  if(delivered != 0 || sent_count < datagrams[0].frame_count) {
+    return false;
+  }
+  for(i = 1; i < sent_count; i++) {
+    if(!linkaddr_cmp(&sent[i].receiver, &sent[0].receiver)) {
+      return false;
+    }
+  }
+  return true;
+#else /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+  (void)i;
+  return delivered == 1 && delivered_intact == 1;
+#endif /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ext_headers, "extension headers");
+UNIT_TEST(ext_headers)
+{
+  /* A Hop-by-Hop Options header with a PadN option */
+  static const uint8_t padn_hbh[] = {
+    UIP_PROTO_UDP, 0, UIP_EXT_HDR_OPT_PADN, 4, 0, 0, 0, 0
+  };
+  /* A Hop-by-Hop Options header with an RPL option of an unknown
+     RPL instance */
+  static const uint8_t rpl_hbh[] = {
+    UIP_PROTO_UDP, 0, UIP_EXT_HDR_OPT_RPL, 4, 0, 0x1e, 0x01, 0x00
+  };
+  /* A source routing header with the remaining hop fd01::1 */
+  static const uint8_t srh[] = {
+    UIP_PROTO_UDP, 2, 3, 1, 0x00, 0, 0, 0,
+    0xfd, 0x01, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1
+  };
+  uip_ipaddr_t dest;
+
+  UNIT_TEST_BEGIN();
+
+  await_reassembly_timeout();
+  uip_ip6addr(&dest, 0xfd01, 0, 0, 0, 0, 0, 0, 1);
+
+  UNIT_TEST_ASSERT(generate_with_headers(0, &dest, UIP_LINK_MTU,
+                                         UIP_PROTO_HBHO,
+                                         padn_hbh, sizeof(padn_hbh)));
+  inject_interleaved(1, false);
+  UNIT_TEST_ASSERT(forwarded());
+  sent_count = 0;
+
+  /* We are the current destination of a source-routed datagram */
+  await_reassembly_timeout();
+  UNIT_TEST_ASSERT(generate_with_headers(0, my_address(), UIP_LINK_MTU,
+                                         UIP_PROTO_ROUTING,
+                                         srh, sizeof(srh)));
+  inject_interleaved(1, false);
+  UNIT_TEST_ASSERT(forwarded());
+  sent_count = 0;
+
+  /* The routing protocol rejects the RPL option, so the datagram is
+     dropped instead of forwarded */
+  await_reassembly_timeout();
+  UNIT_TEST_ASSERT(generate_with_headers(0, &dest, UIP_LINK_MTU,
+                                         UIP_PROTO_HBHO,
+                                         rpl_hbh, sizeof(rpl_hbh)));
+  inject_interleaved(1, false);
+#if SICSLOWPAN_CONF_FRAG_FORWARDING
+  UNIT_TEST_ASSERT(delivered == 0);
+  UNIT_TEST_ASSERT(sent_count == 0);
+#else /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+  UNIT_TEST_ASSERT(delivered == 1);
+#endif /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+  sent_count = 0;
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(duplicates, "duplicates");
+UNIT_TEST(duplicates)
+{
+  uip_ipaddr_t dest;
+  size_t expected_count;
+  size_t i;
+
+  UNIT_TEST_BEGIN();
+
+  await_reassembly_timeout();
+  uip_ip6addr(&dest, 0xfd01, 0, 0, 0, 0, 0, 0, 1);
+  UNIT_TEST_ASSERT(generate(0, &dest, UIP_LINK_MTU));
+  UNIT_TEST_ASSERT(datagrams[0].frame_count > 2);
+  inject_interleaved(1, false);
+  UNIT_TEST_ASSERT(forwarded());
+  expected_count = sent_count;
+  sent_count = 0;
+
+  /* Retransmitted fragments are neither forwarded again nor complete
+     the datagram early */
+  await_reassembly_timeout();
+  UNIT_TEST_ASSERT(generate(0, &dest, UIP_LINK_MTU));
+  for(i = 0; i < datagrams[0].frame_count; i++) {
+    inject(&datagrams[0].frames[i], &datagrams[0].sender);
+    if(i + 1 < datagrams[0].frame_count) {
+      inject(&datagrams[0].frames[i], &datagrams[0].sender);
+    }
+  }
+  UNIT_TEST_ASSERT(forwarded());
+#if SICSLOWPAN_CONF_FRAG_FORWARDING
+  UNIT_TEST_ASSERT(sent_count == expected_count);
+  UNIT_TEST_ASSERT(sent[sent_count - 1].len
+                   == datagrams[0].frames[datagrams[0].frame_count - 1].len);
+#else /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+  (void)expected_count;
+#endif /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+  sent_count = 0;
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(delivery_ratio, "delivery ratio");
+UNIT_TEST(delivery_ratio)
+{
+  unsigned total_sent = 0;
+  unsigned total_delivered = 0;
+
+  UNIT_TEST_BEGIN();
+
+  printf("reassembly buffers: %zu bytes\n", sicslowpan_frag_store_size());
+  for(uint8_t count = 1; count <= MAX_DATAGRAMS; count++) {
+    await_reassembly_timeout();
+    for(uint8_t d = 0; d < count; d++) {
+      UNIT_TEST_ASSERT(generate(d, my_address(), DATAGRAM_LEN));
+    }
+    inject_interleaved(count, true);
+    UNIT_TEST_ASSERT(delivered == delivered_intact);
+    printf("%u concurrent %u-byte datagrams: %u delivered\n",
+           count, DATAGRAM_LEN, delivered);
+    total_sent += count;
+    total_delivered += delivered;
+  }
+  printf("delivery ratio: %u/%u\n", total_delivered, total_sent);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  /* The native platform uses the tun6 network driver */
+  sicslowpan_driver.init();
+  netstack_sniffer_add(&sniffer);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(in_order);
+  UNIT_TEST_RUN(out_of_order);
+  UNIT_TEST_RUN(concurrent);
+  UNIT_TEST_RUN(forwarding);
+  UNIT_TEST_RUN(ext_headers);
+  UNIT_TEST_RUN(duplicates);
+  UNIT_TEST_RUN(delivery_ratio);
+
+  if(!UNIT_TEST_PASSED(in_order)
+     || !UNIT_TEST_PASSED(out_of_order)
+     || !UNIT_TEST_PASSED(concurrent)
+     || !UNIT_TEST_PASSED(forwarding)
+     || !UNIT_TEST_PASSED(ext_headers)
+     || !UNIT_TEST_PASSED(duplicates)
+     || !UNIT_TEST_PASSED(delivery_ratio)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
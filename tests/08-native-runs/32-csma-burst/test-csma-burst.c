@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "dev/nullradio.h"
+#include "dev/radio.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "unit-test.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PAYLOAD_LEN 60
+#define MAX_FRAMES 64
+#define THROUGHPUT_PACKETS 300
+#define FRAME_PENDING_BIT (1 << 4)
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+struct frame {
+  linkaddr_t receiver;
+  uint8_t id;
+  bool pending;
+};
+
+static struct frame frames[MAX_FRAMES];
+static size_t frame_count;
+static uint8_t prepared_fcf;
+static unsigned sent_count;
+static unsigned sent_ok;
+static unsigned sent_target;
+static linkaddr_t parent = { { 0x02, 0, 0, 0, 0, 0, 0, 0x01 } };
+static linkaddr_t sibling = { { 0x02, 0, 0, 0, 0, 0, 0, 0x02 } };
+
+/*---------------------------------------------------------------------------*/
+static int
+radio_init(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_prepare(const void *payload, unsigned short payload_len)
+{
+  prepared_fcf = ((const uint8_t *)payload)[0];
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_transmit(unsigned short transmit_len)
+{
+  if(frame_count < MAX_FRAMES) {
+    linkaddr_copy(&frames[frame_count].receiver,
+                  packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+    frames[frame_count].id = ((uint8_t *)packetbuf_dataptr())[0];
+    frames[frame_count].pending = prepared_fcf & FRAME_PENDING_BIT;
+    frame_count++;
+  }
+  return RADIO_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_send(const void *payload, unsigned short payload_len)
+{
+  radio_prepare(payload, payload_len);
+  return radio_transmit(payload_len);
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_read(void *buf, unsigned short buf_len)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+channel_clear(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+receiving_packet(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+pending_packet(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_value(radio_param_t param, radio_value_t *value)
+{
+  switch(param) {
+  case RADIO_CONST_MAX_PAYLOAD_LEN:
+    *value = 125;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_RX_MODE:
+    *value = 0;
+    return RADIO_RESULT_OK;
+  default:
+    return RADIO_RESULT_NOT_SUPPORTED;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_value(radio_param_t param, radio_value_t value)
+{
+  return param == RADIO_PARAM_RX_MODE
+         ? RADIO_RESULT_OK
+         : RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_object(radio_param_t param, void *dest, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_object(radio_param_t param, const void *src, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+const struct radio_driver test_radio_driver = {
+  radio_init,
+  radio_prepare,
+  radio_transmit,
+  radio_send,
+  radio_read,
+  channel_clear,
+  receiving_packet,
+  pending_packet,
+  radio_on,
+  radio_off,
+  get_value,
+  set_value,
+  get_object,
+  set_object,
+  nullradio_async_enter,
+  nullradio_async_prepare,
+  nullradio_async_reprepare,
+  nullradio_async_transmit,
+  nullradio_async_on,
+  nullradio_async_off,
+  nullradio_async_set_shr_callback,
+  nullradio_async_set_fifop_callback,
+  nullradio_async_set_rxoverf_callback,
+  nullradio_async_set_txdone_callback,
+  nullradio_async_read_phy_header,
+  nullradio_async_read_payload,
+  nullradio_async_read_payload_bytes,
+  nullradio_async_prepare_sequence,
+  nullradio_async_append_to_sequence,
+  nullradio_async_transmit_sequence,
+  nullradio_async_finish_sequence
+};
+/*---------------------------------------------------------------------------*/
+static void
+packet_sent(void *ptr, int status, int transmissions)
+{
+  sent_count++;
+  if(status == MAC_TX_OK) {
+    sent_ok++;
+  }
+  if(sent_count == sent_target) {
+    process_poll(&test_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+send(const linkaddr_t *receiver, uint8_t id)
+{
+  packetbuf_clear();
+  memset(packetbuf_dataptr(), id, PAYLOAD_LEN);
+  packetbuf_set_datalen(PAYLOAD_LEN);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, receiver);
+  NETSTACK_MAC.send(packet_sent, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+reset(unsigned target)
+{
+  frame_count = 0;
+  sent_count = 0;
+  sent_ok = 0;
+  sent_target = target;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(burst, "burst");
+UNIT_TEST(burst)
+{
+  uint8_t i;
+
+  UNIT_TEST_BEGIN();
+
+  reset(QUEUEBUF_NUM - 1);
+  for(i = 0; i < sent_target; i++) {
+    send(&parent, i);
+  }
+  PT_YIELD_UNTIL(&unit_test_pt, sent_count == sent_target);
+
+  UNIT_TEST_ASSERT(sent_ok == sent_target);
+  UNIT_TEST_ASSERT(frame_count == sent_target);
+  for(i = 0; i < frame_count; i++) {
+    UNIT_TEST_ASSERT(frames[i].id == i);
+    /* All but the last frame of each burst announce the next frame */
+    UNIT_TEST_ASSERT(frames[i].pending
+                     == ((i + 1) % CSMA_CONF_BURST_LENGTH
+                         && i + 1 < frame_count));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(fairness, "fairness");
+UNIT_TEST(fairness)
+{
+  unsigned run = 1;
+  uint8_t i;
+
+  UNIT_TEST_BEGIN();
+
+  reset(QUEUEBUF_NUM - 2);
+  for(i = 0; i < sent_target / 2; i++) {
+    send(&parent, i);
+    send(&sibling, i);
+  }
+  PT_YIELD_UNTIL(&unit_test_pt, sent_count == sent_target);
+
+  UNIT_TEST_ASSERT(sent_ok == sent_target);
+  UNIT_TEST_ASSERT(frame_count == sent_target);
+  for(i = 1; i < frame_count; i++) {
+    if(frames[i - 1].pending) {
+      /* A burst is not interrupted by the other neighbor */
+      UNIT_TEST_ASSERT(linkaddr_cmp(&frames[i].receiver,
+                                    &frames[i - 1].receiver));
+      run++;
+    } else {
+      run = 1;
+    }
+    UNIT_TEST_ASSERT(run <= CSMA_CONF_BURST_LENGTH);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(throughput, "throughput");
+UNIT_TEST(throughput)
+{
+  static unsigned sent_total;
+  static clock_time_t start;
+  clock_time_t duration;
+  uint8_t i;
+
+  UNIT_TEST_BEGIN();
+
+  start = clock_time();
+  for(sent_total = 0; sent_total < THROUGHPUT_PACKETS;
+      sent_total += sent_target) {
+    reset(QUEUEBUF_NUM - 1);
+    for(i = 0; i < sent_target; i++) {
+      send(&parent, i);
+    }
+    PT_YIELD_UNTIL(&unit_test_pt, sent_count == sent_target);
+    UNIT_TEST_ASSERT(sent_ok == sent_target);
+  }
+  duration = clock_time() - start;
+  printf("%u packets to one parent in %lu ms (burst length %u)\n",
+         sent_total,
+         (unsigned long)(duration * 1000 / CLOCK_SECOND),
+         CSMA_CONF_BURST_LENGTH);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(burst);
+  UNIT_TEST_RUN(fairness);
+  UNIT_TEST_RUN(throughput);
+
+  if(!UNIT_TEST_PASSED(burst)
+     || !UNIT_TEST_PASSED(fairness)
+     || !UNIT_TEST_PASSED(throughput)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
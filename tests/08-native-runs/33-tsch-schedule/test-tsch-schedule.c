@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "net/mac/tsch/tsch.h"
+#include "unit-test.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define BENCHMARK_LOOKUPS 1000000
+#define LARGE_SLOTFRAME_LENGTH 397
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Stand-ins for the parts of TSCH that the schedule depends on */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff, 0xff } };
+struct tsch_link *current_link;
+static int locked;
+
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return locked;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  if(locked) {
+    return 0;
+  }
+  locked = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+  locked = 0;
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_add_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_get_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Walks all links like the list-based lookup. All queues are empty, so
+ * overlapping links of the same slotframe resolve to the first one */
+static struct tsch_link *
+reference_lookup(struct tsch_asn_t *asn, uint16_t *time_offset,
+                 struct tsch_link **backup_link)
+{
+  uint16_t time_to_best = 0;
+  struct tsch_link *best = NULL;
+  struct tsch_link *backup = NULL;
+  struct tsch_slotframe *sf;
+
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+    struct tsch_link *l;
+    for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+      uint16_t time_to_timeslot = l->timeslot > timeslot
+          ? l->timeslot - timeslot
+          : sf->size.val + l->timeslot - timeslot;
+      if(best == NULL || time_to_timeslot < time_to_best) {
+        time_to_best = time_to_timeslot;
+        best = l;
+        backup = NULL;
+      } else if(time_to_timeslot == time_to_best) {
+        struct tsch_link *new_best = NULL;
+        if((best->link_options & LINK_OPTION_TX)
+           == (l->link_options & LINK_OPTION_TX)) {
+          if(l->slotframe_handle == best->slotframe_handle) {
+            new_best = best;
+          } else if(l->slotframe_handle < best->slotframe_handle) {
+            new_best = l;
+          }
+        } else if(l->link_options & LINK_OPTION_TX) {
+          new_best = l;
+        }
+        if(new_best != l && (l->link_options & LINK_OPTION_RX)) {
+          if(backup == NULL || l->slotframe_handle < backup->slotframe_handle) {
+            backup = l;
+          }
+        }
+        if(new_best != best && (best->link_options & LINK_OPTION_RX)) {
+          if(backup == NULL
+             || best->slotframe_handle < backup->slotframe_handle) {
+            backup = best;
+          }
+        }
+        if(new_best != NULL) {
+          best = new_best;
+        }
+      }
+    }
+  }
+  *time_offset = time_to_best;
+  *backup_link = backup;
+  return best;
+}
+/*---------------------------------------------------------------------------*/
+static int
+lookup_matches(struct tsch_asn_t *asn)
+{
+  uint16_t time_offset;
+  uint16_t expected_time_offset;
+  struct tsch_link *backup;
+  struct tsch_link *expected_backup;
+  struct tsch_link *l;
+
+  l = tsch_schedule_get_next_active_link(asn, &time_offset, &backup);
+  return l == reference_lookup(asn, &expected_time_offset, &expected_backup)
+         && time_offset == expected_time_offset
+         && backup == expected_backup;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+random_link_options(void)
+{
+  static const uint8_t options[] = {
+    LINK_OPTION_TX,
+    LINK_OPTION_RX,
+    LINK_OPTION_TX | LINK_OPTION_RX | LINK_OPTION_SHARED,
+  };
+  return options[random_rand() % sizeof(options)];
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_slotframe *
+add_large_slotframe(void)
+{
+  struct tsch_slotframe *sf;
+
+  tsch_schedule_create_minimal();
+  sf = tsch_schedule_add_slotframe(1, LARGE_SLOTFRAME_LENGTH);
+  return sf;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(wrap_around, "wrap around");
+UNIT_TEST(wrap_around)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_asn_t asn;
+  uint16_t time_offset;
+  struct tsch_link *backup;
+  struct tsch_link *l;
+  struct tsch_link *l2;
+
+  UNIT_TEST_BEGIN();
+
+  tsch_schedule_remove_all_slotframes();
+  sf = tsch_schedule_add_slotframe(0, 10);
+  UNIT_TEST_ASSERT(sf != NULL);
+  TSCH_ASN_INIT(asn, 0, 0);
+  UNIT_TEST_ASSERT(!tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                                       NULL));
+
+  l = tsch_schedule_add_link(sf, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                             NULL, 3, 0, 1);
+  UNIT_TEST_ASSERT(l != NULL);
+  /* From before, at, and after the link's timeslot */
+  TSCH_ASN_INIT(asn, 0, 1);
+  UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                                      NULL) == l);
+  UNIT_TEST_ASSERT(time_offset == 2);
+  TSCH_ASN_INIT(asn, 0, 3);
+  UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                                      NULL) == l);
+  UNIT_TEST_ASSERT(time_offset == 10);
+  TSCH_ASN_INIT(asn, 0, 9);
+  UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                                      NULL) == l);
+  UNIT_TEST_ASSERT(time_offset == 4);
+
+  /* A Tx link in the same timeslot wins and leaves the Rx link as backup */
+  l2 = tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                              NULL, 3, 1, 0);
+  UNIT_TEST_ASSERT(l2 != NULL);
+  UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                                      &backup) == l2);
+  UNIT_TEST_ASSERT(backup == l);
+
+  /* The timeslot stays occupied until its last link is gone */
+  UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf, l2));
+  UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                                      &backup) == l);
+  UNIT_TEST_ASSERT(backup == NULL);
+  UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf, l));
+  UNIT_TEST_ASSERT(!tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                                       NULL));
+  UNIT_TEST_ASSERT(tsch_schedule_remove_slotframe(sf));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(random_schedule, "random schedule");
+UNIT_TEST(random_schedule)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_slotframe *sf2;
+  struct tsch_asn_t asn;
+  uint32_t i;
+  uint8_t round;
+
+  UNIT_TEST_BEGIN();
+
+  random_init();
+  sf = add_large_slotframe();
+  sf2 = tsch_schedule_add_slotframe(2, 31);
+  UNIT_TEST_ASSERT(sf != NULL && sf2 != NULL);
+
+  for(round = 0; round < 8; round++) {
+    /* Add links with overlapping timeslots, then remove some at random */
+    for(i = 0; i < 30; i++) {
+      tsch_schedule_add_link(sf, random_link_options(), LINK_TYPE_NORMAL,
+                             NULL, random_rand() % LARGE_SLOTFRAME_LENGTH,
+                             random_rand() % 16, random_rand() % 2);
+      tsch_schedule_add_link(sf2, random_link_options(), LINK_TYPE_NORMAL,
+                             NULL, random_rand() % 31,
+                             random_rand() % 16, random_rand() % 2);
+    }
+    for(i = 0; i < 20; i++) {
+      struct tsch_slotframe *victim = i % 2 ? sf : sf2;
+      struct tsch_link *l = list_head(victim->links_list);
+      uint16_t skip = random_rand() % 8;
+      while(l != NULL && list_item_next(l) != NULL && skip--) {
+        l = list_item_next(l);
+      }
+      tsch_schedule_remove_link(victim, l);
+    }
+
+    TSCH_ASN_INIT(asn, round, random_rand());
+    for(i = 0; i < 2 * LARGE_SLOTFRAME_LENGTH; i++) {
+      UNIT_TEST_ASSERT(lookup_matches(&asn));
+      TSCH_ASN_INC(asn, 1);
+    }
+    for(i = 0; i < 1000; i++) {
+      TSCH_ASN_INIT(asn, random_rand() % 256,
+                    ((uint32_t)random_rand() << 16) | random_rand());
+      UNIT_TEST_ASSERT(lookup_matches(&asn));
+    }
+  }
+  UNIT_TEST_ASSERT(tsch_schedule_remove_all_slotframes());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "benchmark");
+UNIT_TEST(benchmark)
+{
+  static const uint16_t sizes[] = { 8, 64, 256 };
+  size_t i;
+  uint32_t j;
+  struct tsch_slotframe *sf;
+  struct tsch_asn_t asn;
+  uint16_t time_offset;
+  clock_time_t start;
+  clock_time_t duration;
+  uint32_t found;
+
+  UNIT_TEST_BEGIN();
+
+  printf("Bitmap: %s\n", TSCH_SCHEDULE_WITH_BITMAP ? "yes" : "no");
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    sf = add_large_slotframe();
+    UNIT_TEST_ASSERT(sf != NULL);
+    for(j = 0; j < sizes[i]; j++) {
+      UNIT_TEST_ASSERT(tsch_schedule_add_link(sf, LINK_OPTION_TX,
+                                              LINK_TYPE_NORMAL, NULL,
+                                              j * LARGE_SLOTFRAME_LENGTH
+                                              / sizes[i],
+                                              0, 1));
+    }
+    found = 0;
+    TSCH_ASN_INIT(asn, 0, 0);
+    start = clock_time();
+    for(j = 0; j < BENCHMARK_LOOKUPS; j++) {
+      found += tsch_schedule_get_next_active_link(&asn, &time_offset,
+                                                  NULL) != NULL;
+      TSCH_ASN_INC(asn, time_offset);
+    }
+    duration = clock_time() - start;
+    UNIT_TEST_ASSERT(found == BENCHMARK_LOOKUPS);
+    printf("%u links: %lu ns per lookup\n",
+           sizes[i] + 1,
+           (unsigned long)((uint64_t)duration
+                           * (1000000000 / CLOCK_SECOND)
+                           / BENCHMARK_LOOKUPS));
+  }
+  UNIT_TEST_ASSERT(tsch_schedule_remove_all_slotframes());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  tsch_schedule_init();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(wrap_around);
+  UNIT_TEST_RUN(random_schedule);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(wrap_around)
+     || !UNIT_TEST_PASSED(random_schedule)
+     || !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/mac/tsch/tsch.h"
+#include "unit-test.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define BENCHMARK_LOOKUPS 1000000
+#define IDLE_NEIGHBORS 48
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Stand-ins for the parts of TSCH that the queues depend on */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff, 0xff } };
+const linkaddr_t tsch_eb_address = { { 0, 0, 0, 0, 0, 0, 0, 0 } };
+int tsch_is_coordinator;
+static int locked;
+
+/* A shared Tx link to the broadcast address */
+static struct tsch_link shared_link = {
+  .link_options = LINK_OPTION_TX | LINK_OPTION_SHARED,
+  .timeslot = 0xffff,
+};
+
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return locked;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  if(locked) {
+    return 0;
+  }
+  locked = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+  locked = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_lladdr(linkaddr_t *lladdr, uint8_t id)
+{
+  linkaddr_copy(lladdr, &linkaddr_null);
+  lladdr->u8[0] = 0x02;
+  lladdr->u8[LINKADDR_SIZE - 1] = id;
+}
+/*---------------------------------------------------------------------------*/
+static int
+enqueue(uint8_t id, uint8_t count)
+{
+  linkaddr_t lladdr;
+
+  make_lladdr(&lladdr, id);
+  while(count--) {
+    packetbuf_clear();
+    packetbuf_set_datalen(1);
+    if(!tsch_queue_add_packet(&lladdr, 1, NULL, NULL)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Sends one packet over the shared link, returns the id of its receiver */
+static int
+send_one(void)
+{
+  struct tsch_neighbor *n = NULL;
+  struct tsch_packet *p;
+  int id;
+
+  p = tsch_queue_get_unicast_packet_for_any(&n, &shared_link);
+  if(p == NULL) {
+    return -1;
+  }
+  id = tsch_queue_get_nbr_address(n)->u8[LINKADDR_SIZE - 1];
+  tsch_queue_packet_sent(n, p, &shared_link, MAC_TX_OK);
+  tsch_queue_free_packet(p);
+  return id;
+}
+/*---------------------------------------------------------------------------*/
+/* Sends until all queues are empty and compares the receivers */
+static int
+send_all(const char *expected)
+{
+  int id;
+
+  while((id = send_one()) != -1) {
+    if(*expected++ != '0' + id) {
+      return 0;
+    }
+  }
+  return *expected == '\0';
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(round_robin, "round robin");
+UNIT_TEST(round_robin)
+{
+#if TSCH_QUEUE_WITH_READY_LIST
+  linkaddr_t lladdr;
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(enqueue(1, 8));
+  UNIT_TEST_ASSERT(enqueue(2, 2));
+  UNIT_TEST_ASSERT(enqueue(3, 2));
+#if TSCH_QUEUE_WITH_READY_LIST
+  /* The heavy flow to 1 does not hold back 2 and 3 */
+  UNIT_TEST_ASSERT(send_all("123123111111"));
+
+  /* Weighted turns */
+  make_lladdr(&lladdr, 1);
+  tsch_queue_set_nbr_quantum(tsch_queue_get_nbr(&lladdr), 3);
+  UNIT_TEST_ASSERT(enqueue(1, 8));
+  UNIT_TEST_ASSERT(enqueue(2, 2));
+  UNIT_TEST_ASSERT(enqueue(3, 2));
+  UNIT_TEST_ASSERT(send_all("111231112311"));
+  UNIT_TEST_ASSERT(send_one() == -1);
+#else /* TSCH_QUEUE_WITH_READY_LIST */
+  /* Neighbor table order */
+  UNIT_TEST_ASSERT(send_all("111111112233"));
+#endif /* TSCH_QUEUE_WITH_READY_LIST */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(backoff, "backoff");
+UNIT_TEST(backoff)
+{
+  linkaddr_t lladdr;
+  struct tsch_neighbor *n;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(enqueue(1, 1));
+  UNIT_TEST_ASSERT(enqueue(2, 1));
+  make_lladdr(&lladdr, 1);
+  n = tsch_queue_get_nbr(&lladdr);
+  UNIT_TEST_ASSERT(n != NULL);
+
+  /* A neighbor in backoff is skipped until its window expires */
+  n->backoff_window = 1;
+  UNIT_TEST_ASSERT(send_one() == 2);
+  UNIT_TEST_ASSERT(send_one() == -1);
+  tsch_queue_update_all_backoff_windows(&tsch_broadcast_address);
+  UNIT_TEST_ASSERT(send_one() == 1);
+  UNIT_TEST_ASSERT(send_one() == -1);
+
+  /* Flushed and removed neighbors leave nothing behind */
+  UNIT_TEST_ASSERT(enqueue(3, 2));
+  make_lladdr(&lladdr, 3);
+  tsch_queue_free_packets_to(&lladdr);
+  UNIT_TEST_ASSERT(send_one() == -1);
+  UNIT_TEST_ASSERT(enqueue(4, 1));
+  tsch_queue_free_unused_neighbors();
+  UNIT_TEST_ASSERT(send_one() == 4);
+  UNIT_TEST_ASSERT(send_one() == -1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(delay, "queueing delay");
+UNIT_TEST(delay)
+{
+  linkaddr_t lladdr;
+  struct tsch_neighbor *n;
+  const struct tsch_queue_delay_stats *stats;
+  clock_time_t start;
+
+  UNIT_TEST_BEGIN();
+
+  make_lladdr(&lladdr, 5);
+  n = tsch_queue_add_nbr(&lladdr);
+  tsch_queue_reset_nbr_delay_stats(n);
+  UNIT_TEST_ASSERT(enqueue(5, 2));
+  start = clock_time();
+  while(clock_time() - start < 10);
+  UNIT_TEST_ASSERT(send_one() == 5);
+  UNIT_TEST_ASSERT(send_one() == 5);
+
+  stats = tsch_queue_get_nbr_delay_stats(n);
+  UNIT_TEST_ASSERT(stats->count == 2);
+  UNIT_TEST_ASSERT(stats->max >= 10);
+  UNIT_TEST_ASSERT(stats->total >= 20);
+  UNIT_TEST_ASSERT(stats->total <= 2 * stats->max);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "benchmark");
+UNIT_TEST(benchmark)
+{
+  uint8_t id;
+  uint32_t j;
+  struct tsch_neighbor *n;
+  clock_time_t start;
+  clock_time_t duration;
+  uint32_t found;
+
+  UNIT_TEST_BEGIN();
+
+  /* Many neighbors that had traffic, only the last one still has */
+  for(id = 1; id <= IDLE_NEIGHBORS; id++) {
+    UNIT_TEST_ASSERT(enqueue(id, 1));
+    UNIT_TEST_ASSERT(send_one() == id);
+  }
+  UNIT_TEST_ASSERT(enqueue(IDLE_NEIGHBORS + 1, 1));
+
+  printf("Ready list: %s\n", TSCH_QUEUE_WITH_READY_LIST ? "yes" : "no");
+  found = 0;
+  start = clock_time();
+  for(j = 0; j < BENCHMARK_LOOKUPS; j++) {
+    found += tsch_queue_get_unicast_packet_for_any(&n, &shared_link) != NULL;
+  }
+  duration = clock_time() - start;
+  UNIT_TEST_ASSERT(found == BENCHMARK_LOOKUPS);
+  printf("%u neighbors: %lu ns per lookup\n",
+         IDLE_NEIGHBORS + 1,
+         (unsigned long)((uint64_t)duration
+                         * (1000000000 / CLOCK_SECOND)
+                         / BENCHMARK_LOOKUPS));
+  UNIT_TEST_ASSERT(send_one() == IDLE_NEIGHBORS + 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  tsch_queue_init();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(round_robin);
+  UNIT_TEST_RUN(backoff);
+  UNIT_TEST_RUN(delay);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(round_robin)
+     || !UNIT_TEST_PASSED(backoff)
+     || !UNIT_TEST_PASSED(delay)
+     || !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/crypto-queue.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NEIGHBORS 50
+#define STORMS 200
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static const uint8_t key[AES_128_KEY_LENGTH] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t nonce[CCM_STAR_NONCE_LENGTH];
+static crypto_queue_job_t jobs[NEIGHBORS];
+static uint8_t blocks[NEIGHBORS][AES_128_BLOCK_SIZE];
+static uint8_t completion_order[NEIGHBORS];
+static size_t completions;
+static uint32_t lock_failures;
+extern const struct aes_128_driver aes_128_driver;
+
+/*---------------------------------------------------------------------------*/
+static bool
+counting_set_key(const uint8_t k[static AES_128_KEY_LENGTH])
+{
+  return aes_128_driver.set_key(k);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+counting_encrypt(uint8_t plaintext_and_result[static AES_128_BLOCK_SIZE])
+{
+  return aes_128_driver.encrypt(plaintext_and_result);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+counting_encrypt_blocks(uint8_t *plaintexts_and_results, size_t count)
+{
+  return aes_128_driver.encrypt_blocks(plaintexts_and_results, count);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+counting_get_lock(void)
+{
+  if(aes_128_driver.get_lock()) {
+    return true;
+  }
+  lock_failures++;
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+const struct aes_128_driver counting_aes_128_driver = {
+  counting_set_key,
+  counting_encrypt,
+  counting_encrypt_blocks,
+  counting_get_lock,
+  aes_128_release_lock
+};
+
+/*---------------------------------------------------------------------------*/
+static void
+on_done(void *opaque, bool successful)
+{
+  if(successful) {
+    completion_order[completions] = (uintptr_t)opaque;
+  }
+  completions++;
+}
+/*---------------------------------------------------------------------------*/
+/* gives the crypto queue and other processes a turn */
+#define YIELD() do { \
+    process_post(&test_process, PROCESS_EVENT_CONTINUE, NULL); \
+    PT_YIELD(&unit_test_pt); \
+} while(0)
+#define YIELD_UNTIL(c) while(!(c)) { \
+    YIELD(); \
+}
+/*---------------------------------------------------------------------------*/
+static void
+derive_inline(uint8_t block[static AES_128_BLOCK_SIZE])
+{
+  while(!AES_128.get_lock());
+  AES_128.set_key(key);
+  AES_128.encrypt(block);
+  AES_128.release_lock();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(results, "results and order");
+UNIT_TEST(results)
+{
+  static uint8_t expected_block[AES_128_BLOCK_SIZE];
+  static uint8_t m[20];
+  static uint8_t expected_m[20];
+  static uint8_t mic[8];
+  static uint8_t expected_mic[8];
+  static uint8_t digest[SHA_256_DIGEST_LENGTH];
+  static uint8_t expected_digest[SHA_256_DIGEST_LENGTH];
+
+  UNIT_TEST_BEGIN();
+
+  memset(blocks[0], 0xAB, AES_128_BLOCK_SIZE);
+  memcpy(expected_block, blocks[0], AES_128_BLOCK_SIZE);
+  derive_inline(expected_block);
+  memset(m, 0xCD, sizeof(m));
+  memcpy(expected_m, m, sizeof(m));
+  while(!CCM_STAR.get_lock());
+  UNIT_TEST_ASSERT(CCM_STAR.set_key(key)
+                   && CCM_STAR.aead(nonce, expected_m, sizeof(expected_m),
+                                    key, sizeof(key),
+                                    expected_mic, sizeof(expected_mic),
+                                    true));
+  CCM_STAR.release_lock();
+  UNIT_TEST_ASSERT(SHA_256.hash(m, sizeof(m), expected_digest));
+
+  completions = 0;
+  crypto_queue_encrypt(jobs + 0, key, blocks[0], 1, on_done, (void *)0);
+  crypto_queue_aead(jobs + 1, key, nonce, m, sizeof(m), key, sizeof(key),
+                    mic, sizeof(mic), true, on_done, (void *)1);
+  crypto_queue_hash(jobs + 2, m, sizeof(m), digest, on_done, (void *)2);
+  UNIT_TEST_ASSERT(crypto_queue_is_queued(jobs + 2));
+  YIELD_UNTIL(completions == 3);
+
+  UNIT_TEST_ASSERT(!crypto_queue_is_queued(jobs + 2));
+  UNIT_TEST_ASSERT(completion_order[0] == 0);
+  UNIT_TEST_ASSERT(completion_order[1] == 1);
+  UNIT_TEST_ASSERT(completion_order[2] == 2);
+  UNIT_TEST_ASSERT(!memcmp(blocks[0], expected_block, AES_128_BLOCK_SIZE));
+  UNIT_TEST_ASSERT(!memcmp(m, expected_m, sizeof(m)));
+  UNIT_TEST_ASSERT(!memcmp(mic, expected_mic, sizeof(mic)));
+  /* hashed after the encryption */
+  UNIT_TEST_ASSERT(SHA_256.hash(expected_m, sizeof(expected_m),
+                                expected_digest));
+  UNIT_TEST_ASSERT(!memcmp(digest, expected_digest, sizeof(digest)));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(cancel, "cancel");
+UNIT_TEST(cancel)
+{
+  UNIT_TEST_BEGIN();
+
+  completions = 0;
+  for(uintptr_t i = 0; i < 3; i++) {
+    crypto_queue_encrypt(jobs + i, key, blocks[i], 1, on_done, (void *)i);
+  }
+  crypto_queue_cancel(jobs + 1);
+  UNIT_TEST_ASSERT(!crypto_queue_is_queued(jobs + 1));
+  YIELD_UNTIL(completions == 2);
+  UNIT_TEST_ASSERT(completion_order[0] == 0);
+  UNIT_TEST_ASSERT(completion_order[1] == 2);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(locked, "waits for AES-128");
+UNIT_TEST(locked)
+{
+  static uint8_t digest[SHA_256_DIGEST_LENGTH];
+  static uint8_t turns;
+  static clock_time_t start;
+  clock_time_t duration;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(AES_128.get_lock());
+  completions = 0;
+  crypto_queue_encrypt(jobs + 0, key, blocks[0], 1, on_done, (void *)0);
+  crypto_queue_hash(jobs + 1, key, sizeof(key), digest, on_done, (void *)1);
+  for(turns = 0; turns < 10; turns++) {
+    YIELD();
+  }
+  /* FIFO order is kept even though the hash needs no AES-128 */
+  UNIT_TEST_ASSERT(!completions);
+
+  /* retries are paced rather than made on every turn */
+  lock_failures = 0;
+  start = clock_time();
+  YIELD_UNTIL(clock_time() - start >= 10 * CRYPTO_QUEUE_LOCK_BACKOFF);
+  duration = clock_time() - start;
+  printf("TEST: %lu failed attempts to lock AES-128 within %lu ticks\n",
+         (unsigned long)lock_failures, (unsigned long)duration);
+  UNIT_TEST_ASSERT(lock_failures <= duration / CRYPTO_QUEUE_LOCK_BACKOFF + 1);
+  UNIT_TEST_ASSERT(!completions);
+  AES_128.release_lock();
+  YIELD_UNTIL(completions == 2);
+  UNIT_TEST_ASSERT(completion_order[0] == 0);
+  UNIT_TEST_ASSERT(completion_order[1] == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(storm, "HELLO storm");
+UNIT_TEST(storm)
+{
+  static uint8_t expected_blocks[NEIGHBORS][AES_128_BLOCK_SIZE];
+  static uint16_t storm;
+  static uint32_t turns;
+  static clock_time_t start;
+  clock_time_t duration;
+
+  UNIT_TEST_BEGIN();
+
+  /* key derivations for NEIGHBORS HELLOACKs at once, done inline */
+  for(size_t i = 0; i < NEIGHBORS; i++) {
+    for(size_t j = 0; j < AES_128_BLOCK_SIZE; j++) {
+      expected_blocks[i][j] = random_rand();
+    }
+  }
+  start = clock_time();
+  for(storm = 0; storm < STORMS; storm++) {
+    memcpy(blocks, expected_blocks, sizeof(blocks));
+    for(size_t i = 0; i < NEIGHBORS; i++) {
+      derive_inline(blocks[i]);
+    }
+  }
+  duration = clock_time() - start;
+  printf("TEST: inline, %u neighbors: %lu us per storm, 0 turns for others\n",
+         NEIGHBORS,
+         (unsigned long)(duration * (1000000 / CLOCK_SECOND) / STORMS));
+  memcpy(expected_blocks, blocks, sizeof(blocks));
+
+  /* the same via the queue */
+  turns = 0;
+  start = clock_time();
+  for(storm = 0; storm < STORMS; storm++) {
+    memcpy(blocks, expected_blocks, sizeof(blocks));
+    completions = 0;
+    for(uintptr_t i = 0; i < NEIGHBORS; i++) {
+      crypto_queue_encrypt(jobs + i, key, blocks[i], 1, on_done, (void *)i);
+    }
+    while(completions != NEIGHBORS) {
+      /* this is where the MAC layer and others get to run */
+      YIELD();
+      turns++;
+    }
+  }
+  duration = clock_time() - start;
+  printf("TEST: queue, batch size %u, %u neighbors: %lu us per storm, "
+         "%lu turns for others\n",
+         CRYPTO_QUEUE_BATCH_SIZE,
+         NEIGHBORS,
+         (unsigned long)(duration * (1000000 / CLOCK_SECOND) / STORMS),
+         (unsigned long)(turns / STORMS));
+
+  /* each block was encrypted twice by now */
+  for(size_t i = 0; i < NEIGHBORS; i++) {
+    derive_inline(expected_blocks[i]);
+    UNIT_TEST_ASSERT(completion_order[i] == i);
+  }
+  UNIT_TEST_ASSERT(!memcmp(blocks, expected_blocks, sizeof(blocks)));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(results);
+  UNIT_TEST_RUN(cancel);
+  UNIT_TEST_RUN(locked);
+  UNIT_TEST_RUN(storm);
+
+  if(!UNIT_TEST_PASSED(results)
+     || !UNIT_TEST_PASSED(cancel)
+     || !UNIT_TEST_PASSED(locked)
+     || !UNIT_TEST_PASSED(storm)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "contiki.h"
+#include "net/mac/anti-replay.h"
+#include "net/mac/llsec802154.h"
+#include "net/packetbuf.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static const linkaddr_t sender = {{ 0x01 }};
+
+/*---------------------------------------------------------------------------*/
+static void
+prepare(bool broadcast)
+{
+  packetbuf_clear();
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER,
+                     broadcast ? &linkaddr_null : &linkaddr_node_addr);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+receive(struct anti_replay_info *info, bool broadcast, uint32_t counter)
+{
+  frame802154_frame_counter_t reordered_counter = {
+    .u32 = LLSEC802154_HTONL(counter)
+  };
+
+  prepare(broadcast);
+  anti_replay_parse_counter(reordered_counter.u8);
+  return !anti_replay_was_replayed(info);
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+restore(struct anti_replay_info *info, uint8_t lsbs)
+{
+  prepare(false);
+  anti_replay_restore_counter(info, lsbs);
+  return anti_replay_get_counter();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(in_order, "in-order frames");
+UNIT_TEST(in_order)
+{
+  struct anti_replay_info info;
+
+  UNIT_TEST_BEGIN();
+
+  anti_replay_init_info(&info);
+  memset(&anti_replay_stats, 0, sizeof(anti_replay_stats));
+  for(uint32_t i = 1; i <= 10; i++) {
+    UNIT_TEST_ASSERT(receive(&info, false, i));
+  }
+  UNIT_TEST_ASSERT(!receive(&info, false, 10));
+  UNIT_TEST_ASSERT(!receive(&info, false, 0));
+  UNIT_TEST_ASSERT(anti_replay_stats.accepted_in_order == 10);
+  UNIT_TEST_ASSERT(anti_replay_stats.rejected_duplicates
+                   + anti_replay_stats.rejected_stale == 2);
+
+  /* broadcast and unicast frame counters are checked separately */
+  UNIT_TEST_ASSERT(receive(&info, true, 5));
+  UNIT_TEST_ASSERT(!receive(&info, true, 5));
+  UNIT_TEST_ASSERT(receive(&info, false, 11));
+
+  /* frames from before the session are never accepted */
+  anti_replay_init_info(&info);
+  UNIT_TEST_ASSERT(receive(&info, false, 100));
+  UNIT_TEST_ASSERT(!receive(&info, false, 99));
+  anti_replay_reset_broadcast_counter(&info, 50);
+  UNIT_TEST_ASSERT(!receive(&info, true, 49));
+  UNIT_TEST_ASSERT(!receive(&info, true, 50));
+  UNIT_TEST_ASSERT(receive(&info, true, 51));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(out_of_order, "out-of-order frames");
+UNIT_TEST(out_of_order)
+{
+  struct anti_replay_info info;
+
+  UNIT_TEST_BEGIN();
+
+  anti_replay_init_info(&info);
+  memset(&anti_replay_stats, 0, sizeof(anti_replay_stats));
+  UNIT_TEST_ASSERT(receive(&info, false, 1));
+  UNIT_TEST_ASSERT(receive(&info, false, 4));
+#if ANTI_REPLAY_WINDOW_SIZE
+  UNIT_TEST_ASSERT(receive(&info, false, 3));
+  UNIT_TEST_ASSERT(receive(&info, false, 2));
+  UNIT_TEST_ASSERT(!receive(&info, false, 3));
+  UNIT_TEST_ASSERT(!receive(&info, false, 1));
+
+  /* the window follows the last frame counter */
+  UNIT_TEST_ASSERT(receive(&info, false, 4 + ANTI_REPLAY_WINDOW_SIZE));
+  UNIT_TEST_ASSERT(!receive(&info, false, 4));
+  UNIT_TEST_ASSERT(!receive(&info, false, 3));
+  UNIT_TEST_ASSERT(receive(&info, false, 5));
+  UNIT_TEST_ASSERT(!receive(&info, false, 5));
+
+  /* jumping beyond the window forgets about all previous frame counters */
+  UNIT_TEST_ASSERT(receive(&info, false, 1000));
+  UNIT_TEST_ASSERT(receive(&info, false, 1000 - ANTI_REPLAY_WINDOW_SIZE));
+  UNIT_TEST_ASSERT(!receive(&info, false, 999 - ANTI_REPLAY_WINDOW_SIZE));
+
+  UNIT_TEST_ASSERT(anti_replay_stats.accepted_in_order == 4);
+  UNIT_TEST_ASSERT(anti_replay_stats.accepted_out_of_order == 4);
+  UNIT_TEST_ASSERT(anti_replay_stats.rejected_duplicates == 4);
+  UNIT_TEST_ASSERT(anti_replay_stats.rejected_stale == 2);
+#else /* ANTI_REPLAY_WINDOW_SIZE */
+  UNIT_TEST_ASSERT(!receive(&info, false, 3));
+  UNIT_TEST_ASSERT(!receive(&info, false, 2));
+  UNIT_TEST_ASSERT(receive(&info, false, 5));
+
+  UNIT_TEST_ASSERT(anti_replay_stats.accepted_in_order == 3);
+  UNIT_TEST_ASSERT(!anti_replay_stats.accepted_out_of_order);
+  UNIT_TEST_ASSERT(anti_replay_stats.rejected_stale == 2);
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(advancing, "advancing to acknowledged frame counters");
+UNIT_TEST(advancing)
+{
+  struct anti_replay_info info;
+
+  UNIT_TEST_BEGIN();
+
+  anti_replay_init_info(&info);
+  UNIT_TEST_ASSERT(receive(&info, false, 97));
+  UNIT_TEST_ASSERT(receive(&info, false, 99));
+  UNIT_TEST_ASSERT(receive(&info, false, 100));
+
+  /* an acknowledgement frame carried the frame counter 102 */
+  anti_replay_advance_unicast_counter(&info, 102);
+  UNIT_TEST_ASSERT(!receive(&info, false, 102));
+  UNIT_TEST_ASSERT(!receive(&info, false, 100));
+  UNIT_TEST_ASSERT(!receive(&info, false, 99));
+#if ANTI_REPLAY_WINDOW_SIZE
+  UNIT_TEST_ASSERT(receive(&info, false, 101));
+  UNIT_TEST_ASSERT(!receive(&info, false, 101));
+  UNIT_TEST_ASSERT(receive(&info, false, 98));
+#else /* ANTI_REPLAY_WINDOW_SIZE */
+  UNIT_TEST_ASSERT(!receive(&info, false, 101));
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
+
+  /* older acknowledged frame counters change nothing */
+  anti_replay_advance_unicast_counter(&info, 101);
+  UNIT_TEST_ASSERT(!receive(&info, false, 102));
+  UNIT_TEST_ASSERT(receive(&info, false, 103));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(suppression, "restoring suppressed frame counters");
+UNIT_TEST(suppression)
+{
+  struct anti_replay_info info;
+
+  UNIT_TEST_BEGIN();
+
+  anti_replay_init_info(&info);
+  UNIT_TEST_ASSERT(receive(&info, false, 0x1F0));
+  UNIT_TEST_ASSERT(restore(&info, 0xF5) == 0x1F5);
+  UNIT_TEST_ASSERT(restore(&info, 0x05) == 0x205);
+  UNIT_TEST_ASSERT(restore(&info, 0xF0) == 0x1F0);
+  UNIT_TEST_ASSERT(receive(&info, false, 0x205));
+#if ANTI_REPLAY_WINDOW_SIZE
+  UNIT_TEST_ASSERT(restore(&info, 0x01) == 0x201);
+  UNIT_TEST_ASSERT(restore(&info, 0xFF) == 0x1FF);
+  UNIT_TEST_ASSERT(!anti_replay_was_replayed(&info));
+  UNIT_TEST_ASSERT(anti_replay_was_replayed(&info));
+  UNIT_TEST_ASSERT(restore(&info, 0x05 + ANTI_REPLAY_WINDOW_SIZE) ==
+                   0x205 + ANTI_REPLAY_WINDOW_SIZE);
+#else /* ANTI_REPLAY_WINDOW_SIZE */
+  UNIT_TEST_ASSERT(restore(&info, 0x01) == 0x301);
+  UNIT_TEST_ASSERT(restore(&info, 0xFF) == 0x2FF);
+#endif /* ANTI_REPLAY_WINDOW_SIZE */
+  UNIT_TEST_ASSERT(restore(&info, 0x06) == 0x206);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(in_order);
+  UNIT_TEST_RUN(out_of_order);
+  UNIT_TEST_RUN(advancing);
+  UNIT_TEST_RUN(suppression);
+
+  if(!UNIT_TEST_PASSED(in_order)
+     || !UNIT_TEST_PASSED(out_of_order)
+     || !UNIT_TEST_PASSED(advancing)
+     || !UNIT_TEST_PASSED(suppression)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
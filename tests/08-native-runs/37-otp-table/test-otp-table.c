@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/ccm-star.h"
+#include "net/mac/otp-table.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define OTP_LEN (2)
+#define BENCHMARK_ROUNDS (100000)
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static const uint8_t keys[2][AES_128_KEY_LENGTH] = {
+  { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F },
+  { 0x0F, 0x0E, 0x0D, 0x0C, 0x0B, 0x0A, 0x09, 0x08,
+    0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00 },
+};
+static const uint8_t nonce[CCM_STAR_NONCE_LENGTH] = {
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+  0x18, 0x19, 0x1A, 0x1B, 0x1C
+};
+
+/*---------------------------------------------------------------------------*/
+static bool
+compute(uint32_t window, size_t key_index, uint8_t a, uint8_t *otp)
+{
+  return otp_table_compute(window, keys[key_index], nonce, a, otp, OTP_LEN);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+compute_directly(size_t key_index, uint8_t a, uint8_t *otp)
+{
+  return CCM_STAR.set_key(keys[key_index])
+         && CCM_STAR.aead(nonce, NULL, 0, &a, 1, otp, OTP_LEN, false);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(correctness, "OTPs match CCM*");
+UNIT_TEST(correctness)
+{
+  uint8_t otp[OTP_LEN];
+  uint8_t expected_otp[OTP_LEN];
+
+  UNIT_TEST_BEGIN();
+
+  otp_table_flush();
+  for(size_t key_index = 0; key_index < 2; key_index++) {
+    for(uint_fast16_t a = 0; a <= 0xFF; a++) {
+      UNIT_TEST_ASSERT(compute_directly(key_index, a, expected_otp));
+      /* the second call may be served from the table */
+      for(int i = 0; i < 2; i++) {
+        UNIT_TEST_ASSERT(compute(1, key_index, a, otp));
+        UNIT_TEST_ASSERT(otp_table_equals(expected_otp, otp, OTP_LEN));
+      }
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(caching, "caching of OTPs");
+UNIT_TEST(caching)
+{
+  uint8_t otp[OTP_LEN];
+
+  UNIT_TEST_BEGIN();
+
+  otp_table_flush();
+  memset(&otp_table_stats, 0, sizeof(otp_table_stats));
+  UNIT_TEST_ASSERT(compute(1, 0, 10, otp));
+  UNIT_TEST_ASSERT(compute(1, 0, 10, otp));
+  UNIT_TEST_ASSERT(compute(1, 1, 10, otp));
+  UNIT_TEST_ASSERT(compute(1, 0, 11, otp));
+#if OTP_TABLE_SIZE
+  UNIT_TEST_ASSERT(otp_table_stats.hits == 1);
+  UNIT_TEST_ASSERT(otp_table_stats.misses == 3);
+
+  /* OTPs of previous wake ups are discarded */
+  UNIT_TEST_ASSERT(compute(2, 0, 10, otp));
+  UNIT_TEST_ASSERT(otp_table_stats.misses == 4);
+
+  /* the oldest OTP gets evicted */
+  for(uint_fast8_t a = 0; a < OTP_TABLE_SIZE; a++) {
+    UNIT_TEST_ASSERT(compute(3, 0, a, otp));
+  }
+  UNIT_TEST_ASSERT(compute(3, 0, OTP_TABLE_SIZE - 1, otp));
+  UNIT_TEST_ASSERT(otp_table_stats.hits == 2);
+  UNIT_TEST_ASSERT(compute(3, 0, OTP_TABLE_SIZE, otp));
+  UNIT_TEST_ASSERT(compute(3, 0, 0, otp));
+  UNIT_TEST_ASSERT(otp_table_stats.hits == 2);
+#else /* OTP_TABLE_SIZE */
+  UNIT_TEST_ASSERT(!otp_table_stats.hits);
+  UNIT_TEST_ASSERT(otp_table_stats.misses == 4);
+#endif /* OTP_TABLE_SIZE */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(key_reuse, "reuse of key buffers");
+UNIT_TEST(key_reuse)
+{
+  static uint8_t key[AES_128_KEY_LENGTH];
+  uint8_t otp[OTP_LEN];
+  uint8_t expected_otp[OTP_LEN];
+
+  UNIT_TEST_BEGIN();
+
+  otp_table_flush();
+  memset(&otp_table_stats, 0, sizeof(otp_table_stats));
+  memcpy(key, keys[0], sizeof(key));
+  UNIT_TEST_ASSERT(otp_table_compute(1, key, nonce, 10, otp, OTP_LEN));
+
+  /* a new key is installed in the same buffer */
+  memcpy(key, keys[1], sizeof(key));
+  UNIT_TEST_ASSERT(compute_directly(1, 10, expected_otp));
+  UNIT_TEST_ASSERT(CCM_STAR.set_key(keys[0]));
+  UNIT_TEST_ASSERT(otp_table_compute(1, key, nonce, 10, otp, OTP_LEN));
+  UNIT_TEST_ASSERT(otp_table_equals(expected_otp, otp, OTP_LEN));
+  UNIT_TEST_ASSERT(!otp_table_stats.hits);
+
+  /* the same key in another buffer */
+  UNIT_TEST_ASSERT(compute(1, 1, 10, otp));
+  UNIT_TEST_ASSERT(otp_table_equals(expected_otp, otp, OTP_LEN));
+#if OTP_TABLE_SIZE
+  UNIT_TEST_ASSERT(otp_table_stats.hits == 1);
+#endif /* OTP_TABLE_SIZE */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(equality, "comparison of OTPs");
+UNIT_TEST(equality)
+{
+  static const uint8_t otp[] = { 0xAB, 0xCD, 0xEF };
+
+  UNIT_TEST_BEGIN();
+
+  for(size_t i = 0; i < sizeof(otp); i++) {
+    uint8_t received[sizeof(otp)];
+    memcpy(received, otp, sizeof(otp));
+    UNIT_TEST_ASSERT(otp_table_equals(otp, received, sizeof(otp)));
+    received[i] ^= 0x80;
+    UNIT_TEST_ASSERT(!otp_table_equals(otp, received, sizeof(otp)));
+  }
+  UNIT_TEST_ASSERT(otp_table_equals(otp, otp, 0));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "latency of OTP checks");
+UNIT_TEST(benchmark)
+{
+  static const uint8_t received[OTP_LEN];
+  uint8_t otp[OTP_LEN];
+  clock_time_t start;
+  clock_time_t duration;
+  uint32_t rejected;
+
+  UNIT_TEST_BEGIN();
+
+  /* a wake-up frame with an invalid OTP is received over and over */
+  rejected = 0;
+  start = clock_time();
+  for(uint32_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+    UNIT_TEST_ASSERT(compute_directly(0, 50, otp));
+    rejected += !otp_table_equals(otp, received, OTP_LEN);
+  }
+  duration = clock_time() - start;
+  printf("TEST: without table: %lu ns per frame (%lu rejected)\n",
+         (unsigned long)((uint64_t)duration * 1000000000
+                         / CLOCK_SECOND / BENCHMARK_ROUNDS),
+         (unsigned long)rejected);
+
+  otp_table_flush();
+  rejected = 0;
+  start = clock_time();
+  for(uint32_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+    UNIT_TEST_ASSERT(compute(1, 0, 50, otp));
+    rejected += !otp_table_equals(otp, received, OTP_LEN);
+  }
+  duration = clock_time() - start;
+  printf("TEST: with %u-entry table: %lu ns per frame (%lu rejected)\n",
+         OTP_TABLE_SIZE,
+         (unsigned long)((uint64_t)duration * 1000000000
+                         / CLOCK_SECOND / BENCHMARK_ROUNDS),
+         (unsigned long)rejected);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(correctness);
+  UNIT_TEST_RUN(caching);
+  UNIT_TEST_RUN(key_reuse);
+  UNIT_TEST_RUN(equality);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(correctness)
+     || !UNIT_TEST_PASSED(caching)
+     || !UNIT_TEST_PASSED(key_reuse)
+     || !UNIT_TEST_PASSED(equality)
+     || !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
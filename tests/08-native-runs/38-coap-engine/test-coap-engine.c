@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_RESOURCES (1000)
+#define BENCHMARK_ROUNDS (100000)
+#define URL_SIZE (sizeof("bench/65535"))
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static coap_resource_t *last_resource;
+static coap_endpoint_t endpoint;
+static uint16_t mid;
+
+static coap_resource_t bench_resources[MAX_RESOURCES];
+static char bench_urls[MAX_RESOURCES][URL_SIZE];
+
+/*
+ * Each resource records itself as the last one that got a request.
+ */
+#define TEST_RESOURCE(name, flags) \
+  static void handle_##name(coap_message_t *request, \
+                            coap_message_t *response, \
+                            uint8_t *buffer, uint16_t preferred_size, \
+                            int32_t *offset); \
+  flags(name, "", handle_##name, NULL, NULL, NULL); \
+  static void handle_##name(coap_message_t *request, \
+                            coap_message_t *response, \
+                            uint8_t *buffer, uint16_t preferred_size, \
+                            int32_t *offset) \
+  { \
+    last_resource = &name; \
+  }
+TEST_RESOURCE(res_exact, RESOURCE)
+TEST_RESOURCE(res_parent, PARENT_RESOURCE)
+TEST_RESOURCE(res_nested_parent, PARENT_RESOURCE)
+TEST_RESOURCE(res_nested_exact, RESOURCE)
+
+/*---------------------------------------------------------------------------*/
+static void
+handle_bench_get(coap_message_t *request, coap_message_t *response,
+                 uint8_t *buffer, uint16_t preferred_size,
+                 int32_t *offset)
+{
+  last_resource = bench_resources;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+request(coap_message_type_t type, coap_method_t method, const char *path)
+{
+  static coap_message_t message[1];
+  static uint8_t buffer[COAP_MAX_HEADER_SIZE];
+  size_t len;
+
+  coap_init_message(message, type, method, mid++);
+  coap_set_header_uri_path(message, path);
+  len = coap_serialize_message(message, buffer);
+  return len && (coap_receive(&endpoint, buffer, len) == NO_ERROR);
+}
+/*---------------------------------------------------------------------------*/
+static coap_resource_t *
+dispatch(const char *path)
+{
+  last_resource = NULL;
+  if(!request(COAP_TYPE_NON, COAP_GET, path)) {
+    return NULL;
+  }
+  return last_resource;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(matching, "matching of URI paths");
+UNIT_TEST(matching)
+{
+  UNIT_TEST_BEGIN();
+
+  coap_activate_resource(&res_exact, "exact");
+  coap_activate_resource(&res_parent, "parent");
+  coap_activate_resource(&res_nested_parent, "parent/nested");
+  coap_activate_resource(&res_nested_exact, "parent/nested/exact");
+
+  UNIT_TEST_ASSERT(dispatch("exact") == &res_exact);
+  UNIT_TEST_ASSERT(dispatch("exact/sub") == NULL);
+  UNIT_TEST_ASSERT(dispatch("exac") == NULL);
+  UNIT_TEST_ASSERT(dispatch("exactly") == NULL);
+  UNIT_TEST_ASSERT(dispatch("parent") == &res_parent);
+  UNIT_TEST_ASSERT(dispatch("parent/sub") == &res_parent);
+  UNIT_TEST_ASSERT(dispatch("parentsub") == NULL);
+  UNIT_TEST_ASSERT(dispatch("parent/nested") == &res_nested_parent);
+  UNIT_TEST_ASSERT(dispatch("parent/nested/sub") == &res_nested_parent);
+  UNIT_TEST_ASSERT(dispatch("parent/nested/exact") == &res_nested_exact);
+  UNIT_TEST_ASSERT(dispatch("") == NULL);
+  UNIT_TEST_ASSERT(dispatch("unknown") == NULL);
+
+  /* handlers of other methods are not invoked */
+  last_resource = NULL;
+  UNIT_TEST_ASSERT(request(COAP_TYPE_NON, COAP_POST, "exact"));
+  UNIT_TEST_ASSERT(last_resource == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "dispatching of requests");
+UNIT_TEST(benchmark)
+{
+  size_t resources;
+  clock_time_t start;
+  clock_time_t duration;
+
+  UNIT_TEST_BEGIN();
+
+  resources = 0;
+  for(size_t total = 10; total <= MAX_RESOURCES; total *= 10) {
+    for(; resources < total; resources++) {
+      bench_resources[resources].get_handler = handle_bench_get;
+      snprintf(bench_urls[resources], URL_SIZE, "bench/%u",
+               (uint16_t)resources);
+      coap_activate_resource(bench_resources + resources,
+                             bench_urls[resources]);
+    }
+
+    start = clock_time();
+    for(uint32_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+      last_resource = NULL;
+      UNIT_TEST_ASSERT(request(COAP_TYPE_NON, COAP_GET,
+                               bench_urls[i % resources]));
+      UNIT_TEST_ASSERT(last_resource == bench_resources);
+    }
+    duration = clock_time() - start;
+    printf("TEST: %zu resources: %lu ns per request\n",
+           resources,
+           (unsigned long)((uint64_t)duration * 1000000000
+                           / CLOCK_SECOND / BENCHMARK_ROUNDS));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  coap_engine_init();
+  coap_endpoint_parse("coap://[fe80::1]", strlen("coap://[fe80::1]"),
+                      &endpoint);
+  /* let the CoAP engine open its UDP connection */
+  PROCESS_PAUSE();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(matching);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(matching)
+     || !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,3 @@
+#!/bin/sh -e
+
+./run-one.sh 39-coap-cocoa
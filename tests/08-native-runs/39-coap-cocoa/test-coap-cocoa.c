@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * A gateway polls several nodes via a lossy mesh. Each node sits behind a
+ * half-duplex bottleneck with a bounded queue. The client and the server
+ * side of the CoAP engine talk to each other across this simulated network,
+ * which runs in virtual time.
+ */
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "coap-fixture.h"
+#include "coap-callback-api.h"
+#include "coap-timer.h"
+#include "coap-transport.h"
+#include "lib/random.h"
+#include "sys/cc.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NODES (4)
+#define REQUESTS_PER_NODE (100)
+#define PIPELINE_DEPTH (8)
+#define MAX_PACKETS (64)
+#define SERVICE_TIME (20) /* ms per packet */
+#define PROPAGATION_DELAY (30) /* ms */
+#define QUEUE_LIMIT (4) /* packets */
+#define LOSS_PERCENT (5)
+
+/*
+ * Retransmissions with fixed timeouts, which congestion control must not
+ * exceed. The variant without congestion control checks this figure.
+ */
+#define FIXED_TIMEOUT_RETRANSMISSIONS (57)
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+struct packet {
+  uint64_t deliver_at;
+  coap_endpoint_t endpoint;
+  uint16_t len;
+  uint8_t data[COAP_MAX_PACKET_SIZE];
+};
+
+struct node {
+  coap_endpoint_t endpoint;
+  uint64_t busy_until;
+  uint32_t requests;
+  uint16_t outstanding_mids[PIPELINE_DEPTH];
+  size_t outstanding;
+};
+
+struct slot {
+  coap_callback_request_state_t state;
+  coap_message_t request[1];
+  struct node *node;
+};
+
+static struct packet packets[MAX_PACKETS];
+static size_t packet_count;
+static struct node nodes[NODES];
+static struct slot slots[NODES * PIPELINE_DEPTH];
+static uint32_t responses;
+static uint32_t failures;
+static uint32_t drops;
+static size_t max_outstanding;
+static bool has_untracked_messages;
+static uint32_t loss_state = 1;
+
+static void handle_get(coap_message_t *request, coap_message_t *response,
+                       uint8_t *buffer, uint16_t preferred_size,
+                       int32_t *offset);
+RESOURCE(res_test, "", handle_get, NULL, NULL, NULL);
+
+/*---------------------------------------------------------------------------*/
+static struct node *
+get_node(const coap_endpoint_t *ep)
+{
+  for(size_t i = 0; i < NODES; i++) {
+    if(coap_endpoint_cmp(&nodes[i].endpoint, ep)) {
+      return nodes + i;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* losses follow the same xorshift sequence in each run */
+static uint32_t
+get_loss_sample(void)
+{
+  loss_state ^= loss_state << 13;
+  loss_state ^= loss_state >> 17;
+  loss_state ^= loss_state << 5;
+  return loss_state;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * A confirmable message is outstanding from its first transmission until
+ * its transaction is freed, i.e., until it is acknowledged or times out.
+ * Deferred messages only count once they are sent.
+ */
+static void
+track_outstanding(struct node *node, const uint8_t *data, uint16_t len)
+{
+  uint16_t mid;
+  size_t i;
+
+  if((len < 4)
+     || (((data[0] & COAP_HEADER_TYPE_MASK) >> COAP_HEADER_TYPE_POSITION)
+         != COAP_TYPE_CON)) {
+    return;
+  }
+  mid = (data[2] << 8) | data[3];
+
+  for(i = 0; i < node->outstanding;) {
+    if(!coap_get_transaction_by_mid(node->outstanding_mids[i])) {
+      node->outstanding_mids[i] = node->outstanding_mids[--node->outstanding];
+    } else if(node->outstanding_mids[i] == mid) {
+      /* a retransmission */
+      return;
+    } else {
+      i++;
+    }
+  }
+  if(node->outstanding == PIPELINE_DEPTH) {
+    has_untracked_messages = true;
+    return;
+  }
+  node->outstanding_mids[node->outstanding++] = mid;
+  max_outstanding = MAX(max_outstanding, node->outstanding);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Requests to a node and responses from it pass the same bottleneck. On the
+ * receiving side, the packet appears to come from the node either way.
+ */
+int
+coap_sendto(const coap_endpoint_t *ep, const uint8_t *data, uint16_t len)
+{
+  struct node *node = get_node(ep);
+  struct packet *packet;
+
+  if(!node || (len > COAP_MAX_PACKET_SIZE) || (packet_count == MAX_PACKETS)) {
+    return -1;
+  }
+  track_outstanding(node, data, len);
+  if((node->busy_until > virtual_time)
+     && ((node->busy_until - virtual_time) >= QUEUE_LIMIT * SERVICE_TIME)) {
+    drops++;
+    return len;
+  }
+  node->busy_until = MAX(node->busy_until, virtual_time) + SERVICE_TIME;
+  if((get_loss_sample() % 100) < LOSS_PERCENT) {
+    drops++;
+    return len;
+  }
+
+  packet = packets + packet_count++;
+  packet->deliver_at = node->busy_until + PROPAGATION_DELAY;
+  coap_endpoint_copy(&packet->endpoint, ep);
+  packet->len = len;
+  memcpy(packet->data, data, len);
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+deliver_next_packet(void)
+{
+  struct packet packet;
+  size_t next = 0;
+
+  if(!packet_count) {
+    return false;
+  }
+  for(size_t i = 1; i < packet_count; i++) {
+    if(packets[i].deliver_at < packets[next].deliver_at) {
+      next = i;
+    }
+  }
+  if(packets[next].deliver_at > virtual_time) {
+    return false;
+  }
+
+  /* coap_receive may send further packets */
+  memcpy(&packet, packets + next, sizeof(packet));
+  memmove(packets + next, packets + next + 1,
+          (packet_count - next - 1) * sizeof(struct packet));
+  packet_count--;
+  coap_receive(&packet.endpoint, packet.data, packet.len);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+get_next_event(void)
+{
+  uint64_t next = virtual_time + coap_timer_time_to_next_expiration();
+  for(size_t i = 0; i < packet_count; i++) {
+    next = MIN(next, packets[i].deliver_at);
+  }
+  return next;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_get(coap_message_t *request, coap_message_t *response,
+           uint8_t *buffer, uint16_t preferred_size,
+           int32_t *offset)
+{
+  coap_set_payload(response, "ok", 2);
+}
+/*---------------------------------------------------------------------------*/
+static void send_next_request(struct slot *slot);
+
+static void
+handle_response(coap_callback_request_state_t *state)
+{
+  struct slot *slot = (struct slot *)state;
+
+  switch(state->state.status) {
+  case COAP_REQUEST_STATUS_FINISHED:
+    responses++;
+    send_next_request(slot);
+    break;
+  case COAP_REQUEST_STATUS_TIMEOUT:
+  case COAP_REQUEST_STATUS_BLOCK_ERROR:
+    failures++;
+    send_next_request(slot);
+    break;
+  default:
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_next_request(struct slot *slot)
+{
+  if(slot->node->requests == REQUESTS_PER_NODE) {
+    return;
+  }
+  slot->node->requests++;
+  coap_init_message(slot->request, COAP_TYPE_CON, COAP_GET, 0);
+  coap_set_header_uri_path(slot->request, "test");
+  if(!coap_send_request(&slot->state, &slot->node->endpoint, slot->request,
+                        handle_response)) {
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(polling, "polling of lossy nodes");
+UNIT_TEST(polling)
+{
+  uint64_t started_at;
+  uint64_t duration;
+
+  UNIT_TEST_BEGIN();
+
+  memset(&coap_transaction_stats, 0, sizeof(coap_transaction_stats));
+  started_at = virtual_time;
+  for(size_t i = 0; i < NODES * PIPELINE_DEPTH; i++) {
+    slots[i].node = nodes + (i % NODES);
+    send_next_request(slots + i);
+  }
+
+  while(responses + failures < NODES * REQUESTS_PER_NODE) {
+    if(deliver_next_packet()) {
+      continue;
+    }
+    if(coap_timer_run()) {
+      continue;
+    }
+    virtual_time = get_next_event();
+  }
+  duration = virtual_time - started_at;
+  UNIT_TEST_ASSERT(!packet_count || (duration > 0));
+
+  printf("TEST: %lu responses, %lu failures in %lu ms: "
+         "%lu requests/s\n",
+         (unsigned long)responses,
+         (unsigned long)failures,
+         (unsigned long)duration,
+         (unsigned long)(responses * 1000 / MAX(1, duration)));
+  printf("TEST: %lu transmissions, %lu retransmissions, %lu timeouts, "
+         "%lu deferrals, %lu packets dropped\n",
+         (unsigned long)coap_transaction_stats.transmissions,
+         (unsigned long)coap_transaction_stats.retransmissions,
+         (unsigned long)coap_transaction_stats.timeouts,
+         (unsigned long)coap_transaction_stats.deferrals,
+         (unsigned long)drops);
+  UNIT_TEST_ASSERT(coap_transaction_stats.transmissions
+                   == NODES * REQUESTS_PER_NODE);
+  UNIT_TEST_ASSERT(coap_transaction_stats.timeouts == failures);
+  UNIT_TEST_ASSERT(responses > 0);
+  UNIT_TEST_ASSERT(!has_untracked_messages);
+#if COAP_WITH_CONGESTION_CONTROL
+  UNIT_TEST_ASSERT(max_outstanding == MIN(COAP_NSTART, PIPELINE_DEPTH));
+  UNIT_TEST_ASSERT((coap_transaction_stats.deferrals > 0)
+                   == (COAP_NSTART < PIPELINE_DEPTH));
+  UNIT_TEST_ASSERT(coap_transaction_stats.retransmissions
+                   <= FIXED_TIMEOUT_RETRANSMISSIONS);
+#else /* COAP_WITH_CONGESTION_CONTROL */
+  UNIT_TEST_ASSERT(max_outstanding == PIPELINE_DEPTH);
+  UNIT_TEST_ASSERT(!coap_transaction_stats.deferrals);
+  UNIT_TEST_ASSERT(coap_transaction_stats.retransmissions
+                   == FIXED_TIMEOUT_RETRANSMISSIONS);
+#endif /* COAP_WITH_CONGESTION_CONTROL */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  /* message IDs and timeouts are the same in each run */
+  RANDOM_PRNG.seed(1);
+  coap_engine_init();
+  coap_activate_resource(&res_test, "test");
+  for(size_t i = 0; i < NODES; i++) {
+    uip_ip6addr(&nodes[i].endpoint.ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, i + 1);
+    nodes[i].endpoint.port = UIP_HTONS(COAP_DEFAULT_PORT);
+  }
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(polling);
+
+  if(!UNIT_TEST_PASSED(polling)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
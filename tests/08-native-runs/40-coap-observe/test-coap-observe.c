@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "coap-fixture.h"
+#include "coap-observe.h"
+#include "coap-timer.h"
+#include "coap-transport.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define OBSERVERS (3)
+#define MAX_SENT (16)
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+struct sent_message {
+  coap_endpoint_t endpoint;
+  uint16_t len;
+  uint8_t data[COAP_MAX_PACKET_SIZE];
+  coap_message_t message[1];
+};
+
+static struct sent_message sent[MAX_SENT];
+static size_t sent_count;
+static coap_endpoint_t endpoints[OBSERVERS];
+static uint32_t value;
+static uint32_t renders;
+
+static void handle_get(coap_message_t *request, coap_message_t *response,
+                       uint8_t *buffer, uint16_t preferred_size,
+                       int32_t *offset);
+EVENT_RESOURCE(res_sensor, "sensor", handle_get, NULL, NULL, NULL, NULL);
+
+/*---------------------------------------------------------------------------*/
+int
+coap_sendto(const coap_endpoint_t *ep, const uint8_t *data, uint16_t len)
+{
+  struct sent_message *message;
+
+  if((sent_count == MAX_SENT) || (len > COAP_MAX_PACKET_SIZE)) {
+    return -1;
+  }
+  message = sent + sent_count++;
+  coap_endpoint_copy(&message->endpoint, ep);
+  message->len = len;
+  memcpy(message->data, data, len);
+  coap_parse_message(message->message, message->data, len);
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_get(coap_message_t *request, coap_message_t *response,
+           uint8_t *buffer, uint16_t preferred_size,
+           int32_t *offset)
+{
+  renders++;
+  coap_set_payload(response, buffer,
+                   snprintf((char *)buffer, preferred_size, "%lu",
+                            (unsigned long)value));
+}
+/*---------------------------------------------------------------------------*/
+static void
+observe(size_t i)
+{
+  coap_message_t request[1];
+  uint8_t buffer[COAP_MAX_PACKET_SIZE];
+  uint8_t token = i;
+  size_t len;
+
+  coap_init_message(request, COAP_TYPE_NON, COAP_GET, coap_get_mid());
+  coap_set_header_uri_path(request, "sensor");
+  coap_set_header_observe(request, 0);
+  coap_set_token(request, &token, 1);
+  len = coap_serialize_message(request, buffer);
+  coap_receive(endpoints + i, buffer, len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+acknowledge(void)
+{
+  coap_message_t ack[1];
+  uint8_t buffer[COAP_MAX_HEADER_SIZE];
+
+  for(size_t i = 0; i < sent_count; i++) {
+    if(sent[i].message->type == COAP_TYPE_CON) {
+      coap_init_message(ack, COAP_TYPE_ACK, 0, sent[i].message->mid);
+      coap_receive(&sent[i].endpoint, buffer,
+                   coap_serialize_message(ack, buffer));
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static bool
+has_payload(const struct sent_message *message, uint32_t expected)
+{
+  char payload[12];
+
+  snprintf(payload, sizeof(payload), "%lu", (unsigned long)expected);
+  return (message->message->payload_len == strlen(payload))
+         && !memcmp(message->message->payload, payload, strlen(payload));
+}
+/*---------------------------------------------------------------------------*/
+static bool
+is_for(const struct sent_message *message, size_t i)
+{
+  return coap_endpoint_cmp(&message->endpoint, endpoints + i)
+         && (message->message->token_len == 1)
+         && (message->message->token[0] == i);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(rendering, "rendering once for all observers");
+UNIT_TEST(rendering)
+{
+  UNIT_TEST_BEGIN();
+
+  observe(0);
+  observe(1);
+  sent_count = 0;
+  virtual_time += 10 * COAP_OBSERVE_MIN_INTERVAL + 1000;
+
+  /* both observers get the same representation */
+  value = 1;
+  renders = 0;
+  coap_notify_observers(&res_sensor);
+  UNIT_TEST_ASSERT(renders == 1);
+  UNIT_TEST_ASSERT(sent_count == 2);
+  for(size_t i = 0; i < 2; i++) {
+    UNIT_TEST_ASSERT(is_for(sent + i, i));
+    UNIT_TEST_ASSERT(has_payload(sent + i, 1));
+    UNIT_TEST_ASSERT(sent[i].message->type == COAP_TYPE_NON);
+  }
+
+  /* every second notification is confirmable, but only for that observer */
+  observe(2);
+  sent_count = 0;
+  virtual_time += 10 * COAP_OBSERVE_MIN_INTERVAL + 1000;
+  value = 2;
+  renders = 0;
+  coap_notify_observers(&res_sensor);
+  UNIT_TEST_ASSERT(renders == 1);
+  UNIT_TEST_ASSERT(sent_count == 3);
+  UNIT_TEST_ASSERT(sent[0].message->type == COAP_TYPE_CON);
+  UNIT_TEST_ASSERT(sent[1].message->type == COAP_TYPE_CON);
+  UNIT_TEST_ASSERT(is_for(sent + 2, 2));
+  UNIT_TEST_ASSERT(sent[2].message->type == COAP_TYPE_NON);
+  UNIT_TEST_ASSERT(has_payload(sent + 2, 2));
+  acknowledge();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coalescing, "coalescing of rapid changes");
+UNIT_TEST(coalescing)
+{
+  UNIT_TEST_BEGIN();
+
+  virtual_time += 10 * COAP_OBSERVE_MIN_INTERVAL + 1000;
+  sent_count = 0;
+  renders = 0;
+  for(value = 10; value < 15; value++) {
+    coap_notify_observers(&res_sensor);
+    virtual_time += 1;
+  }
+  value--;
+#if COAP_OBSERVE_MIN_INTERVAL
+  /* the first change is notified right away and the rest is coalesced */
+  UNIT_TEST_ASSERT(renders == 1);
+  UNIT_TEST_ASSERT(sent_count == OBSERVERS);
+  virtual_time += COAP_OBSERVE_MIN_INTERVAL;
+  while(coap_timer_run());
+  UNIT_TEST_ASSERT(renders == 2);
+  UNIT_TEST_ASSERT(sent_count == 2 * OBSERVERS);
+  for(size_t i = OBSERVERS; i < sent_count; i++) {
+    UNIT_TEST_ASSERT(has_payload(sent + i, value));
+  }
+#else /* COAP_OBSERVE_MIN_INTERVAL */
+  UNIT_TEST_ASSERT(renders == 5);
+  UNIT_TEST_ASSERT(sent_count == 5 * OBSERVERS);
+#endif /* COAP_OBSERVE_MIN_INTERVAL */
+  for(size_t i = 0; i < sent_count; i++) {
+    UNIT_TEST_ASSERT(is_for(sent + i, i % OBSERVERS));
+  }
+  acknowledge();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  coap_engine_init();
+  coap_activate_resource(&res_sensor, "sensor");
+  for(size_t i = 0; i < OBSERVERS; i++) {
+    uip_ip6addr(&endpoints[i].ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, i + 1);
+    endpoints[i].port = UIP_HTONS(COAP_DEFAULT_PORT);
+  }
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(rendering);
+  UNIT_TEST_RUN(coalescing);
+
+  if(!UNIT_TEST_PASSED(rendering)
+     || !UNIT_TEST_PASSED(coalescing)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "coap-fixture.h"
+#include "coap-block1.h"
+#include "coap-block2.h"
+#include "coap-transport.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define REPRESENTATION_LEN (64 * 1024)
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static coap_endpoint_t client;
+static uint8_t expected[REPRESENTATION_LEN];
+static uint8_t received[REPRESENTATION_LEN];
+static uint8_t response_data[COAP_MAX_PACKET_SIZE];
+static coap_message_t response[1];
+static bool has_response;
+static uint32_t produced_bytes;
+static uint8_t version;
+static bool is_retransmission;
+static coap_block1_progress_t upload_progress;
+static uint32_t consumed_bytes;
+
+static void handle_rendered_get(coap_message_t *request,
+                                coap_message_t *response,
+                                uint8_t *buffer, uint16_t preferred_size,
+                                int32_t *offset);
+static void handle_streamed_get(coap_message_t *request,
+                                coap_message_t *response,
+                                uint8_t *buffer, uint16_t preferred_size,
+                                int32_t *offset);
+static void handle_put(coap_message_t *request, coap_message_t *response,
+                       uint8_t *buffer, uint16_t preferred_size,
+                       int32_t *offset);
+RESOURCE(res_rendered, "", handle_rendered_get, NULL, NULL, NULL);
+RESOURCE(res_streamed, "", handle_streamed_get, NULL, handle_put, NULL);
+
+/*---------------------------------------------------------------------------*/
+int
+coap_sendto(const coap_endpoint_t *ep, const uint8_t *data, uint16_t len)
+{
+  if(len > sizeof(response_data)) {
+    return -1;
+  }
+  memcpy(response_data, data, len);
+  has_response = coap_parse_message(response, response_data, len) == NO_ERROR;
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * The representation is a pseudorandom byte sequence. Like, e.g., a log
+ * rendered as text, a byte can only be produced after all preceding ones.
+ */
+static uint32_t
+next_byte(uint32_t *state)
+{
+  *state = *state * 1664525 + 1013904223;
+  return *state >> 24;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_rendered_get(coap_message_t *request, coap_message_t *response,
+                    uint8_t *buffer, uint16_t preferred_size,
+                    int32_t *offset)
+{
+  uint32_t state = 0;
+  uint32_t start = *offset;
+  uint16_t len = 0;
+
+  /* render everything up to the end of the requested block */
+  for(uint32_t i = 0;
+      (i < REPRESENTATION_LEN) && (i < start + preferred_size);
+      i++) {
+    uint8_t byte = next_byte(&state);
+    produced_bytes++;
+    if(i >= start) {
+      buffer[len++] = byte;
+    }
+  }
+  coap_set_payload(response, buffer, len);
+  *offset = start + len < REPRESENTATION_LEN ? start + len : -1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+produce(coap_block2_cursor_t *cursor, uint8_t *buffer, uint16_t len)
+{
+  uint32_t state = cursor->state;
+  uint16_t produced = 0;
+
+  while((produced < len)
+        && (cursor->offset + produced < REPRESENTATION_LEN)) {
+    buffer[produced++] = next_byte(&state) ^ version;
+  }
+  cursor->state = state;
+  produced_bytes += produced;
+  return produced;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_streamed_get(coap_message_t *request, coap_message_t *response,
+                    uint8_t *buffer, uint16_t preferred_size,
+                    int32_t *offset)
+{
+  coap_block2_stream(request, response, buffer, preferred_size, offset,
+                     produce);
+}
+/*---------------------------------------------------------------------------*/
+static int
+consume(const uint8_t *data, uint16_t len, uint32_t offset)
+{
+  if(offset + len > REPRESENTATION_LEN) {
+    return -1;
+  }
+  memcpy(received + offset, data, len);
+  consumed_bytes += len;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_put(coap_message_t *request, coap_message_t *response,
+           uint8_t *buffer, uint16_t preferred_size,
+           int32_t *offset)
+{
+  if(!coap_block1_stream(request, response, consume, &upload_progress)) {
+    coap_set_status_code(response, CHANGED_2_04);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static bool
+request(coap_method_t method, const char *path,
+        uint32_t block2_num, uint16_t block_size,
+        const uint8_t *payload, uint32_t block1_num, bool more)
+{
+  coap_message_t request[1];
+  uint8_t buffer[COAP_MAX_PACKET_SIZE];
+  static uint16_t mid;
+
+  if(!is_retransmission) {
+    mid++;
+  }
+  coap_init_message(request, COAP_TYPE_CON, method, mid);
+  coap_set_header_uri_path(request, path);
+  if(payload) {
+    coap_set_header_block1(request, block1_num, more, block_size);
+    coap_set_payload(request, payload, block_size);
+  } else {
+    coap_set_header_block2(request, block2_num, 0, block_size);
+  }
+  has_response = false;
+  coap_receive(&client, buffer, coap_serialize_message(request, buffer));
+  return has_response;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+get_block(const char *path, uint32_t num, uint16_t block_size, bool *more)
+{
+  uint32_t response_num;
+  uint8_t response_more;
+  uint16_t response_size;
+
+  if(!request(COAP_GET, path, num, block_size, NULL, 0, false)
+     || (response->code != CONTENT_2_05)
+     || !coap_get_header_block2(response, &response_num, &response_more,
+                                &response_size, NULL)
+     || (response_num != num)
+     || (response_size != block_size)
+     || (num * block_size + response->payload_len > REPRESENTATION_LEN)) {
+    return false;
+  }
+  memcpy(received + num * block_size, response->payload,
+         response->payload_len);
+  *more = response_more;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+get_all(const char *path, uint16_t block_size)
+{
+  bool more = true;
+
+  memset(received, 0, sizeof(received));
+  for(uint32_t num = 0; more; num++) {
+    if(!get_block(path, num, block_size, &more)) {
+      return false;
+    }
+  }
+  return !memcmp(expected, received, sizeof(received));
+}
+/*---------------------------------------------------------------------------*/
+static bool
+put_all(uint16_t block_size)
+{
+  const uint32_t blocks = REPRESENTATION_LEN / block_size;
+  bool acknowledged;
+
+  memset(received, 0, sizeof(received));
+  consumed_bytes = 0;
+  for(uint32_t num = 0; num < blocks; num++) {
+    if(!request(COAP_PUT, "streamed", 0, block_size,
+                expected + num * block_size, num, num + 1 < blocks)
+       || (response->code
+           != (num + 1 < blocks ? CONTINUE_2_31 : CHANGED_2_04))) {
+      return false;
+    }
+    if(num <= 1) {
+      /* a retransmitted block is acknowledged, but not consumed again */
+      is_retransmission = true;
+      acknowledged = request(COAP_PUT, "streamed", 0, block_size,
+                             expected + num * block_size, num, true)
+                     && (response->code == CONTINUE_2_31);
+      is_retransmission = false;
+      if(!acknowledged) {
+        return false;
+      }
+    }
+  }
+  return (consumed_bytes == REPRESENTATION_LEN)
+         && !memcmp(expected, received, sizeof(received));
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(streaming, "streaming of block 2 transfers");
+UNIT_TEST(streaming)
+{
+  bool more;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(get_all("rendered", 64));
+  UNIT_TEST_ASSERT(get_all("streamed", 64));
+  UNIT_TEST_ASSERT(get_all("streamed", 1024));
+
+  /* retransmitted blocks */
+  UNIT_TEST_ASSERT(get_block("streamed", 0, 256, &more));
+  UNIT_TEST_ASSERT(get_block("streamed", 1, 256, &more));
+  produced_bytes = 0;
+  is_retransmission = true;
+  UNIT_TEST_ASSERT(get_block("streamed", 1, 256, &more));
+  is_retransmission = false;
+  UNIT_TEST_ASSERT(!memcmp(expected + 256, received + 256, 256));
+#if COAP_BLOCK2_WITH_CACHE
+  UNIT_TEST_ASSERT(produced_bytes == 0);
+#else /* COAP_BLOCK2_WITH_CACHE */
+  UNIT_TEST_ASSERT(produced_bytes == 2 * 256 + 1);
+#endif /* COAP_BLOCK2_WITH_CACHE */
+
+  /* a new request gets the current representation */
+  UNIT_TEST_ASSERT(get_block("streamed", 0, 256, &more));
+  UNIT_TEST_ASSERT(!memcmp(expected, received, 256));
+  version = 1;
+  UNIT_TEST_ASSERT(get_block("streamed", 0, 256, &more));
+  for(size_t i = 0; i < 256; i++) {
+    UNIT_TEST_ASSERT(received[i] == (expected[i] ^ version));
+  }
+  version = 0;
+
+  /* random access */
+  UNIT_TEST_ASSERT(get_block("streamed", 10, 256, &more));
+  UNIT_TEST_ASSERT(more);
+  UNIT_TEST_ASSERT(!memcmp(expected + 2560, received + 2560, 256));
+  UNIT_TEST_ASSERT(get_block("streamed", 3, 256, &more));
+  UNIT_TEST_ASSERT(!memcmp(expected + 768, received + 768, 256));
+  UNIT_TEST_ASSERT(get_block("streamed", 255, 256, &more));
+  UNIT_TEST_ASSERT(!more);
+  UNIT_TEST_ASSERT(!memcmp(expected + 65280, received + 65280, 256));
+  UNIT_TEST_ASSERT(!get_block("streamed", 300, 256, &more));
+  UNIT_TEST_ASSERT(response->code == BAD_OPTION_4_02);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(uploading, "streaming of block 1 transfers");
+UNIT_TEST(uploading)
+{
+  const uint16_t block_size = 1024;
+  static uint8_t abandoned[1024];
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(put_all(block_size));
+
+  /* an abandoned upload of different content does not leak into the next */
+  for(size_t i = 0; i < sizeof(abandoned); i++) {
+    abandoned[i] = ~expected[i];
+  }
+  UNIT_TEST_ASSERT(request(COAP_PUT, "streamed", 0, block_size,
+                           abandoned, 0, true));
+  UNIT_TEST_ASSERT(response->code == CONTINUE_2_31);
+  UNIT_TEST_ASSERT(put_all(block_size));
+
+  /* a missing block aborts the transfer */
+  UNIT_TEST_ASSERT(request(COAP_PUT, "streamed", 0, block_size,
+                           expected, 0, true));
+  UNIT_TEST_ASSERT(request(COAP_PUT, "streamed", 0, block_size,
+                           expected + 2 * block_size, 2, true));
+  UNIT_TEST_ASSERT(response->code == REQUEST_ENTITY_INCOMPLETE_4_08);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "latency of 64 KB block 2 transfers");
+UNIT_TEST(benchmark)
+{
+  static const char *const paths[] = { "rendered", "streamed" };
+  static const uint16_t block_sizes[] = { 64, 1024 };
+  clock_time_t start;
+  clock_time_t duration;
+
+  UNIT_TEST_BEGIN();
+
+  for(size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+    for(size_t j = 0; j < sizeof(block_sizes) / sizeof(block_sizes[0]); j++) {
+      produced_bytes = 0;
+      start = clock_time();
+      UNIT_TEST_ASSERT(get_all(paths[i], block_sizes[j]));
+      duration = clock_time() - start;
+      printf("TEST: %s, %u-byte blocks: %lu ms, %lu bytes produced\n",
+             paths[i], block_sizes[j],
+             (unsigned long)(duration * 1000 / CLOCK_SECOND),
+             (unsigned long)produced_bytes);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  coap_engine_init();
+  coap_activate_resource(&res_rendered, "rendered");
+  coap_activate_resource(&res_streamed, "streamed");
+  uip_ip6addr(&client.ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+  client.port = UIP_HTONS(COAP_DEFAULT_PORT);
+  {
+    uint32_t state = 0;
+    for(size_t i = 0; i < REPRESENTATION_LEN; i++) {
+      expected[i] = next_byte(&state);
+    }
+  }
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(streaming);
+  UNIT_TEST_RUN(uploading);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(streaming)
+     || !UNIT_TEST_PASSED(uploading)
+     || !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "contiki.h"
+#include "lwm2m-engine.h"
+#include "coap-engine.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define OBJECT_ID (3303)
+#define RESOURCE_ID (5700)
+#define GENERIC_OBJECT_ID (9)
+#define INSTANCES (200)
+#define GENERIC_INSTANCES (2)
+#define BENCHMARK_ROUNDS (1000)
+/*
+ * The links to the simple instances take 2289 bytes, which end 113 bytes
+ * into the 18th block. The Makefile picks RD cache sizes around that.
+ */
+#define RD_BLOCK_SIZE (128)
+#define RD_PAYLOAD_SIZE (4096)
+#define URL_SIZE (sizeof("3303/65535/5700"))
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static const lwm2m_resource_id_t resources[] = { RO(RESOURCE_ID) };
+static lwm2m_object_instance_t instances[INSTANCES + 1];
+static lwm2m_object_instance_t generic_instances[GENERIC_INSTANCES];
+static lwm2m_object_instance_t *last_instance;
+static coap_endpoint_t endpoint;
+static uint16_t mid;
+static char rd_payload[RD_PAYLOAD_SIZE];
+static char expected_rd_payload[RD_PAYLOAD_SIZE];
+
+/*---------------------------------------------------------------------------*/
+static lwm2m_status_t
+instance_callback(lwm2m_object_instance_t *instance, lwm2m_context_t *ctx)
+{
+  last_instance = instance;
+  return LWM2M_STATUS_OK;
+}
+/*---------------------------------------------------------------------------*/
+static lwm2m_object_instance_t *
+get_by_id(uint16_t instance_id, lwm2m_status_t *status)
+{
+  return instance_id < GENERIC_INSTANCES
+         ? &generic_instances[instance_id]
+         : NULL;
+}
+/*---------------------------------------------------------------------------*/
+static lwm2m_object_instance_t *
+get_first(lwm2m_status_t *status)
+{
+  return get_by_id(0, status);
+}
+/*---------------------------------------------------------------------------*/
+static lwm2m_object_instance_t *
+get_next(lwm2m_object_instance_t *instance, lwm2m_status_t *status)
+{
+  return get_by_id(instance->instance_id + 1, status);
+}
+/*---------------------------------------------------------------------------*/
+static const lwm2m_object_impl_t generic_impl = {
+  .object_id = GENERIC_OBJECT_ID,
+  .get_first = get_first,
+  .get_next = get_next,
+  .get_by_id = get_by_id,
+};
+static lwm2m_object_t generic_object = {
+  .impl = &generic_impl,
+};
+/*---------------------------------------------------------------------------*/
+static void
+init_instance(lwm2m_object_instance_t *instance,
+              uint16_t object_id, uint16_t instance_id)
+{
+  memset(instance, 0, sizeof(*instance));
+  instance->object_id = object_id;
+  instance->instance_id = instance_id;
+  instance->resource_ids = resources;
+  instance->resource_count = sizeof(resources) / sizeof(resources[0]);
+  instance->callback = instance_callback;
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_instances(void)
+{
+  for(uint16_t i = 0; i < INSTANCES; i++) {
+    init_instance(instances + i, OBJECT_ID, i);
+    lwm2m_engine_add_object(instances + i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_instances(void)
+{
+  for(uint16_t i = 0; i < INSTANCES; i++) {
+    lwm2m_engine_remove_object(instances + i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static const char *
+get_rd_payload(void)
+{
+  static uint8_t block_buffer[RD_BLOCK_SIZE];
+  lwm2m_buffer_t outbuf;
+  size_t len;
+  int block;
+  int more;
+
+  len = 0;
+  block = 0;
+  do {
+    outbuf.buffer = block_buffer;
+    outbuf.size = sizeof(block_buffer);
+    outbuf.len = 0;
+    more = lwm2m_engine_set_rd_data(&outbuf, block++);
+    if(len + outbuf.len >= sizeof(rd_payload)) {
+      return NULL;
+    }
+    memcpy(rd_payload + len, block_buffer, outbuf.len);
+    len += outbuf.len;
+  } while(more);
+  rd_payload[len] = '\0';
+  return rd_payload;
+}
+/*---------------------------------------------------------------------------*/
+static void
+expect_rd_link(uint16_t object_id, uint16_t instance_id)
+{
+  size_t len = strlen(expected_rd_payload);
+
+  snprintf(expected_rd_payload + len, sizeof(expected_rd_payload) - len,
+           len ? ",</%u/%u>" : "</%u/%u>", object_id, instance_id);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+request(const char *path)
+{
+  static coap_message_t message[1];
+  static uint8_t buffer[COAP_MAX_HEADER_SIZE];
+  size_t len;
+
+  coap_init_message(message, COAP_TYPE_NON, COAP_GET, mid++);
+  coap_set_header_uri_path(message, path);
+  len = coap_serialize_message(message, buffer);
+  return len && (coap_receive(&endpoint, buffer, len) == NO_ERROR);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(lookup, "lookup of object instances");
+UNIT_TEST(lookup)
+{
+  lwm2m_object_instance_t duplicate;
+  lwm2m_object_instance_t *extra;
+
+  UNIT_TEST_BEGIN();
+
+  add_instances();
+  UNIT_TEST_ASSERT(lwm2m_engine_add_generic_object(&generic_object));
+
+  for(uint16_t i = 0; i < INSTANCES; i++) {
+    UNIT_TEST_ASSERT(lwm2m_engine_has_instance(OBJECT_ID, i));
+  }
+  UNIT_TEST_ASSERT(!lwm2m_engine_has_instance(OBJECT_ID, INSTANCES));
+  UNIT_TEST_ASSERT(!lwm2m_engine_has_instance(OBJECT_ID + 1, 0));
+  UNIT_TEST_ASSERT(lwm2m_engine_has_instance(GENERIC_OBJECT_ID, 1));
+  UNIT_TEST_ASSERT(!lwm2m_engine_has_instance(GENERIC_OBJECT_ID,
+                                              GENERIC_INSTANCES));
+
+  /* duplicates are rejected */
+  init_instance(&duplicate, OBJECT_ID, INSTANCES / 2);
+  UNIT_TEST_ASSERT(!lwm2m_engine_add_object(&duplicate));
+  init_instance(&duplicate, GENERIC_OBJECT_ID, GENERIC_INSTANCES);
+  UNIT_TEST_ASSERT(!lwm2m_engine_add_object(&duplicate));
+
+  /* requests reach the right instance */
+  last_instance = NULL;
+  UNIT_TEST_ASSERT(request("3303/123/5700"));
+  UNIT_TEST_ASSERT(last_instance == &instances[123]);
+
+  /* removed instances are no longer found */
+  lwm2m_engine_remove_object(&instances[INSTANCES / 2]);
+  UNIT_TEST_ASSERT(!lwm2m_engine_has_instance(OBJECT_ID, INSTANCES / 2));
+  UNIT_TEST_ASSERT(lwm2m_engine_has_instance(OBJECT_ID, INSTANCES / 2 + 1));
+
+  /* unassigned instance IDs follow the highest one */
+  extra = &instances[INSTANCES];
+  init_instance(extra, OBJECT_ID, LWM2M_OBJECT_INSTANCE_NONE);
+  UNIT_TEST_ASSERT(lwm2m_engine_add_object(extra));
+  UNIT_TEST_ASSERT(extra->instance_id == INSTANCES);
+  UNIT_TEST_ASSERT(lwm2m_engine_has_instance(OBJECT_ID, INSTANCES));
+
+  lwm2m_engine_remove_object(extra);
+  remove_instances();
+  lwm2m_engine_remove_generic_object(&generic_object);
+  UNIT_TEST_ASSERT(!lwm2m_engine_has_instance(OBJECT_ID, 0));
+  UNIT_TEST_ASSERT(!lwm2m_engine_has_instance(GENERIC_OBJECT_ID, 0));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(rd_payload, "registration payload");
+UNIT_TEST(rd_payload)
+{
+  lwm2m_object_instance_t *extra;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(get_rd_payload() != NULL);
+  UNIT_TEST_ASSERT(!strcmp(rd_payload, ""));
+
+  add_instances();
+  UNIT_TEST_ASSERT(lwm2m_engine_add_generic_object(&generic_object));
+  expected_rd_payload[0] = '\0';
+  for(uint16_t i = 0; i < INSTANCES; i++) {
+    expect_rd_link(OBJECT_ID, i);
+  }
+  for(uint16_t i = 0; i < GENERIC_INSTANCES; i++) {
+    expect_rd_link(GENERIC_OBJECT_ID, i);
+  }
+  UNIT_TEST_ASSERT(get_rd_payload() != NULL);
+  UNIT_TEST_ASSERT(!strcmp(rd_payload, expected_rd_payload));
+  /* a second registration gets the same payload */
+  UNIT_TEST_ASSERT(get_rd_payload() != NULL);
+  UNIT_TEST_ASSERT(!strcmp(rd_payload, expected_rd_payload));
+
+  /* added and removed instances show up in the next registration */
+  lwm2m_engine_remove_object(&instances[0]);
+  extra = &instances[INSTANCES];
+  init_instance(extra, OBJECT_ID, INSTANCES);
+  UNIT_TEST_ASSERT(lwm2m_engine_add_object(extra));
+  expected_rd_payload[0] = '\0';
+  for(uint16_t i = 1; i <= INSTANCES; i++) {
+    expect_rd_link(OBJECT_ID, i);
+  }
+  for(uint16_t i = 0; i < GENERIC_INSTANCES; i++) {
+    expect_rd_link(GENERIC_OBJECT_ID, i);
+  }
+  UNIT_TEST_ASSERT(get_rd_payload() != NULL);
+  UNIT_TEST_ASSERT(!strcmp(rd_payload, expected_rd_payload));
+
+  lwm2m_engine_remove_object(extra);
+  remove_instances();
+  lwm2m_engine_remove_generic_object(&generic_object);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "registration of and requests to instances");
+UNIT_TEST(benchmark)
+{
+  static char urls[INSTANCES][URL_SIZE];
+  clock_time_t start;
+  clock_time_t duration;
+
+  UNIT_TEST_BEGIN();
+
+  start = clock_time();
+  for(uint32_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+    add_instances();
+    remove_instances();
+  }
+  duration = clock_time() - start;
+  printf("TEST: adding %u instances: %lu us\n", INSTANCES,
+         (unsigned long)((uint64_t)duration * 1000000
+                         / CLOCK_SECOND / BENCHMARK_ROUNDS));
+
+  add_instances();
+  UNIT_TEST_ASSERT(lwm2m_engine_add_generic_object(&generic_object));
+
+  start = clock_time();
+  for(uint32_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+    UNIT_TEST_ASSERT(get_rd_payload() != NULL);
+  }
+  duration = clock_time() - start;
+  printf("TEST: registration payload of %u instances: %lu us\n", INSTANCES,
+         (unsigned long)((uint64_t)duration * 1000000
+                         / CLOCK_SECOND / BENCHMARK_ROUNDS));
+
+  for(uint16_t i = 0; i < INSTANCES; i++) {
+    snprintf(urls[i], URL_SIZE, "%u/%u/%u", OBJECT_ID, i, RESOURCE_ID);
+  }
+  start = clock_time();
+  for(uint32_t i = 0; i < BENCHMARK_ROUNDS * 100; i++) {
+    last_instance = NULL;
+    UNIT_TEST_ASSERT(request(urls[i % INSTANCES]));
+    UNIT_TEST_ASSERT(last_instance == &instances[i % INSTANCES]);
+  }
+  duration = clock_time() - start;
+  printf("TEST: %u instances: %lu ns per request\n", INSTANCES,
+         (unsigned long)((uint64_t)duration * 1000000000
+                         / CLOCK_SECOND / BENCHMARK_ROUNDS / 100));
+
+  remove_instances();
+  lwm2m_engine_remove_generic_object(&generic_object);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  lwm2m_engine_init();
+  for(uint16_t i = 0; i < GENERIC_INSTANCES; i++) {
+    init_instance(generic_instances + i, GENERIC_OBJECT_ID, i);
+  }
+  coap_endpoint_parse("coap://[fe80::1]", strlen("coap://[fe80::1]"),
+                      &endpoint);
+  /* let the CoAP engine open its UDP connection */
+  PROCESS_PAUSE();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(lookup);
+  UNIT_TEST_RUN(rd_payload);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(lookup)
+     || !UNIT_TEST_PASSED(rd_payload)
+     || !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
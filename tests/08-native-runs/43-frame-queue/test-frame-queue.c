@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "contiki.h"
+#include "net/linkaddr.h"
+#include "net/mac/frame-queue.h"
+#include "net/mac/framer/frame802154.h"
+#include "net/mac/mac.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "unit-test.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static const linkaddr_t alice = { { 0x02, 0, 0, 0, 0, 0, 0, 0x01 } };
+static const linkaddr_t bob = { { 0x02, 0, 0, 0, 0, 0, 0, 0x02 } };
+static const linkaddr_t carol = { { 0x02, 0, 0, 0, 0, 0, 0, 0x03 } };
+static unsigned callback_count;
+static int last_status;
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+static unsigned prediction_count;
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+
+/*---------------------------------------------------------------------------*/
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+bool
+frame_queue_predict_rendezvous(const linkaddr_t *addr,
+                               rtimer_clock_t *rendezvous)
+{
+  /* bob wakes up before alice, and carol's wake-up times are unknown */
+  if(linkaddr_cmp(addr, &alice)) {
+    *rendezvous = 3000;
+  } else if(linkaddr_cmp(addr, &bob)) {
+    *rendezvous = 2000;
+  } else {
+    return false;
+  }
+  /* like the time that passes between two predictions */
+  *rendezvous -= 100 * prediction_count++;
+  return true;
+}
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+
+/*---------------------------------------------------------------------------*/
+static void
+on_sent(void *ptr, int status, int transmissions)
+{
+  callback_count++;
+  last_status = status;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+add_with_id(const linkaddr_t *receiver, bool is_cmd_frame, uint8_t id)
+{
+  packetbuf_clear();
+  memset(packetbuf_dataptr(), id, 10);
+  packetbuf_set_datalen(10);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, receiver);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE,
+                     is_cmd_frame
+                     ? FRAME802154_CMDFRAME
+                     : FRAME802154_DATAFRAME);
+  return frame_queue_add(on_sent, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static bool
+add(const linkaddr_t *receiver, bool is_cmd_frame)
+{
+  return add_with_id(receiver, is_cmd_frame, 0xAB);
+}
+/*---------------------------------------------------------------------------*/
+static int
+transmit_next(void)
+{
+  frame_queue_entry_t *fqe = frame_queue_pick();
+  if(!fqe) {
+    return -1;
+  }
+  uint8_t id = ((uint8_t *)packetbuf_dataptr())[0];
+  frame_queue_on_transmitted(MAC_TX_OK, fqe);
+  return id;
+}
+/*---------------------------------------------------------------------------*/
+static void
+drain(void)
+{
+  frame_queue_entry_t *fqe;
+  while((fqe = frame_queue_pick())) {
+    frame_queue_on_transmitted(MAC_TX_OK, fqe);
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(neighbor_quota, "neighbor quota");
+UNIT_TEST(neighbor_quota)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(add(&alice, false));
+  UNIT_TEST_ASSERT(add(&alice, false));
+  UNIT_TEST_ASSERT(frame_queue_count_receiver(&alice) == 2);
+  UNIT_TEST_ASSERT(!callback_count);
+
+  /* alice has used up her quota */
+  UNIT_TEST_ASSERT(!add(&alice, false));
+  UNIT_TEST_ASSERT(callback_count == 1);
+  UNIT_TEST_ASSERT(last_status == MAC_TX_QUEUE_FULL);
+  UNIT_TEST_ASSERT(frame_queue_stats.rejected_by_neighbor_quota == 1);
+  UNIT_TEST_ASSERT(frame_queue_count_receiver(&alice) == 2);
+
+  /* others are still admitted */
+  UNIT_TEST_ASSERT(add(&bob, false));
+  UNIT_TEST_ASSERT(callback_count == 1);
+  UNIT_TEST_ASSERT(frame_queue_stats.enqueued == 3);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(class_quota, "class quota");
+UNIT_TEST(class_quota)
+{
+  UNIT_TEST_BEGIN();
+
+  /* data frames have used up their quota */
+  UNIT_TEST_ASSERT(frame_queue_count_class(FRAME_QUEUE_CLASS_DATA) == 3);
+  UNIT_TEST_ASSERT(!add(&carol, false));
+  UNIT_TEST_ASSERT(callback_count == 2);
+  UNIT_TEST_ASSERT(last_status == MAC_TX_QUEUE_FULL);
+  UNIT_TEST_ASSERT(frame_queue_stats.rejected_by_class_quota == 1);
+  UNIT_TEST_ASSERT(!frame_queue_count_receiver(&carol));
+
+  /* broadcast frames are not subject to the per-receiver quota */
+  UNIT_TEST_ASSERT(add(&linkaddr_null, false));
+  UNIT_TEST_ASSERT(add(&linkaddr_null, false));
+  UNIT_TEST_ASSERT(frame_queue_count_receiver(&linkaddr_null) == 2);
+  UNIT_TEST_ASSERT(!add(&linkaddr_null, false));
+  UNIT_TEST_ASSERT(callback_count == 3);
+  UNIT_TEST_ASSERT(last_status == MAC_TX_QUEUE_FULL);
+  UNIT_TEST_ASSERT(frame_queue_stats.rejected_by_class_quota == 2);
+  UNIT_TEST_ASSERT(frame_queue_stats.rejected_by_neighbor_quota == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(full_pool, "full pool");
+UNIT_TEST(full_pool)
+{
+  UNIT_TEST_BEGIN();
+
+  /* the last free entry goes to a command frame */
+  UNIT_TEST_ASSERT(add(&carol, true));
+  UNIT_TEST_ASSERT(frame_queue_count_class(FRAME_QUEUE_CLASS_COMMAND) == 1);
+  UNIT_TEST_ASSERT(frame_queue_stats.enqueued == QUEUEBUF_NUM);
+
+  /* another command frame is within its quotas, but there is no room */
+  UNIT_TEST_ASSERT(!add(&carol, true));
+  UNIT_TEST_ASSERT(callback_count == 4);
+  UNIT_TEST_ASSERT(last_status == MAC_TX_QUEUE_FULL);
+  UNIT_TEST_ASSERT(frame_queue_stats.rejected_by_full_pool == 1);
+  UNIT_TEST_ASSERT(frame_queue_stats.rejected_by_class_quota == 2);
+  UNIT_TEST_ASSERT(frame_queue_stats.rejected_by_neighbor_quota == 1);
+
+  /* dequeuing frees up quotas again */
+  drain();
+  UNIT_TEST_ASSERT(!frame_queue_head());
+  UNIT_TEST_ASSERT(callback_count == 4 + QUEUEBUF_NUM);
+  UNIT_TEST_ASSERT(last_status == MAC_TX_OK);
+  UNIT_TEST_ASSERT(frame_queue_stats.dequeued == QUEUEBUF_NUM);
+  UNIT_TEST_ASSERT(add(&alice, false));
+  UNIT_TEST_ASSERT(add(&alice, false));
+  drain();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(command_frames, "command frames");
+UNIT_TEST(command_frames)
+{
+  UNIT_TEST_BEGIN();
+
+  /* HELLOACKs and ACKs are not held off by a used-up neighbor quota */
+  UNIT_TEST_ASSERT(add(&alice, false));
+  UNIT_TEST_ASSERT(add(&alice, false));
+  UNIT_TEST_ASSERT(add(&alice, true));
+  UNIT_TEST_ASSERT(add(&alice, true));
+  UNIT_TEST_ASSERT(frame_queue_count_receiver(&alice) == 4);
+  UNIT_TEST_ASSERT(frame_queue_stats.rejected_by_neighbor_quota == 1);
+
+  /* but they are subject to their class quota */
+  UNIT_TEST_ASSERT(!add(&bob, true));
+  UNIT_TEST_ASSERT(last_status == MAC_TX_QUEUE_FULL);
+  UNIT_TEST_ASSERT(frame_queue_stats.rejected_by_class_quota == 3);
+
+  /* and do not use up the neighbor quota themselves */
+  drain();
+  UNIT_TEST_ASSERT(add(&alice, true));
+  UNIT_TEST_ASSERT(add(&alice, false));
+  UNIT_TEST_ASSERT(add(&alice, false));
+  UNIT_TEST_ASSERT(!add(&alice, false));
+  UNIT_TEST_ASSERT(frame_queue_stats.rejected_by_neighbor_quota == 2);
+  drain();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ordering, "ordering");
+UNIT_TEST(ordering)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(add_with_id(&alice, false, 1));
+  UNIT_TEST_ASSERT(add_with_id(&alice, false, 2));
+  UNIT_TEST_ASSERT(add_with_id(&bob, false, 3));
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+  /* bob's frame overtakes, but alice's frames remain in FIFO order */
+  prediction_count = 0;
+  UNIT_TEST_ASSERT(transmit_next() == 3);
+  /* one prediction per receiver and pick */
+  UNIT_TEST_ASSERT(prediction_count == 2);
+  prediction_count = 0;
+  UNIT_TEST_ASSERT(transmit_next() == 1);
+  UNIT_TEST_ASSERT(prediction_count == 1);
+  UNIT_TEST_ASSERT(transmit_next() == 2);
+#else /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+  UNIT_TEST_ASSERT(transmit_next() == 1);
+  UNIT_TEST_ASSERT(transmit_next() == 2);
+  UNIT_TEST_ASSERT(transmit_next() == 3);
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+  UNIT_TEST_ASSERT(transmit_next() == -1);
+
+  /* frames without a prediction never overtake older frames */
+  UNIT_TEST_ASSERT(add_with_id(&alice, false, 4));
+  UNIT_TEST_ASSERT(add_with_id(&linkaddr_null, false, 5));
+  UNIT_TEST_ASSERT(add_with_id(&carol, false, 6));
+  UNIT_TEST_ASSERT(add_with_id(&bob, false, 7));
+#if FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+  UNIT_TEST_ASSERT(transmit_next() == 7);
+#endif /* FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+  UNIT_TEST_ASSERT(transmit_next() == 4);
+  UNIT_TEST_ASSERT(transmit_next() == 5);
+  UNIT_TEST_ASSERT(transmit_next() == 6);
+#if !FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST
+  UNIT_TEST_ASSERT(transmit_next() == 7);
+#endif /* !FRAME_QUEUE_WITH_EARLIEST_RENDEZVOUS_FIRST */
+
+  /* older frames without a prediction are sent right away */
+  UNIT_TEST_ASSERT(add_with_id(&linkaddr_null, false, 8));
+  UNIT_TEST_ASSERT(add_with_id(&bob, false, 9));
+  UNIT_TEST_ASSERT(transmit_next() == 8);
+  UNIT_TEST_ASSERT(transmit_next() == 9);
+  UNIT_TEST_ASSERT(transmit_next() == -1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  frame_queue_init();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(neighbor_quota);
+  UNIT_TEST_RUN(class_quota);
+  UNIT_TEST_RUN(full_pool);
+  UNIT_TEST_RUN(command_frames);
+  UNIT_TEST_RUN(ordering);
+
+  if(!UNIT_TEST_PASSED(neighbor_quota)
+     || !UNIT_TEST_PASSED(class_quota)
+     || !UNIT_TEST_PASSED(full_pool)
+     || !UNIT_TEST_PASSED(command_frames)
+     || !UNIT_TEST_PASSED(ordering)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
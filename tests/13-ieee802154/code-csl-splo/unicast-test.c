@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden AB.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "services/akes/akes-nbr.h"
+#include "services/akes/akes-mac.h"
+#include "net/mac/frame-queue.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "sys/energest.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FRAMES (32)
+
+PROCESS(unicast_test_process, "unicast_test_process");
+AUTOSTART_PROCESSES(&unicast_test_process);
+static struct etimer timer;
+static akes_nbr_entry_t *entry;
+static linkaddr_t receivers_address;
+static uint8_t counter;
+static uint8_t acknowledged;
+static rtimer_clock_t sent_at;
+static uint64_t total_latency;
+static uint64_t radio_on_at_start;
+static uint64_t total_at_start;
+
+/*---------------------------------------------------------------------------*/
+static uint64_t
+get_radio_on_time(void)
+{
+  energest_flush();
+  return energest_type_time(ENERGEST_TYPE_LISTEN)
+         + energest_type_time(ENERGEST_TYPE_TRANSMIT);
+}
+/*---------------------------------------------------------------------------*/
+static void
+on_sent(void *ptr, int status, int transmissions)
+{
+  switch(status) {
+  case MAC_TX_OK:
+    acknowledged++;
+    total_latency += RTIMER_NOW() - sent_at;
+    break;
+  case MAC_TX_COLLISION:
+  case MAC_TX_NOACK:
+    /* may happen while exploring channels */
+    break;
+  case MAC_TX_DEFERRED:
+    return;
+  default:
+    printf("=check-me= FAILED - status %i\n", status);
+    break;
+  }
+  process_poll(&unicast_test_process);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(unicast_test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  /* wait for session key establishment */
+  etimer_set(&timer, CLOCK_SECOND);
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&timer));
+    entry = akes_nbr_head(AKES_NBR_PERMANENT);
+    if(entry) {
+      linkaddr_copy(&receivers_address, akes_nbr_get_addr(entry));
+      break;
+    }
+    etimer_reset(&timer);
+  }
+
+  radio_on_at_start = get_radio_on_time();
+  energest_flush();
+  total_at_start = ENERGEST_GET_TOTAL_TIME();
+
+  /* measure the latency of unicast frames to our neighbor */
+  for(; counter < FRAMES; counter++) {
+    packetbuf_clear();
+    packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &receivers_address);
+    packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+    memset(packetbuf_dataptr(), 0xFF, NETSTACK_MAC.max_payload());
+    packetbuf_set_datalen(NETSTACK_MAC.max_payload());
+    sent_at = RTIMER_NOW();
+    NETSTACK_MAC.send(on_sent, NULL);
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+    etimer_set(&timer, CLOCK_SECOND / 8 + clock_random(CLOCK_SECOND / 8));
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&timer));
+  }
+
+  if(acknowledged < FRAMES / 2) {
+    printf("=check-me= FAILED - only %u/%u frames were acknowledged\n",
+           acknowledged, FRAMES);
+  } else {
+    energest_flush();
+    printf("%u/%u frames acknowledged, average latency %lu us, "
+           "radio on %lu permil, average queueing delay %lu ms\n",
+           acknowledged, FRAMES,
+           (unsigned long)(total_latency * 1000000
+                           / acknowledged / RTIMER_SECOND),
+           (unsigned long)((get_radio_on_time() - radio_on_at_start) * 1000
+                           / (ENERGEST_GET_TOTAL_TIME() - total_at_start)),
+           (unsigned long)(frame_queue_get_average_delay() * 1000
+                           / CLOCK_SECOND));
+  }
+  printf("=check-me= DONE\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/